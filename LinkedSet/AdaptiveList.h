@@ -0,0 +1,574 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "ConstAdaptiveListIterator.h"
+#include "MutableAdaptiveListIterator.h"
+#include "SetEngine.h"
+
+// A sorted list that picks its own representation as it grows and shrinks:
+// a sorted array while it is small, a B+-tree once it is bigger, and (for
+// integer items) a bitmap while the items are dense. It has the same
+// interface as LinkedList, so it can back a LinkedSet, which then searches
+// it as it does a BPlusTree.
+// Switching representation doesn't happen all at once: every change moves
+// a few more items from the old engine into the new one, smallest first,
+// so no single change costs more than O(log n). Meanwhile the new engine
+// holds the smaller items and the old one the rest, and both are searched.
+// The one exception is a key far outside the range of a bitmap, which
+// would make the bitmap huge; it is put straight into a new tree, and a
+// switch already under way is finished first.
+template <typename T>
+class AdaptiveList
+{
+public:
+    // Iterator types
+    using iterator = MutableAdaptiveListIterator<T>;
+    using const_iterator = ConstAdaptiveListIterator<T>;
+
+    // An array is promoted to a tree once it holds more items than this,
+    // and a bigger representation demoted once it falls to a quarter of it.
+    static constexpr unsigned int arrayLimit{ 64 };
+
+    // Number of items moved to the new representation per change
+    static constexpr unsigned int migrationStep{ 8 };
+
+    // A tree becomes a bitmap when the bitmap would need at most this many
+    // bits per item, and a bitmap becomes a tree again past sparseBits.
+    static constexpr std::uint64_t denseBits{ 4 * sizeof(T) };
+    static constexpr std::uint64_t sparseBits{ 16 * sizeof(T) };
+
+    // Default constructor
+    AdaptiveList();
+
+    // Copy constructor; the copy is built straight into the final representation.
+    AdaptiveList(const AdaptiveList<T>& original);
+
+    // Copy assignment op
+    AdaptiveList<T>& operator= (const AdaptiveList<T>& original);
+
+    // Move constructor
+    AdaptiveList(AdaptiveList<T>&& original);
+
+    // Move assignment op
+    AdaptiveList<T>& operator= (AdaptiveList<T>&& original);
+
+    // Clear list without destroying container
+    void clear();
+
+    // Add an item before all the others
+    void addFirst(T value);
+
+    // Add an item after all the others
+    void addLast(T value);
+
+    // Remove the first item
+    void removeFirst();
+
+    // Get the first item (a copy, as a bitmap doesn't store it)
+    T getFirst() const;
+
+    // Get the last item (a copy, as a bitmap doesn't store it)
+    T getLast() const;
+
+    // Get number of items in the list
+    unsigned int getSize() const;
+
+    // Get the representation the list is in, or is moving to.
+    SetRepresentation getRepresentation() const;
+
+    // Is the list part-way through switching representation?
+    bool isMigrating() const;
+
+    // Count the changes that may have moved items, i.e. every add and remove,
+    // including through iterators. While the count stays the same, iterators
+    // kept from earlier are still valid.
+    std::uint64_t getInvalidations() const;
+
+    // Find the last item smaller than item in O(log n).
+    // Returns end() if there is none.
+    MutableAdaptiveListIterator<T> findPrevious(const T& item);
+
+    // Start of forward iterator
+    ConstAdaptiveListIterator<T> begin() const;
+
+    // End of forward iterator
+    ConstAdaptiveListIterator<T> end() const;
+
+    // Start of forward mutable iterator
+    MutableAdaptiveListIterator<T> begin();
+
+    // End of forward mutable iterator
+    MutableAdaptiveListIterator<T> end();
+
+    template <typename T2>
+    friend class ConstAdaptiveListIterator;
+
+    template <typename T2>
+    friend class MutableAdaptiveListIterator;
+
+private:
+    // Can the items be kept in a bitmap?
+    static constexpr bool bitmapAllowed{ std::is_integral<T>::value && !std::is_same<T, bool>::value };
+
+    // Add an item that isn't there yet, then take a step towards the best representation.
+    void insert(const T& item);
+
+    // Remove an item that is there, then take a step towards the best representation.
+    void erase(const T& item);
+
+    // Move the next few items to the new representation, or start moving
+    // if the current one no longer suits the contents.
+    void adapt();
+
+    // Move every remaining item to the new representation.
+    void finishMigration();
+
+    // Pick the representation that suits the contents best, leaving some
+    // slack either way so that the list doesn't keep switching back and forth.
+    SetRepresentation choose() const;
+
+    // Would adding item make the items too spread out for a bitmap?
+    bool isOutlier(const T& item) const;
+
+    // Get one part of the list: 0 holds the smaller items, 1 the bigger ones.
+    // Part 1 is nullptr unless the list is switching representation.
+    const SetEngine<T>* part(unsigned int index) const;
+
+    // Get the engine that holds item, or would hold it.
+    SetEngine<T>* route(const T& item) const;
+
+    // Find the first item that isn't smaller than item.
+    ConstAdaptiveListIterator<T> lowerBound(const T& item) const;
+
+    // Number of values from first to last, minus one.
+    static std::uint64_t span(const T& first, const T& last);
+
+    // Create an empty engine.
+    static std::unique_ptr<SetEngine<T>> makeEngine(SetRepresentation representation);
+
+    // Holds every item, or while switching, the ones not moved yet
+    std::unique_ptr<SetEngine<T>> engine;
+
+    // The representation being switched to, or nullptr
+    std::unique_ptr<SetEngine<T>> target;
+
+    // Are the smallest items moved first (so the target holds the smaller
+    // part), or the biggest ones?
+    bool upward{ true };
+
+    // Number of items in the list
+    unsigned int size{ 0 };
+
+    // Number of changes that may have moved items (see getInvalidations)
+    std::uint64_t invalidations{ 0 };
+};
+
+template <typename T>
+AdaptiveList<T>::AdaptiveList()
+    : engine{ makeEngine(SetRepresentation::Array) }
+{
+}
+
+template <typename T>
+AdaptiveList<T>::AdaptiveList(const AdaptiveList<T>& original)
+    : engine{ makeEngine(original.getRepresentation()) }, size{ original.size }
+{
+    // Appending in order is cheap in every representation.
+    for (const T& item : original)
+    {
+        engine->insert(item);
+    }
+}
+
+template <typename T>
+AdaptiveList<T>& AdaptiveList<T>::operator= (const AdaptiveList<T>& original)
+{
+    if (this != &original)
+    {
+        AdaptiveList<T> copy{ original };
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+template <typename T>
+AdaptiveList<T>::AdaptiveList(AdaptiveList<T>&& original)
+    : engine{ std::move(original.engine) }, target{ std::move(original.target) },
+      upward{ original.upward }, size{ original.size }
+{
+    original.engine = makeEngine(SetRepresentation::Array);
+    original.size = 0;
+    original.invalidations++;
+}
+
+template <typename T>
+AdaptiveList<T>& AdaptiveList<T>::operator= (AdaptiveList<T>&& original)
+{
+    if (this != &original)
+    {
+        engine = std::move(original.engine);
+        target = std::move(original.target);
+        upward = original.upward;
+        size = original.size;
+        original.engine = makeEngine(SetRepresentation::Array);
+        original.size = 0;
+        invalidations++;
+        original.invalidations++;
+    }
+
+    return *this;
+}
+
+template <typename T>
+void AdaptiveList<T>::clear()
+{
+    engine = makeEngine(SetRepresentation::Array);
+    target.reset();
+    size = 0;
+    invalidations++;
+}
+
+template <typename T>
+void AdaptiveList<T>::addFirst(T value)
+{
+    insert(value);
+}
+
+template <typename T>
+void AdaptiveList<T>::addLast(T value)
+{
+    insert(value);
+}
+
+template <typename T>
+void AdaptiveList<T>::removeFirst()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    erase(getFirst());
+}
+
+template <typename T>
+T AdaptiveList<T>::getFirst() const
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    // The smaller part may have emptied while switching.
+    const SetEngine<T>* lower{ part(0) };
+    return lower->getSize() > 0 ? lower->getFirst() : part(1)->getFirst();
+}
+
+template <typename T>
+T AdaptiveList<T>::getLast() const
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    const SetEngine<T>* upper{ part(1) };
+    return upper && upper->getSize() > 0 ? upper->getLast() : part(0)->getLast();
+}
+
+template <typename T>
+unsigned int AdaptiveList<T>::getSize() const
+{
+    return size;
+}
+
+template <typename T>
+SetRepresentation AdaptiveList<T>::getRepresentation() const
+{
+    return target ? target->getRepresentation() : engine->getRepresentation();
+}
+
+template <typename T>
+bool AdaptiveList<T>::isMigrating() const
+{
+    return target != nullptr;
+}
+
+template <typename T>
+std::uint64_t AdaptiveList<T>::getInvalidations() const
+{
+    return invalidations;
+}
+
+template <typename T>
+MutableAdaptiveListIterator<T> AdaptiveList<T>::findPrevious(const T& item)
+{
+    // The answer is in the bigger part unless every item there is at least item.
+    typename SetEngine<T>::Position position{};
+    for (unsigned int index{ 2 }; index-- > 0;)
+    {
+        const SetEngine<T>* candidate{ part(index) };
+        if (candidate && candidate->previous(item, position))
+        {
+            return MutableAdaptiveListIterator<T>{ *this, ConstAdaptiveListIterator<T>{ this, index, position } };
+        }
+    }
+
+    return end();
+}
+
+template <typename T>
+ConstAdaptiveListIterator<T> AdaptiveList<T>::begin() const
+{
+    return ConstAdaptiveListIterator<T>{ this, 0 };
+}
+
+template <typename T>
+ConstAdaptiveListIterator<T> AdaptiveList<T>::end() const
+{
+    return ConstAdaptiveListIterator<T>{ this, 2 };
+}
+
+template <typename T>
+MutableAdaptiveListIterator<T> AdaptiveList<T>::begin()
+{
+    return MutableAdaptiveListIterator<T>{ *this, ConstAdaptiveListIterator<T>{ this, 0 } };
+}
+
+template <typename T>
+MutableAdaptiveListIterator<T> AdaptiveList<T>::end()
+{
+    return MutableAdaptiveListIterator<T>{ *this, ConstAdaptiveListIterator<T>{ this, 2 } };
+}
+
+template <typename T>
+void AdaptiveList<T>::insert(const T& item)
+{
+    invalidations++;
+    if constexpr (bitmapAllowed)
+    {
+        if (isOutlier(item))
+        {
+            finishMigration();
+            if (engine->getRepresentation() == SetRepresentation::Bitmap)
+            {
+                // Start the tree with the outlier, and move the bitmap's items in from its side.
+                upward = getFirst() > item;
+                target = makeEngine(SetRepresentation::Tree);
+                target->insert(item);
+                size++;
+                adapt();
+                return;
+            }
+        }
+    }
+
+    route(item)->insert(item);
+    size++;
+    adapt();
+}
+
+template <typename T>
+void AdaptiveList<T>::erase(const T& item)
+{
+    invalidations++;
+    route(item)->erase(item);
+    size--;
+    adapt();
+}
+
+template <typename T>
+void AdaptiveList<T>::adapt()
+{
+    if (target)
+    {
+        for (unsigned int moved{ 0 }; moved < migrationStep && engine->getSize() > 0; moved++)
+        {
+            T item{ upward ? engine->getFirst() : engine->getLast() };
+            if (upward)
+            {
+                engine->removeFirst();
+            }
+            else
+            {
+                engine->removeLast();
+            }
+            target->insert(item);
+        }
+
+        if (engine->getSize() == 0)
+        {
+            engine = std::move(target);
+        }
+        return;
+    }
+
+    SetRepresentation best{ choose() };
+    if (best != engine->getRepresentation())
+    {
+        target = makeEngine(best);
+        upward = true;
+    }
+}
+
+template <typename T>
+void AdaptiveList<T>::finishMigration()
+{
+    while (target)
+    {
+        adapt();
+    }
+}
+
+template <typename T>
+SetRepresentation AdaptiveList<T>::choose() const
+{
+    SetRepresentation current{ engine->getRepresentation() };
+    if (current == SetRepresentation::Array ? size <= arrayLimit : size < arrayLimit / 4)
+    {
+        return SetRepresentation::Array;
+    }
+
+    if constexpr (bitmapAllowed)
+    {
+        std::uint64_t limit{ current == SetRepresentation::Bitmap ? sparseBits : denseBits };
+        if (span(engine->getFirst(), engine->getLast()) < limit * size)
+        {
+            return SetRepresentation::Bitmap;
+        }
+    }
+
+    return SetRepresentation::Tree;
+}
+
+template <typename T>
+bool AdaptiveList<T>::isOutlier(const T& item) const
+{
+    bool bitmap{ engine->getRepresentation() == SetRepresentation::Bitmap
+        || (target && target->getRepresentation() == SetRepresentation::Bitmap) };
+    if (!bitmap || size == 0)
+    {
+        return false;
+    }
+
+    T first{ getFirst() };
+    T last{ getLast() };
+    if (first > item)
+    {
+        return span(item, last) >= sparseBits * (size + 1);
+    }
+    if (item > last)
+    {
+        return span(first, item) >= sparseBits * (size + 1);
+    }
+    return false;
+}
+
+template <typename T>
+const SetEngine<T>* AdaptiveList<T>::part(unsigned int index) const
+{
+    if (!target)
+    {
+        return index == 0 ? engine.get() : nullptr;
+    }
+
+    return (index == 0) == upward ? target.get() : engine.get();
+}
+
+template <typename T>
+SetEngine<T>* AdaptiveList<T>::route(const T& item) const
+{
+    // Whatever hasn't been moved yet is on the far side of the target's items.
+    if (target && target->getSize() > 0)
+    {
+        bool inTarget{ upward ? !(item > target->getLast()) : !(target->getFirst() > item) };
+        if (inTarget)
+        {
+            return target.get();
+        }
+    }
+
+    return engine.get();
+}
+
+template <typename T>
+ConstAdaptiveListIterator<T> AdaptiveList<T>::lowerBound(const T& item) const
+{
+    typename SetEngine<T>::Position position{};
+    for (unsigned int index{ 0 }; index < 2; index++)
+    {
+        const SetEngine<T>* candidate{ part(index) };
+        if (candidate && candidate->lowerBound(item, position))
+        {
+            return ConstAdaptiveListIterator<T>{ this, index, position };
+        }
+    }
+
+    return end();
+}
+
+template <typename T>
+std::uint64_t AdaptiveList<T>::span(const T& first, const T& last)
+{
+    if constexpr (bitmapAllowed)
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+        return static_cast<Unsigned>(static_cast<Unsigned>(last) - static_cast<Unsigned>(first));
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+template <typename T>
+std::unique_ptr<SetEngine<T>> AdaptiveList<T>::makeEngine(SetRepresentation representation)
+{
+    if constexpr (bitmapAllowed)
+    {
+        if (representation == SetRepresentation::Bitmap)
+        {
+            return std::make_unique<BitmapEngine<T>>();
+        }
+    }
+
+    if (representation == SetRepresentation::Tree)
+    {
+        return std::make_unique<TreeEngine<T>>();
+    }
+
+    return std::make_unique<ArrayEngine<T>>();
+}
+
+template <typename T>
+std::ostream& operator << (std::ostream& os, const AdaptiveList<T>& list)
+{
+    if (list.getSize() == 0)
+    {
+        // Special case: empty list
+        os << "[]";
+    }
+    else
+    {
+        // Print opening bracket and first item
+        os << "[" << list.getFirst();
+
+        auto i{ ++list.begin() }; // Start at second item
+        while (i != list.end())
+        {
+            // Print a comma, then the next item
+            os << ", " << *i;
+            i++;
+        }
+
+        // Print closing bracket
+        os << "]";
+    }
+
+    return os;
+}
@@ -0,0 +1,1235 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "BPlusTreeNode.h"
+#include "ConstBPlusTreeIterator.h"
+#include "MutableBPlusTreeIterator.h"
+#include "SimdSearch.h"
+
+// A B+-tree: the items are kept in order in small arrays (the leaves),
+// which are linked together so that walking every item is as cheap as
+// walking a list, while the inner nodes let an item be found in O(log n).
+// Nodes are sized per sizeof(T) to span a few cache lines.
+// It has the same interface as LinkedList, so it can back a LinkedSet,
+// which then searches the tree instead of walking it.
+// Inner nodes count the items under each child, so items can also be
+// found by position (select) and positions by item (rank) in O(log n).
+// Given an Aggregate (see RangeAggregates.h), they also keep it for each
+// child, so it can be combined over any range of items in O(log n).
+// Leaves are freed once they empty rather than merged as they run low,
+// which keeps removes cheap at the cost of some space after heavy shrinking.
+template <typename T, typename Aggregate = void>
+class BPlusTree
+{
+public:
+    // Iterator types
+    using iterator = MutableBPlusTreeIterator<T, Aggregate>;
+    using const_iterator = ConstBPlusTreeIterator<T>;
+
+    // Number of items a leaf can hold
+    static constexpr unsigned int leafCapacity{ BPlusTreeSizes<T>::leafCapacity };
+
+    // Number of children an inner node can have
+    static constexpr unsigned int innerCapacity{ BPlusTreeSizes<T>::innerCapacity + 1 };
+
+    // Default constructor
+    BPlusTree() = default;
+
+    // Destructor
+    ~BPlusTree();
+
+    // Copy constructor
+    BPlusTree(const BPlusTree<T, Aggregate>& original);
+
+    // Copy assignment op
+    BPlusTree<T, Aggregate>& operator= (const BPlusTree<T, Aggregate>& original);
+
+    // Move constructor
+    BPlusTree(BPlusTree<T, Aggregate>&& original);
+
+    // Move assignment op
+    BPlusTree<T, Aggregate>& operator= (BPlusTree<T, Aggregate>&& original);
+
+    // Clear tree without destroying container
+    void clear();
+
+    // Add an item before all the others
+    void addFirst(T value);
+
+    // Add an item after all the others
+    void addLast(T value);
+
+    // Remove the first item
+    void removeFirst();
+
+    // Remove the last item
+    void removeLast();
+
+    // Get the first item
+    const T& getFirst() const;
+
+    // Get the first item
+    T& getFirst();
+
+    // Get the last item
+    const T& getLast() const;
+
+    // Get the last item
+    T& getLast();
+
+    // Get number of items in the tree
+    unsigned int getSize() const;
+
+    // Get number of levels in the tree (0 when empty, 1 when the root is a leaf)
+    unsigned int getHeight() const;
+
+    // Count the changes that have removed items or split leaves, including
+    // through iterators. While the count stays the same, iterators kept from
+    // earlier are still valid, though inserts may shift the item they are at.
+    std::uint64_t getInvalidations() const;
+
+    // Find the last item smaller than item in O(log n).
+    // Returns end() if there is none.
+    MutableBPlusTreeIterator<T, Aggregate> findPrevious(const T& item);
+
+    // Find the last item smaller than item in O(log n).
+    // Returns end() if there is none.
+    ConstBPlusTreeIterator<T> findPrevious(const T& item) const;
+
+    // Find the first item that isn't smaller than item in O(log n).
+    // Returns end() if there is none.
+    ConstBPlusTreeIterator<T> lowerBound(const T& item) const;
+
+    // Call f on every item in [low, high), in order, reading each leaf's
+    // array directly.
+    template <typename Function>
+    void scan(const T& low, const T& high, Function f) const;
+
+    // Count the items in [low, high), in O(log n).
+    unsigned int countInRange(const T& low, const T& high) const;
+
+    // Count the items smaller than item, in O(log n).
+    unsigned int rank(const T& item) const;
+
+    // Get the item that has k items before it, in O(log n).
+    const T& select(unsigned int k) const;
+
+    // Move every item that isn't smaller than key to a new tree, which is
+    // returned, in O(log n): each node on the path to key is cut in two.
+    BPlusTree<T, Aggregate> splitAt(const T& key);
+
+    // Move every item of other to the end of this tree in O(log n), leaving
+    // other empty. Every item of other must be bigger than every item here.
+    void join(BPlusTree<T, Aggregate>&& other);
+
+    // Combine the Aggregate of the items in [low, high), in O(log n).
+    // Only available when the tree keeps an Aggregate.
+    auto aggregate(const T& low, const T& high) const;
+
+    // Start of forward iterator
+    ConstBPlusTreeIterator<T> begin() const;
+
+    // End of forward iterator
+    ConstBPlusTreeIterator<T> end() const;
+
+    // Start of forward mutable iterator
+    MutableBPlusTreeIterator<T, Aggregate> begin();
+
+    // End of forward mutable iterator
+    MutableBPlusTreeIterator<T, Aggregate> end();
+
+    template <typename T2, typename Aggregate2>
+    friend class MutableBPlusTreeIterator;
+
+private:
+    // Inner node type, with room for the aggregates if there are any
+    using Inner = typename BPlusTreeInnerType<T, Aggregate>::type;
+
+    // Does the tree keep an aggregate?
+    static constexpr bool summarized{ !std::is_void<Aggregate>::value };
+
+    // Find the leaf an item belongs in, and how many of its items are smaller.
+    std::pair<BPlusTreeLeaf<T>*, unsigned int> findLeaf(const T& item) const;
+
+    // Add an item straight after the one position points at, keeping position on it.
+    void insertAfter(MutableBPlusTreeIterator<T, Aggregate>& position, T value);
+
+    // Put an item into a leaf at index, splitting the leaf first if it is full.
+    // Returns where the item ended up.
+    std::pair<BPlusTreeLeaf<T>*, unsigned int> insertAt(BPlusTreeLeaf<T>* leaf, unsigned int index, T value);
+
+    // Remove the item at index from a leaf, freeing the leaf if that empties it.
+    void eraseAt(BPlusTreeLeaf<T>* leaf, unsigned int index);
+
+    // Move the upper half of a full leaf into a new leaf after it.
+    // Returns the new leaf.
+    BPlusTreeLeaf<T>* splitLeaf(BPlusTreeLeaf<T>* leaf);
+
+    // Link a new leaf in after the last one.
+    BPlusTreeLeaf<T>* appendLeaf();
+
+    // Add right to the tree as the sibling after left, separated by key,
+    // splitting inner nodes on the way up as needed.
+    void insertIntoParent(BPlusTreeNode<T>* left, T key, BPlusTreeNode<T>* right);
+
+    // Remove an empty node from its parent, freeing parents that empty too.
+    void removeFromParent(BPlusTreeNode<T>* node);
+
+    // Free the empty leaf a split may leave at either end of the tree, and
+    // any root left with a single child.
+    void trimEnds();
+
+    // Add delta to the item count of node kept by each of its ancestors,
+    // and bring their aggregates up to date.
+    static void updateAncestors(BPlusTreeNode<T>* node, int delta);
+
+    // Set the item count and aggregate kept for one of an inner node's children.
+    static void recount(BPlusTreeInner<T>* inner, unsigned int index);
+
+    // Count the items under a node.
+    static unsigned int itemCount(const BPlusTreeNode<T>* node);
+
+    // Combine the aggregate of every item under a node.
+    static auto summarize(const BPlusTreeNode<T>* node);
+
+    // Combine the aggregate of the items under a node that are at least
+    // low (if checkLow) and smaller than high (if checkHigh).
+    static auto fold(const BPlusTreeNode<T>* node, const T& low, const T& high, bool checkLow, bool checkHigh);
+
+    // Get the key every item of a leaf must stay below, or nullptr if there is no limit.
+    const T* upperBound(const BPlusTreeLeaf<T>* leaf) const;
+
+    // Get the position of a node among its parent's children.
+    static unsigned int childIndex(const BPlusTreeNode<T>* node);
+
+    // Free a node and everything under it.
+    static void destroy(BPlusTreeNode<T>* node);
+
+    // The root node, or nullptr if the tree is empty
+    BPlusTreeNode<T>* root{ nullptr };
+
+    // The first leaf
+    BPlusTreeLeaf<T>* first{ nullptr };
+
+    // The last leaf
+    BPlusTreeLeaf<T>* last{ nullptr };
+
+    // Number of items in the tree
+    unsigned int size{ 0 };
+
+    // Number of changes that removed items or split leaves (see getInvalidations)
+    std::uint64_t invalidations{ 0 };
+};
+
+// Is List a BPlusTree, with or without an aggregate?
+template <typename List>
+struct IsBPlusTree : std::false_type
+{
+};
+
+template <typename T, typename Aggregate>
+struct IsBPlusTree<BPlusTree<T, Aggregate>> : std::true_type
+{
+};
+
+template <typename T, typename Aggregate>
+BPlusTree<T, Aggregate>::~BPlusTree()
+{
+    clear();
+}
+
+template <typename T, typename Aggregate>
+BPlusTree<T, Aggregate>::BPlusTree(const BPlusTree<T, Aggregate>& original)
+{
+    // Appending in order fills each leaf before starting the next.
+    for (BPlusTreeLeaf<T>* leaf{ original.first }; leaf; leaf = leaf->next)
+    {
+        for (unsigned int i{ 0 }; i < leaf->count; i++)
+        {
+            addLast(leaf->items[i]);
+        }
+    }
+}
+
+template <typename T, typename Aggregate>
+BPlusTree<T, Aggregate>& BPlusTree<T, Aggregate>::operator= (const BPlusTree<T, Aggregate>& original)
+{
+    if (this != &original)
+    {
+        clear();
+        for (BPlusTreeLeaf<T>* leaf{ original.first }; leaf; leaf = leaf->next)
+        {
+            for (unsigned int i{ 0 }; i < leaf->count; i++)
+            {
+                addLast(leaf->items[i]);
+            }
+        }
+    }
+
+    return *this;
+}
+
+template <typename T, typename Aggregate>
+BPlusTree<T, Aggregate>::BPlusTree(BPlusTree<T, Aggregate>&& original)
+    : root{ original.root }, first{ original.first }, last{ original.last }, size{ original.size }
+{
+    original.root = nullptr;
+    original.first = nullptr;
+    original.last = nullptr;
+    original.size = 0;
+    original.invalidations++;
+}
+
+template <typename T, typename Aggregate>
+BPlusTree<T, Aggregate>& BPlusTree<T, Aggregate>::operator= (BPlusTree<T, Aggregate>&& original)
+{
+    if (this != &original)
+    {
+        clear();
+        root = original.root;
+        first = original.first;
+        last = original.last;
+        size = original.size;
+        original.root = nullptr;
+        original.first = nullptr;
+        original.last = nullptr;
+        original.size = 0;
+        original.invalidations++;
+    }
+
+    return *this;
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::clear()
+{
+    destroy(root);
+    root = nullptr;
+    first = nullptr;
+    last = nullptr;
+    size = 0;
+    invalidations++;
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::addFirst(T value)
+{
+    insertAt(first, 0, std::move(value));
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::addLast(T value)
+{
+    if (last && last->count == leafCapacity)
+    {
+        // Start a new leaf rather than splitting the full one, so that
+        // items added in order pack the leaves completely.
+        // The leaf joins the tree empty, and the item is counted after.
+        BPlusTreeLeaf<T>* leaf{ appendLeaf() };
+        leaf->items[0] = std::move(value);
+        insertIntoParent(leaf->previous, leaf->items[0], leaf);
+        leaf->count = 1;
+        size++;
+        updateAncestors(leaf, 1);
+        return;
+    }
+
+    insertAt(last, last ? last->count : 0, std::move(value));
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::removeFirst()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    eraseAt(first, 0);
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::removeLast()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    eraseAt(last, last->count - 1);
+}
+
+template <typename T, typename Aggregate>
+const T& BPlusTree<T, Aggregate>::getFirst() const
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    return first->items[0];
+}
+
+template <typename T, typename Aggregate>
+T& BPlusTree<T, Aggregate>::getFirst()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    return first->items[0];
+}
+
+template <typename T, typename Aggregate>
+const T& BPlusTree<T, Aggregate>::getLast() const
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    return last->items[last->count - 1];
+}
+
+template <typename T, typename Aggregate>
+T& BPlusTree<T, Aggregate>::getLast()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    return last->items[last->count - 1];
+}
+
+template <typename T, typename Aggregate>
+unsigned int BPlusTree<T, Aggregate>::getSize() const
+{
+    return size;
+}
+
+template <typename T, typename Aggregate>
+unsigned int BPlusTree<T, Aggregate>::getHeight() const
+{
+    unsigned int height{ 0 };
+    for (const BPlusTreeNode<T>* node{ root }; node; height++)
+    {
+        node = node->leaf ? nullptr : static_cast<const BPlusTreeInner<T>*>(node)->children[0];
+    }
+
+    return height;
+}
+
+template <typename T, typename Aggregate>
+std::uint64_t BPlusTree<T, Aggregate>::getInvalidations() const
+{
+    return invalidations;
+}
+
+template <typename T, typename Aggregate>
+MutableBPlusTreeIterator<T, Aggregate> BPlusTree<T, Aggregate>::findPrevious(const T& item)
+{
+    auto [leaf, smaller] { findLeaf(item) };
+    if (!leaf)
+    {
+        return end();
+    }
+
+    if (smaller > 0)
+    {
+        return MutableBPlusTreeIterator<T, Aggregate>{ leaf, smaller - 1, *this };
+    }
+
+    // Everything in the leaf is at least item, so the previous leaf (if any) ends with the answer.
+    if (leaf->previous)
+    {
+        return MutableBPlusTreeIterator<T, Aggregate>{ leaf->previous, leaf->previous->count - 1, *this };
+    }
+
+    return end();
+}
+
+template <typename T, typename Aggregate>
+ConstBPlusTreeIterator<T> BPlusTree<T, Aggregate>::findPrevious(const T& item) const
+{
+    auto [leaf, smaller] { findLeaf(item) };
+    if (!leaf)
+    {
+        return end();
+    }
+
+    if (smaller > 0)
+    {
+        return ConstBPlusTreeIterator<T>{ leaf, smaller - 1 };
+    }
+
+    if (leaf->previous)
+    {
+        return ConstBPlusTreeIterator<T>{ leaf->previous, leaf->previous->count - 1 };
+    }
+
+    return end();
+}
+
+template <typename T, typename Aggregate>
+ConstBPlusTreeIterator<T> BPlusTree<T, Aggregate>::lowerBound(const T& item) const
+{
+    auto [leaf, smaller] { findLeaf(item) };
+    if (!leaf)
+    {
+        return end();
+    }
+
+    // Past the end of the leaf, the answer is the start of the next one.
+    if (smaller == leaf->count)
+    {
+        return ConstBPlusTreeIterator<T>{ leaf->next, 0 };
+    }
+
+    return ConstBPlusTreeIterator<T>{ leaf, smaller };
+}
+
+template <typename T, typename Aggregate>
+template <typename Function>
+void BPlusTree<T, Aggregate>::scan(const T& low, const T& high, Function f) const
+{
+    auto [leaf, index] { findLeaf(low) };
+    for (; leaf; leaf = leaf->next, index = 0)
+    {
+        for (; index < leaf->count; index++)
+        {
+            if (!(high > leaf->items[index]))
+            {
+                return;
+            }
+
+            f(leaf->items[index]);
+        }
+    }
+}
+
+template <typename T, typename Aggregate>
+unsigned int BPlusTree<T, Aggregate>::countInRange(const T& low, const T& high) const
+{
+    return high > low ? rank(high) - rank(low) : 0;
+}
+
+template <typename T, typename Aggregate>
+BPlusTree<T, Aggregate> BPlusTree<T, Aggregate>::splitAt(const T& key)
+{
+    BPlusTree<T, Aggregate> rest{};
+    auto [leaf, index] { findLeaf(key) };
+    if (!leaf)
+    {
+        return rest;
+    }
+
+    unsigned int kept{ rank(key) };
+
+    // The leaf's items from index on start a new leaf, which heads the other chain.
+    BPlusTreeLeaf<T>* right{ new BPlusTreeLeaf<T>{} };
+    std::move(leaf->items + index, leaf->items + leaf->count, right->items);
+    right->count = leaf->count - index;
+    leaf->count = index;
+    right->next = leaf->next;
+    if (leaf->next)
+    {
+        leaf->next->previous = right;
+    }
+    leaf->next = nullptr;
+    rest.first = right;
+    rest.last = leaf == last ? right : last;
+    last = leaf;
+
+    // Likewise each ancestor's children after the cut move to a new node,
+    // headed by the new node from the level below.
+    BPlusTreeNode<T>* left{ leaf };
+    BPlusTreeNode<T>* cut{ right };
+    while (left->parent)
+    {
+        BPlusTreeInner<T>* parent{ left->parent };
+        unsigned int child{ childIndex(left) };
+        BPlusTreeInner<T>* sibling{ new Inner{} };
+        sibling->children[0] = cut;
+        cut->parent = sibling;
+        for (unsigned int i{ child + 1 }; i < parent->count; i++)
+        {
+            sibling->children[i - child] = parent->children[i];
+            sibling->children[i - child]->parent = sibling;
+            sibling->itemCounts[i - child] = parent->itemCounts[i];
+            if constexpr (summarized)
+            {
+                static_cast<Inner*>(sibling)->summaries[i - child] = std::move(static_cast<Inner*>(parent)->summaries[i]);
+            }
+        }
+        std::move(parent->keys + child, parent->keys + parent->count - 1, sibling->keys);
+        sibling->count = parent->count - child;
+        parent->count = child + 1;
+        recount(parent, child);
+        recount(sibling, 0);
+
+        left = parent;
+        cut = sibling;
+    }
+
+    rest.root = cut;
+    rest.size = size - kept;
+    size = kept;
+    invalidations++;
+    trimEnds();
+    rest.trimEnds();
+    return rest;
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::join(BPlusTree<T, Aggregate>&& other)
+{
+    if (&other == this || !other.root)
+    {
+        return;
+    }
+
+    if (!root)
+    {
+        *this = std::move(other);
+        return;
+    }
+
+    // The shorter tree's root becomes a child of the taller tree's node on the
+    // facing edge at the same height, separated from it by other's first item.
+    unsigned int height{ getHeight() };
+    unsigned int otherHeight{ other.getHeight() };
+    BPlusTreeNode<T>* added{ nullptr };
+    unsigned int addedCount{ 0 };
+    if (height >= otherHeight)
+    {
+        BPlusTreeNode<T>* node{ root };
+        for (unsigned int level{ height }; level > otherHeight; level--)
+        {
+            node = static_cast<BPlusTreeInner<T>*>(node)->children[node->count - 1];
+        }
+
+        added = other.root;
+        addedCount = other.size;
+        insertIntoParent(node, other.first->items[0], added);
+    }
+    else
+    {
+        BPlusTreeNode<T>* node{ other.root };
+        for (unsigned int level{ otherHeight }; level > height; level--)
+        {
+            node = static_cast<BPlusTreeInner<T>*>(node)->children[0];
+        }
+
+        // The new child goes in after node, then swaps places with it; node
+        // is a first child, so both stay in the same parent even if it splits.
+        added = root;
+        addedCount = size;
+        other.insertIntoParent(node, other.first->items[0], added);
+        BPlusTreeInner<T>* parent{ node->parent };
+        std::swap(parent->children[0], parent->children[1]);
+        std::swap(parent->itemCounts[0], parent->itemCounts[1]);
+        if constexpr (summarized)
+        {
+            std::swap(static_cast<Inner*>(parent)->summaries[0], static_cast<Inner*>(parent)->summaries[1]);
+        }
+        root = other.root;
+    }
+
+    // The new child's parent already counts it; the nodes above don't yet.
+    updateAncestors(added->parent, static_cast<int>(addedCount));
+
+    last->next = other.first;
+    other.first->previous = last;
+    last = other.last;
+    size += other.size;
+    other.root = nullptr;
+    other.first = nullptr;
+    other.last = nullptr;
+    other.size = 0;
+    invalidations++;
+    other.invalidations++;
+}
+
+template <typename T, typename Aggregate>
+auto BPlusTree<T, Aggregate>::aggregate(const T& low, const T& high) const
+{
+    static_assert(summarized, "aggregate() needs a BPlusTree that keeps an Aggregate");
+    if (!root || !(high > low))
+    {
+        return Aggregate::identity();
+    }
+
+    return fold(root, low, high, true, true);
+}
+
+template <typename T, typename Aggregate>
+unsigned int BPlusTree<T, Aggregate>::rank(const T& item) const
+{
+    if (!root)
+    {
+        return 0;
+    }
+
+    // Same path as findLeaf(), adding up the children passed over on the way.
+    unsigned int smaller{ 0 };
+    const BPlusTreeNode<T>* node{ root };
+    while (!node->leaf)
+    {
+        const BPlusTreeInner<T>* inner{ static_cast<const BPlusTreeInner<T>*>(node) };
+        unsigned int child{ simdCountLess(inner->keys, inner->count - 1, item) };
+        for (unsigned int i{ 0 }; i < child; i++)
+        {
+            smaller += inner->itemCounts[i];
+        }
+        node = inner->children[child];
+    }
+
+    const BPlusTreeLeaf<T>* leaf{ static_cast<const BPlusTreeLeaf<T>*>(node) };
+    return smaller + simdCountLess(leaf->items, leaf->count, item);
+}
+
+template <typename T, typename Aggregate>
+const T& BPlusTree<T, Aggregate>::select(unsigned int k) const
+{
+    if (k >= size)
+    {
+        throw std::out_of_range("Index out of range");
+    }
+
+    // Skip whole children until k falls inside one.
+    const BPlusTreeNode<T>* node{ root };
+    while (!node->leaf)
+    {
+        const BPlusTreeInner<T>* inner{ static_cast<const BPlusTreeInner<T>*>(node) };
+        unsigned int child{ 0 };
+        while (k >= inner->itemCounts[child])
+        {
+            k -= inner->itemCounts[child++];
+        }
+        node = inner->children[child];
+    }
+
+    return static_cast<const BPlusTreeLeaf<T>*>(node)->items[k];
+}
+
+template <typename T, typename Aggregate>
+ConstBPlusTreeIterator<T> BPlusTree<T, Aggregate>::begin() const
+{
+    return ConstBPlusTreeIterator<T>{ first, 0 };
+}
+
+template <typename T, typename Aggregate>
+ConstBPlusTreeIterator<T> BPlusTree<T, Aggregate>::end() const
+{
+    return ConstBPlusTreeIterator<T>{ nullptr, 0 };
+}
+
+template <typename T, typename Aggregate>
+MutableBPlusTreeIterator<T, Aggregate> BPlusTree<T, Aggregate>::begin()
+{
+    return MutableBPlusTreeIterator<T, Aggregate>{ first, 0, *this };
+}
+
+template <typename T, typename Aggregate>
+MutableBPlusTreeIterator<T, Aggregate> BPlusTree<T, Aggregate>::end()
+{
+    return MutableBPlusTreeIterator<T, Aggregate>{ nullptr, 0, *this };
+}
+
+template <typename T, typename Aggregate>
+std::pair<BPlusTreeLeaf<T>*, unsigned int> BPlusTree<T, Aggregate>::findLeaf(const T& item) const
+{
+    if (!root)
+    {
+        return { nullptr, 0 };
+    }
+
+    // Count the keys below the item instead of stopping at the first one
+    // that isn't; that has no data-dependent branch, compares a vector of
+    // keys at a time for arithmetic types, and a node is only a few cache
+    // lines long anyway.
+    BPlusTreeNode<T>* node{ root };
+    while (!node->leaf)
+    {
+        BPlusTreeInner<T>* inner{ static_cast<BPlusTreeInner<T>*>(node) };
+        node = inner->children[simdCountLess(inner->keys, inner->count - 1, item)];
+    }
+
+    BPlusTreeLeaf<T>* leaf{ static_cast<BPlusTreeLeaf<T>*>(node) };
+    return { leaf, simdCountLess(leaf->items, leaf->count, item) };
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::insertAfter(MutableBPlusTreeIterator<T, Aggregate>& position, T value)
+{
+    BPlusTreeLeaf<T>* leaf{ position.leaf };
+    unsigned int index{ position.index + 1 };
+
+    // Between two leaves the item could go at the end of this one or the
+    // start of the next; the separator between them decides which, so that
+    // searches can still find it.
+    if (index == leaf->count && leaf->next)
+    {
+        const T* bound{ upperBound(leaf) };
+        if (bound && !(*bound > value))
+        {
+            insertAt(leaf->next, 0, std::move(value));
+            return;
+        }
+    }
+
+    auto [where, at] { insertAt(leaf, index, std::move(value)) };
+
+    // The leaf may have split; position's item is the one just before the new one.
+    if (at > 0)
+    {
+        position.leaf = where;
+        position.index = at - 1;
+    }
+    else
+    {
+        position.leaf = leaf;
+        position.index = leaf->count - 1;
+    }
+}
+
+template <typename T, typename Aggregate>
+std::pair<BPlusTreeLeaf<T>*, unsigned int> BPlusTree<T, Aggregate>::insertAt(BPlusTreeLeaf<T>* leaf, unsigned int index, T value)
+{
+    if (!leaf)
+    {
+        // Empty tree; the root is a single leaf.
+        leaf = new BPlusTreeLeaf<T>{};
+        root = leaf;
+        first = leaf;
+        last = leaf;
+    }
+    else if (leaf->count == leafCapacity)
+    {
+        BPlusTreeLeaf<T>* right{ splitLeaf(leaf) };
+        if (index > leaf->count)
+        {
+            index -= leaf->count;
+            leaf = right;
+        }
+    }
+
+    std::move_backward(leaf->items + index, leaf->items + leaf->count, leaf->items + leaf->count + 1);
+    leaf->items[index] = std::move(value);
+    leaf->count++;
+    size++;
+    updateAncestors(leaf, 1);
+    return { leaf, index };
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::eraseAt(BPlusTreeLeaf<T>* leaf, unsigned int index)
+{
+    invalidations++;
+    std::move(leaf->items + index + 1, leaf->items + leaf->count, leaf->items + index);
+    leaf->count--;
+    size--;
+    updateAncestors(leaf, -1);
+
+    if (leaf->count > 0)
+    {
+        return;
+    }
+
+    // Unlink the empty leaf from its neighbours and the tree.
+    if (leaf->previous)
+    {
+        leaf->previous->next = leaf->next;
+    }
+    else
+    {
+        first = leaf->next;
+    }
+
+    if (leaf->next)
+    {
+        leaf->next->previous = leaf->previous;
+    }
+    else
+    {
+        last = leaf->previous;
+    }
+
+    removeFromParent(leaf);
+}
+
+template <typename T, typename Aggregate>
+BPlusTreeLeaf<T>* BPlusTree<T, Aggregate>::splitLeaf(BPlusTreeLeaf<T>* leaf)
+{
+    invalidations++;
+    BPlusTreeLeaf<T>* right{ new BPlusTreeLeaf<T>{} };
+    unsigned int half{ leaf->count / 2 };
+    std::move(leaf->items + half, leaf->items + leaf->count, right->items);
+    right->count = leaf->count - half;
+    leaf->count = half;
+
+    right->previous = leaf;
+    right->next = leaf->next;
+    if (leaf->next)
+    {
+        leaf->next->previous = right;
+    }
+    else
+    {
+        last = right;
+    }
+    leaf->next = right;
+
+    insertIntoParent(leaf, right->items[0], right);
+    return right;
+}
+
+template <typename T, typename Aggregate>
+BPlusTreeLeaf<T>* BPlusTree<T, Aggregate>::appendLeaf()
+{
+    BPlusTreeLeaf<T>* leaf{ new BPlusTreeLeaf<T>{} };
+    leaf->previous = last;
+    last->next = leaf;
+    last = leaf;
+    return leaf;
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::insertIntoParent(BPlusTreeNode<T>* left, T key, BPlusTreeNode<T>* right)
+{
+    BPlusTreeInner<T>* parent{ left->parent };
+    if (!parent)
+    {
+        // left was the root; grow the tree by a level.
+        parent = new Inner{};
+        parent->children[0] = left;
+        parent->children[1] = right;
+        recount(parent, 0);
+        recount(parent, 1);
+        parent->keys[0] = std::move(key);
+        parent->count = 2;
+        left->parent = parent;
+        right->parent = parent;
+        root = parent;
+        return;
+    }
+
+    unsigned int index{ childIndex(left) };
+
+    if (parent->count == innerCapacity)
+    {
+        // Split the parent first: the upper half of its children move to a
+        // new node, and the key between the halves moves up a level.
+        BPlusTreeInner<T>* sibling{ new Inner{} };
+        unsigned int half{ parent->count / 2 };
+        for (unsigned int i{ half }; i < parent->count; i++)
+        {
+            sibling->children[i - half] = parent->children[i];
+            sibling->children[i - half]->parent = sibling;
+            sibling->itemCounts[i - half] = parent->itemCounts[i];
+            if constexpr (summarized)
+            {
+                static_cast<Inner*>(sibling)->summaries[i - half] = std::move(static_cast<Inner*>(parent)->summaries[i]);
+            }
+        }
+        std::move(parent->keys + half, parent->keys + parent->count - 1, sibling->keys);
+        sibling->count = parent->count - half;
+        parent->count = half;
+
+        insertIntoParent(parent, std::move(parent->keys[half - 1]), sibling);
+
+        if (index >= half)
+        {
+            parent = sibling;
+            index -= half;
+        }
+    }
+
+    // Make room for right straight after left. Right's items either came
+    // from left, or (from addLast) aren't counted yet, so the total under
+    // the parent stays the same.
+    std::move_backward(parent->children + index + 1, parent->children + parent->count, parent->children + parent->count + 1);
+    std::move_backward(parent->itemCounts + index + 1, parent->itemCounts + parent->count, parent->itemCounts + parent->count + 1);
+    if constexpr (summarized)
+    {
+        auto* summaries{ static_cast<Inner*>(parent)->summaries };
+        std::move_backward(summaries + index + 1, summaries + parent->count, summaries + parent->count + 1);
+    }
+    std::move_backward(parent->keys + index, parent->keys + parent->count - 1, parent->keys + parent->count);
+    parent->children[index + 1] = right;
+    parent->keys[index] = std::move(key);
+    parent->count++;
+    right->parent = parent;
+    recount(parent, index);
+    recount(parent, index + 1);
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::removeFromParent(BPlusTreeNode<T>* node)
+{
+    BPlusTreeInner<T>* parent{ node->parent };
+    if (!parent)
+    {
+        // The root emptied, so the tree is empty.
+        destroy(node);
+        root = nullptr;
+        return;
+    }
+
+    // Drop the child along with a key next to it; the key before it, or for
+    // the first child the one after it (the next child's lower bound is then
+    // inherited from the parent's, which it already satisfies).
+    unsigned int index{ childIndex(node) };
+    unsigned int key{ index > 0 ? index - 1 : 0 };
+    std::move(parent->children + index + 1, parent->children + parent->count, parent->children + index);
+    std::move(parent->itemCounts + index + 1, parent->itemCounts + parent->count, parent->itemCounts + index);
+    if constexpr (summarized)
+    {
+        auto* summaries{ static_cast<Inner*>(parent)->summaries };
+        std::move(summaries + index + 1, summaries + parent->count, summaries + index);
+    }
+    if (parent->count > 1)
+    {
+        std::move(parent->keys + key + 1, parent->keys + parent->count - 1, parent->keys + key);
+    }
+    parent->count--;
+    destroy(node);
+
+    if (parent->count == 0)
+    {
+        removeFromParent(parent);
+    }
+    else if (parent == root && parent->count == 1)
+    {
+        // A root with a single child is just an extra level.
+        root = parent->children[0];
+        root->parent = nullptr;
+        parent->count = 0;
+        destroy(parent);
+    }
+}
+
+template <typename T, typename Aggregate>
+const T* BPlusTree<T, Aggregate>::upperBound(const BPlusTreeLeaf<T>* leaf) const
+{
+    // The limit is the key after the nearest ancestor that isn't a last child.
+    for (const BPlusTreeNode<T>* node{ leaf }; node->parent; node = node->parent)
+    {
+        unsigned int index{ childIndex(node) };
+        if (index + 1 < node->parent->count)
+        {
+            return &node->parent->keys[index];
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::trimEnds()
+{
+    if (last && last->count == 0)
+    {
+        BPlusTreeLeaf<T>* leaf{ last };
+        last = leaf->previous;
+        if (last)
+        {
+            last->next = nullptr;
+        }
+        else
+        {
+            first = nullptr;
+        }
+        removeFromParent(leaf);
+    }
+
+    if (first && first->count == 0)
+    {
+        BPlusTreeLeaf<T>* leaf{ first };
+        first = leaf->next;
+        if (first)
+        {
+            first->previous = nullptr;
+        }
+        else
+        {
+            last = nullptr;
+        }
+        removeFromParent(leaf);
+    }
+
+    // A cut can leave single children all the way down; only at the root is that wasted.
+    while (root && !root->leaf && root->count == 1)
+    {
+        BPlusTreeInner<T>* inner{ static_cast<BPlusTreeInner<T>*>(root) };
+        root = inner->children[0];
+        root->parent = nullptr;
+        inner->count = 0;
+        destroy(inner);
+    }
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::updateAncestors(BPlusTreeNode<T>* node, int delta)
+{
+    for (; node->parent; node = node->parent)
+    {
+        // Counts can be adjusted, but an aggregate like max has to be recomputed.
+        unsigned int index{ childIndex(node) };
+        node->parent->itemCounts[index] += delta;
+        if constexpr (summarized)
+        {
+            static_cast<Inner*>(node->parent)->summaries[index] = summarize(node);
+        }
+    }
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::recount(BPlusTreeInner<T>* inner, unsigned int index)
+{
+    inner->itemCounts[index] = itemCount(inner->children[index]);
+    if constexpr (summarized)
+    {
+        static_cast<Inner*>(inner)->summaries[index] = summarize(inner->children[index]);
+    }
+}
+
+template <typename T, typename Aggregate>
+unsigned int BPlusTree<T, Aggregate>::itemCount(const BPlusTreeNode<T>* node)
+{
+    if (node->leaf)
+    {
+        return node->count;
+    }
+
+    const BPlusTreeInner<T>* inner{ static_cast<const BPlusTreeInner<T>*>(node) };
+    unsigned int count{ 0 };
+    for (unsigned int i{ 0 }; i < inner->count; i++)
+    {
+        count += inner->itemCounts[i];
+    }
+    return count;
+}
+
+template <typename T, typename Aggregate>
+auto BPlusTree<T, Aggregate>::summarize(const BPlusTreeNode<T>* node)
+{
+    typename Aggregate::Value value{ Aggregate::identity() };
+    if (node->leaf)
+    {
+        const BPlusTreeLeaf<T>* leaf{ static_cast<const BPlusTreeLeaf<T>*>(node) };
+        for (unsigned int i{ 0 }; i < leaf->count; i++)
+        {
+            value = Aggregate::combine(value, Aggregate::of(leaf->items[i]));
+        }
+    }
+    else
+    {
+        const Inner* inner{ static_cast<const Inner*>(node) };
+        for (unsigned int i{ 0 }; i < inner->count; i++)
+        {
+            value = Aggregate::combine(value, inner->summaries[i]);
+        }
+    }
+    return value;
+}
+
+template <typename T, typename Aggregate>
+auto BPlusTree<T, Aggregate>::fold(const BPlusTreeNode<T>* node, const T& low, const T& high, bool checkLow, bool checkHigh)
+{
+    typename Aggregate::Value value{ Aggregate::identity() };
+    if (node->leaf)
+    {
+        const BPlusTreeLeaf<T>* leaf{ static_cast<const BPlusTreeLeaf<T>*>(node) };
+        for (unsigned int i{ checkLow ? simdCountLess(leaf->items, leaf->count, low) : 0 }; i < leaf->count; i++)
+        {
+            if (checkHigh && !(high > leaf->items[i]))
+            {
+                break;
+            }
+            value = Aggregate::combine(value, Aggregate::of(leaf->items[i]));
+        }
+        return value;
+    }
+
+    // The children between the ones holding low and high are wholly in
+    // range, so their aggregates are used as they are; only the two at the
+    // ends are looked into.
+    const Inner* inner{ static_cast<const Inner*>(node) };
+    unsigned int first{ checkLow ? simdCountLess(inner->keys, inner->count - 1, low) : 0 };
+    unsigned int last{ checkHigh ? simdCountLess(inner->keys, inner->count - 1, high) : inner->count - 1 };
+    if (first == last)
+    {
+        return fold(inner->children[first], low, high, checkLow, checkHigh);
+    }
+
+    value = fold(inner->children[first], low, high, checkLow, false);
+    for (unsigned int i{ first + 1 }; i < last; i++)
+    {
+        value = Aggregate::combine(value, inner->summaries[i]);
+    }
+    return Aggregate::combine(value, fold(inner->children[last], low, high, false, checkHigh));
+}
+
+template <typename T, typename Aggregate>
+unsigned int BPlusTree<T, Aggregate>::childIndex(const BPlusTreeNode<T>* node)
+{
+    const BPlusTreeInner<T>* parent{ node->parent };
+    return static_cast<unsigned int>(std::find(parent->children, parent->children + parent->count, node) - parent->children);
+}
+
+template <typename T, typename Aggregate>
+void BPlusTree<T, Aggregate>::destroy(BPlusTreeNode<T>* node)
+{
+    if (!node)
+    {
+        return;
+    }
+
+    if (node->leaf)
+    {
+        delete static_cast<BPlusTreeLeaf<T>*>(node);
+        return;
+    }
+
+    Inner* inner{ static_cast<Inner*>(node) };
+    for (unsigned int i{ 0 }; i < inner->count; i++)
+    {
+        destroy(inner->children[i]);
+    }
+    delete inner;
+}
+
+template <typename T, typename Aggregate>
+std::ostream& operator << (std::ostream& os, const BPlusTree<T, Aggregate>& tree)
+{
+    if (tree.getSize() == 0)
+    {
+        // Special case: empty tree
+        os << "[]";
+    }
+    else
+    {
+        // Print opening bracket and first item
+        os << "[" << tree.getFirst();
+
+        auto i{ ++tree.begin() }; // Start at second item
+        while (i != tree.end())
+        {
+            // Print a comma, then the next item
+            os << ", " << *i;
+            i++;
+        }
+
+        // Print closing bracket
+        os << "]";
+    }
+
+    return os;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+template <typename T>
+struct BPlusTreeInner;
+
+// Node sizes for a B+-tree holding items of type T. Each node is sized to
+// span a few cache lines, so the fanout shrinks as the items get bigger.
+template <typename T>
+struct BPlusTreeSizes
+{
+    // Target size of a node, in bytes (four 64-byte cache lines).
+    static constexpr std::size_t nodeBytes{ 256 };
+
+    // Number of items a leaf can hold.
+    static constexpr unsigned int leafCapacity{ static_cast<unsigned int>(
+        std::max<std::size_t>(4, (nodeBytes - 4 * sizeof(void*)) / sizeof(T))) };
+
+    // Number of separator keys an inner node can hold (it has one more child
+    // than keys, and an item count for each child).
+    static constexpr unsigned int innerCapacity{ static_cast<unsigned int>(
+        std::max<std::size_t>(3, (nodeBytes - 3 * sizeof(void*)) / (sizeof(T) + sizeof(void*) + sizeof(unsigned int)))) };
+};
+
+// The part shared by the leaves and inner nodes of a B+-tree.
+template <typename T>
+struct BPlusTreeNode
+{
+public:
+    // The inner node this node is a child of, or nullptr for the root.
+    BPlusTreeInner<T>* parent{ nullptr };
+
+    // Number of items (in a leaf) or children (in an inner node).
+    unsigned int count{ 0 };
+
+    // Is this a leaf?
+    bool leaf{ true };
+};
+
+// A leaf of a B+-tree: a sorted array of items, linked to its neighbours
+// so that the leaves can be walked in order without going through the tree.
+template <typename T>
+struct BPlusTreeLeaf : BPlusTreeNode<T>
+{
+public:
+    // The items, in ascending order.
+    T items[BPlusTreeSizes<T>::leafCapacity];
+
+    // The leaf before this one, or nullptr if it is the first.
+    BPlusTreeLeaf<T>* previous{ nullptr };
+
+    // The leaf after this one, or nullptr if it is the last.
+    BPlusTreeLeaf<T>* next{ nullptr };
+};
+
+// An inner node of a B+-tree. Every item under children[i] is smaller than
+// keys[i], and every item under children[i + 1] is at least keys[i].
+template <typename T>
+struct BPlusTreeInner : BPlusTreeNode<T>
+{
+public:
+    // The separator keys; count - 1 of them are in use.
+    T keys[BPlusTreeSizes<T>::innerCapacity];
+
+    // The children; count of them are in use.
+    BPlusTreeNode<T>* children[BPlusTreeSizes<T>::innerCapacity + 1];
+
+    // Number of items under each child, so an item's position in the
+    // tree can be found on the way down.
+    unsigned int itemCounts[BPlusTreeSizes<T>::innerCapacity + 1];
+
+    // Construct an empty inner node.
+    BPlusTreeInner()
+    {
+        this->leaf = false;
+    }
+};
+
+// An inner node of a B+-tree that also keeps an aggregate (see
+// RangeAggregates.h) of the items under each child.
+template <typename T, typename Value>
+struct BPlusTreeSummaryInner : BPlusTreeInner<T>
+{
+public:
+    // Aggregate of the items under each child
+    Value summaries[BPlusTreeSizes<T>::innerCapacity + 1];
+};
+
+// The inner node type of a B+-tree keeping Aggregate, or void for none.
+template <typename T, typename Aggregate>
+struct BPlusTreeInnerType
+{
+    using type = BPlusTreeSummaryInner<T, typename Aggregate::Value>;
+};
+
+template <typename T>
+struct BPlusTreeInnerType<T, void>
+{
+    using type = BPlusTreeInner<T>;
+};
@@ -0,0 +1,190 @@
+#pragma once
+#include <ostream>
+#include "LinkedList.h"
+#include "LinkedSet.h"
+
+// Which items a BoundedSet keeps once it is full.
+enum class BoundedKeep
+{
+    // Keep the largest items, evicting the smallest.
+    Largest,
+
+    // Keep the smallest items, evicting the largest.
+    Smallest
+};
+
+// An ordered set of at most capacity items, e.g. the best K candidates seen
+// so far. Once it is full, an item only gets in if it beats the worst item
+// kept (the boundary), which is then evicted; anything else is rejected
+// after a single comparison, without searching the list.
+// Keeping the largest evicts the first item, in O(1) with any list. Keeping
+// the smallest evicts the last: O(1) with DoublyLinkedList<T> and O(log n)
+// with BPlusTree<T>, while a singly-linked list has to walk to the item
+// before it (from the one just added, see LinkedSet::removeLast).
+// List selects the list implementation, as for LinkedSet.
+template <typename T, typename List = LinkedList<T>>
+class BoundedSet
+{
+public:
+    // Construct an empty set that holds at most capacity items.
+    explicit BoundedSet(unsigned int capacity, BoundedKeep keep = BoundedKeep::Largest);
+
+    // Add an item if the set isn't full yet, or if it beats the boundary
+    // (which is evicted to make room), and it isn't already there.
+    // Return true if an item was added; false otherwise.
+    bool add(const T& item);
+
+    // Checks if the set contains a particular item.
+    // Returns true if the item is found; false otherwise.
+    bool contains(const T& item) const;
+
+    // Remove an item from the set.
+    // Return true if an item was removed; false otherwise.
+    bool remove(const T& item);
+
+    // Remove all items from the set.
+    void clear();
+
+    // Get the number of items in the set.
+    unsigned int getSize() const;
+
+    // Get the most items the set will hold.
+    unsigned int getCapacity() const;
+
+    // Get which items the set keeps.
+    BoundedKeep getKeep() const;
+
+    // Check if the set is full, so new items have to beat the boundary.
+    bool isFull() const;
+
+    // Get the worst item kept: the smallest if keeping the largest, and vice versa.
+    // Throws std::out_of_range if the set is empty.
+    T getBoundary() const;
+
+    // Create an iterator that starts at the smallest item.
+    typename List::const_iterator begin() const;
+
+    // Create an iterator that has reached the end of the set.
+    typename List::const_iterator end() const;
+
+    template <typename T2, typename List2>
+    friend std::ostream& operator << (std::ostream& out, const BoundedSet<T2, List2>& set);
+
+private:
+    // The items, in order
+    LinkedSet<T, List> items;
+
+    // The most items the set will hold
+    unsigned int capacity;
+
+    // Which items are kept
+    BoundedKeep keep;
+};
+
+template <typename T, typename List>
+BoundedSet<T, List>::BoundedSet(unsigned int capacity, BoundedKeep keep)
+    : capacity{ capacity }, keep{ keep }
+{
+}
+
+template <typename T, typename List>
+bool BoundedSet<T, List>::add(const T& item)
+{
+    if (capacity == 0)
+    {
+        return false;
+    }
+
+    if (!isFull())
+    {
+        return items.add(item);
+    }
+
+    // Reject anything that doesn't beat the boundary before searching for it.
+    if (keep == BoundedKeep::Largest ? !(item > items.getFirst()) : !(items.getLast() > item))
+    {
+        return false;
+    }
+
+    if (!items.add(item))
+    {
+        return false;
+    }
+
+    if (keep == BoundedKeep::Largest)
+    {
+        items.removeFirst();
+    }
+    else
+    {
+        items.removeLast();
+    }
+    return true;
+}
+
+template <typename T, typename List>
+bool BoundedSet<T, List>::contains(const T& item) const
+{
+    return items.contains(item);
+}
+
+template <typename T, typename List>
+bool BoundedSet<T, List>::remove(const T& item)
+{
+    return items.remove(item);
+}
+
+template <typename T, typename List>
+void BoundedSet<T, List>::clear()
+{
+    items.clear();
+}
+
+template <typename T, typename List>
+unsigned int BoundedSet<T, List>::getSize() const
+{
+    return items.getSize();
+}
+
+template <typename T, typename List>
+unsigned int BoundedSet<T, List>::getCapacity() const
+{
+    return capacity;
+}
+
+template <typename T, typename List>
+BoundedKeep BoundedSet<T, List>::getKeep() const
+{
+    return keep;
+}
+
+template <typename T, typename List>
+bool BoundedSet<T, List>::isFull() const
+{
+    return items.getSize() >= capacity;
+}
+
+template <typename T, typename List>
+T BoundedSet<T, List>::getBoundary() const
+{
+    return keep == BoundedKeep::Largest ? items.getFirst() : items.getLast();
+}
+
+template <typename T, typename List>
+typename List::const_iterator BoundedSet<T, List>::begin() const
+{
+    return items.begin();
+}
+
+template <typename T, typename List>
+typename List::const_iterator BoundedSet<T, List>::end() const
+{
+    return items.end();
+}
+
+template <typename T, typename List>
+std::ostream& operator << (std::ostream& out, const BoundedSet<T, List>& set)
+{
+    out << set.items;
+    return out;
+}
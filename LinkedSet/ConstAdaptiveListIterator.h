@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include "SetEngine.h"
+
+template <typename T>
+class AdaptiveList;
+
+template <typename T>
+class MutableAdaptiveListIterator;
+
+// Forward iterator for an AdaptiveList. While the list is moving to another
+// representation its items are split between two engines, so the iterator
+// walks one engine and then the other.
+// A bitmap doesn't store its items, so the iterator keeps a copy of the
+// current one; references to it last until the iterator moves.
+template <typename T>
+class ConstAdaptiveListIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    // Construct an iterator that doesn't point into any list.
+    ConstAdaptiveListIterator() = default;
+
+    // Construct an iterator at the first item of a list, starting from part
+    // (0 for the smaller items, 1 for the bigger ones, 2 for the end).
+    ConstAdaptiveListIterator(const AdaptiveList<T>* list, unsigned int part);
+
+    // Construct an iterator at a position in one part of a list.
+    ConstAdaptiveListIterator(const AdaptiveList<T>* list, unsigned int part, typename SetEngine<T>::Position position);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next item.
+    ConstAdaptiveListIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next item, returning the old position.
+    ConstAdaptiveListIterator<T> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same item.
+    bool operator == (const ConstAdaptiveListIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same item.
+    bool operator != (const ConstAdaptiveListIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access the current item.
+    const T& operator * () const;
+
+    // Dereference to access the current item.
+    const T* operator -> () const;
+
+    template <typename T2>
+    friend class MutableAdaptiveListIterator;
+
+private:
+    // Move on to the first item of the next part that has any, if the current part is done.
+    void skipEmptyParts(bool found);
+
+    // The list being iterated
+    const AdaptiveList<T>* list{ nullptr };
+
+    // The part of the list the current item is in; 2 at the end.
+    unsigned int part{ 2 };
+
+    // Where the current item is in its part
+    typename SetEngine<T>::Position position{};
+
+    // Copy of the current item
+    T current{};
+};
+
+template <typename T>
+ConstAdaptiveListIterator<T>::ConstAdaptiveListIterator(const AdaptiveList<T>* list, unsigned int part)
+    : list{ list }, part{ part }
+{
+    const SetEngine<T>* engine{ part < 2 ? list->part(part) : nullptr };
+    skipEmptyParts(engine && engine->begin(position));
+}
+
+template <typename T>
+ConstAdaptiveListIterator<T>::ConstAdaptiveListIterator(const AdaptiveList<T>* list, unsigned int part, typename SetEngine<T>::Position position)
+    : list{ list }, part{ part }, position{ position }
+{
+    current = list->part(part)->value(position);
+}
+
+template <typename T>
+ConstAdaptiveListIterator<T>& ConstAdaptiveListIterator<T>::operator ++ ()
+{
+    skipEmptyParts(list->part(part)->next(position));
+    return *this;
+}
+
+template <typename T>
+ConstAdaptiveListIterator<T> ConstAdaptiveListIterator<T>::operator ++ (int)
+{
+    ConstAdaptiveListIterator<T> old{ *this };
+    ++*this;
+    return old;
+}
+
+template <typename T>
+bool ConstAdaptiveListIterator<T>::operator == (const ConstAdaptiveListIterator<T>& other) const
+{
+    return part == other.part && (part == 2 || position == other.position);
+}
+
+template <typename T>
+bool ConstAdaptiveListIterator<T>::operator != (const ConstAdaptiveListIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool ConstAdaptiveListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return part == 2;
+}
+
+template <typename T>
+const T& ConstAdaptiveListIterator<T>::operator * () const
+{
+    return current;
+}
+
+template <typename T>
+const T* ConstAdaptiveListIterator<T>::operator -> () const
+{
+    return &current;
+}
+
+template <typename T>
+void ConstAdaptiveListIterator<T>::skipEmptyParts(bool found)
+{
+    while (!found && part < 2)
+    {
+        const SetEngine<T>* engine{ ++part < 2 ? list->part(part) : nullptr };
+        found = engine && engine->begin(position);
+    }
+
+    if (part < 2)
+    {
+        current = list->part(part)->value(position);
+    }
+}
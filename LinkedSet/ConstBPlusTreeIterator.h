@@ -0,0 +1,110 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include "BPlusTreeNode.h"
+
+// Forward iterator for a B+-tree; walks the items of each leaf in turn.
+template <typename T>
+class ConstBPlusTreeIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    // Construct an iterator that doesn't point into any tree.
+    ConstBPlusTreeIterator() = default;
+
+    // Construct from a leaf and the position of an item in it.
+    ConstBPlusTreeIterator(const BPlusTreeLeaf<T>* leaf, unsigned int index);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next item.
+    ConstBPlusTreeIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next item, returning the old position.
+    ConstBPlusTreeIterator<T> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same item.
+    bool operator == (const ConstBPlusTreeIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same item.
+    bool operator != (const ConstBPlusTreeIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the tree.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access the current item.
+    const T& operator * () const;
+
+    // Dereference to access the current item.
+    const T* operator -> () const;
+
+private:
+    // The leaf holding the current item, or nullptr at the end.
+    const BPlusTreeLeaf<T>* leaf{ nullptr };
+
+    // Position of the current item in the leaf.
+    unsigned int index{ 0 };
+};
+
+template <typename T>
+ConstBPlusTreeIterator<T>::ConstBPlusTreeIterator(const BPlusTreeLeaf<T>* leaf, unsigned int index)
+    : leaf{ leaf }, index{ index }
+{
+}
+
+template <typename T>
+ConstBPlusTreeIterator<T>& ConstBPlusTreeIterator<T>::operator ++ ()
+{
+    // Move along the leaf, then on to the next one.
+    if (++index == leaf->count)
+    {
+        leaf = leaf->next;
+        index = 0;
+    }
+
+    return *this;
+}
+
+template <typename T>
+ConstBPlusTreeIterator<T> ConstBPlusTreeIterator<T>::operator ++ (int)
+{
+    ConstBPlusTreeIterator<T> old{ *this };
+    ++*this;
+    return old;
+}
+
+template <typename T>
+bool ConstBPlusTreeIterator<T>::operator == (const ConstBPlusTreeIterator<T>& other) const
+{
+    return leaf == other.leaf && index == other.index;
+}
+
+template <typename T>
+bool ConstBPlusTreeIterator<T>::operator != (const ConstBPlusTreeIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool ConstBPlusTreeIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return leaf == nullptr;
+}
+
+template <typename T>
+const T& ConstBPlusTreeIterator<T>::operator * () const
+{
+    return leaf->items[index];
+}
+
+template <typename T>
+const T* ConstBPlusTreeIterator<T>::operator -> () const
+{
+    return &leaf->items[index];
+}
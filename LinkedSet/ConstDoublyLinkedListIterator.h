@@ -0,0 +1,135 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include "DoublyListNode.h"
+
+template <typename T>
+class DoublyLinkedList;
+
+// Bidirectional iterator for a doubly-linked list
+template <typename T>
+class ConstDoublyLinkedListIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    // Construct an iterator that doesn't point into any list.
+    ConstDoublyLinkedListIterator() = default;
+
+    // Construct from a starting node and the list it belongs to.
+    ConstDoublyLinkedListIterator(const DoublyListNode<T>* start, const DoublyLinkedList<T>& list);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next node.
+    ConstDoublyLinkedListIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next node, returning the old position.
+    ConstDoublyLinkedListIterator<T> operator ++ (int);
+
+    // Pre-decrement operator (--i):
+    // Moves iterator back to the previous node (or the last node from end()).
+    ConstDoublyLinkedListIterator<T>& operator -- ();
+
+    // Post-decrement operator (i--):
+    // Moves iterator back to the previous node, returning the old position.
+    ConstDoublyLinkedListIterator<T> operator -- (int);
+
+    // Equality operator; checks if iterators are at the same node.
+    bool operator == (const ConstDoublyLinkedListIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same node.
+    bool operator != (const ConstDoublyLinkedListIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access value at the current node.
+    const T& operator * () const;
+
+    // Dereference to access value at the current node.
+    const T* operator -> () const;
+
+private:
+    // The node the iterator is currently visiting.
+    const DoublyListNode<T>* current{ nullptr };
+
+    // The list being iterated, needed to step back from end().
+    const DoublyLinkedList<T>* list{ nullptr };
+};
+
+template <typename T>
+ConstDoublyLinkedListIterator<T>::ConstDoublyLinkedListIterator(const DoublyListNode<T>* start, const DoublyLinkedList<T>& list)
+    : current{ start }, list{ &list }
+{
+}
+
+template <typename T>
+ConstDoublyLinkedListIterator<T>& ConstDoublyLinkedListIterator<T>::operator ++ ()
+{
+    // Advance to the next node.
+    current = current->next;
+
+    // Pre-increment operator (++i) can be easily chained.
+    return *this;
+}
+
+template <typename T>
+ConstDoublyLinkedListIterator<T> ConstDoublyLinkedListIterator<T>::operator ++ (int)
+{
+    ConstDoublyLinkedListIterator<T> old{ *this };
+    current = current->next;
+    return old;
+}
+
+template <typename T>
+ConstDoublyLinkedListIterator<T>& ConstDoublyLinkedListIterator<T>::operator -- ()
+{
+    // Step back to the previous node; end() steps back to the last node.
+    current = current ? current->previous : list->last;
+
+    return *this;
+}
+
+template <typename T>
+ConstDoublyLinkedListIterator<T> ConstDoublyLinkedListIterator<T>::operator -- (int)
+{
+    ConstDoublyLinkedListIterator<T> old{ *this };
+    --*this;
+    return old;
+}
+
+template <typename T>
+bool ConstDoublyLinkedListIterator<T>::operator == (const ConstDoublyLinkedListIterator<T>& other) const
+{
+    return this->current == other.current;
+}
+
+template <typename T>
+bool ConstDoublyLinkedListIterator<T>::operator != (const ConstDoublyLinkedListIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool ConstDoublyLinkedListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return current == nullptr;
+}
+
+template <typename T>
+const T& ConstDoublyLinkedListIterator<T>::operator * () const
+{
+    return current->value;
+}
+
+template <typename T>
+const T* ConstDoublyLinkedListIterator<T>::operator -> () const
+{
+    return &(current->value);
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <iterator>
+
+// Forward iterator for a frozen set; visits the items of its implicit
+// search tree in order, i.e. smallest first.
+template <typename T>
+class ConstFrozenSetIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    // Construct an iterator that doesn't point into any set.
+    ConstFrozenSetIterator() = default;
+
+    // Construct from the set's layout (1-based, holding size items) and a
+    // position in it; position 0 is the end.
+    ConstFrozenSetIterator(const T* layout, std::size_t size, std::size_t position);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next item.
+    ConstFrozenSetIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next item, returning the old position.
+    ConstFrozenSetIterator<T> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same item.
+    bool operator == (const ConstFrozenSetIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same item.
+    bool operator != (const ConstFrozenSetIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the set.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access the current item.
+    const T& operator * () const;
+
+    // Dereference to access the current item.
+    const T* operator -> () const;
+
+private:
+    // The set's items in search tree order; the children of position k are at 2k and 2k + 1.
+    const T* layout{ nullptr };
+
+    // Number of items in the set.
+    std::size_t size{ 0 };
+
+    // Position of the current item, or 0 at the end.
+    std::size_t position{ 0 };
+};
+
+template <typename T>
+ConstFrozenSetIterator<T>::ConstFrozenSetIterator(const T* layout, std::size_t size, std::size_t position)
+    : layout{ layout }, size{ size }, position{ position }
+{
+}
+
+template <typename T>
+ConstFrozenSetIterator<T>& ConstFrozenSetIterator<T>::operator ++ ()
+{
+    if (2 * position + 1 <= size)
+    {
+        // The next item is the smallest one in the right subtree.
+        position = 2 * position + 1;
+        while (2 * position <= size)
+        {
+            position *= 2;
+        }
+    }
+    else
+    {
+        // Climb while coming from a right child, then once more; reaching 0 means the end.
+        position >>= std::countr_one(position) + 1;
+    }
+
+    return *this;
+}
+
+template <typename T>
+ConstFrozenSetIterator<T> ConstFrozenSetIterator<T>::operator ++ (int)
+{
+    ConstFrozenSetIterator<T> old{ *this };
+    ++*this;
+    return old;
+}
+
+template <typename T>
+bool ConstFrozenSetIterator<T>::operator == (const ConstFrozenSetIterator<T>& other) const
+{
+    return this->position == other.position;
+}
+
+template <typename T>
+bool ConstFrozenSetIterator<T>::operator != (const ConstFrozenSetIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool ConstFrozenSetIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return position == 0;
+}
+
+template <typename T>
+const T& ConstFrozenSetIterator<T>::operator * () const
+{
+    return layout[position];
+}
+
+template <typename T>
+const T* ConstFrozenSetIterator<T>::operator -> () const
+{
+    return &layout[position];
+}
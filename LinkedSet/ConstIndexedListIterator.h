@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "IndexedListNode.h"
+
+template <typename T>
+class IndexedLinkedList;
+
+// Forward iterator for an index-linked list
+template <typename T>
+class ConstIndexedListIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    // Construct an iterator that doesn't point into any list.
+    ConstIndexedListIterator() = default;
+
+    // Construct from a starting node index and the list it belongs to.
+    ConstIndexedListIterator(std::uint32_t start, const IndexedLinkedList<T>& list);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next node.
+    ConstIndexedListIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next node, returning the old position.
+    ConstIndexedListIterator<T> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same node.
+    bool operator == (const ConstIndexedListIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same node.
+    bool operator != (const ConstIndexedListIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access value at the current node.
+    const T& operator * () const;
+
+    // Dereference to access value at the current node.
+    const T* operator -> () const;
+
+private:
+    // The index of the node the iterator is currently visiting.
+    std::uint32_t current{ IndexedListNode<T>::none };
+
+    // The list that is being iterated.
+    const IndexedLinkedList<T>* list{ nullptr };
+};
+
+template <typename T>
+ConstIndexedListIterator<T>::ConstIndexedListIterator(std::uint32_t start, const IndexedLinkedList<T>& list)
+    : current{ start }, list{ &list }
+{
+}
+
+template <typename T>
+ConstIndexedListIterator<T>& ConstIndexedListIterator<T>::operator ++ ()
+{
+    // Advance to the next node.
+    current = list->nodes[current].next;
+
+    // Pre-increment operator (++i) can be easily chained.
+    return *this;
+}
+
+template <typename T>
+ConstIndexedListIterator<T> ConstIndexedListIterator<T>::operator ++ (int)
+{
+    ConstIndexedListIterator<T> old{ *this };
+    current = list->nodes[current].next;
+    return old;
+}
+
+template <typename T>
+bool ConstIndexedListIterator<T>::operator == (const ConstIndexedListIterator<T>& other) const
+{
+    return this->current == other.current;
+}
+
+template <typename T>
+bool ConstIndexedListIterator<T>::operator != (const ConstIndexedListIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool ConstIndexedListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return current == IndexedListNode<T>::none;
+}
+
+template <typename T>
+const T& ConstIndexedListIterator<T>::operator * () const
+{
+    return list->nodes[current].value;
+}
+
+template <typename T>
+const T* ConstIndexedListIterator<T>::operator -> () const
+{
+    return &(list->nodes[current].value);
+}
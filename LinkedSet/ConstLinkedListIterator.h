@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <iterator>
 #include "ListNode.h"
 
 // Forward iterator for a linked list
@@ -6,6 +8,16 @@ template <typename T>
 class ConstLinkedListIterator
 {
 public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    // Construct an iterator that doesn't point into any list.
+    ConstLinkedListIterator() = default;
+
     // Construct from a starting node
     ConstLinkedListIterator(const ListNode<T>* start);
 
@@ -14,8 +26,8 @@ public:
     ConstLinkedListIterator<T>& operator ++ ();
 
     // Post-increment operator (i++):
-    // Advances iterator to the next node.
-    void operator ++ (int);
+    // Advances iterator to the next node, returning the old position.
+    ConstLinkedListIterator<T> operator ++ (int);
 
     // Equality operator; checks if iterators are at the same node.
     bool operator == (const ConstLinkedListIterator<T>& other) const;
@@ -23,6 +35,9 @@ public:
     // Inequality operator; checks if iterators are not at the same node.
     bool operator != (const ConstLinkedListIterator<T>& other) const;
 
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
     // Dereference to access value at the current node.
     const T& operator * () const;
 
@@ -31,7 +46,7 @@ public:
 
 private:
     // The node the iterator is currently visiting.
-    const ListNode<T>* current;
+    const ListNode<T>* current{ nullptr };
 };
 
 template <typename T>
@@ -51,12 +66,11 @@ ConstLinkedListIterator<T>& ConstLinkedListIterator<T>::operator ++ ()
 }
 
 template <typename T>
-void ConstLinkedListIterator<T>::operator ++ (int)
+ConstLinkedListIterator<T> ConstLinkedListIterator<T>::operator ++ (int)
 {
-    // Advance to the next node.
+    ConstLinkedListIterator<T> old{ *this };
     current = current->next;
-
-    // Chain assignment disabled for pre-increment.
+    return old;
 }
 
 template <typename T>
@@ -71,6 +85,12 @@ bool ConstLinkedListIterator<T>::operator != (const ConstLinkedListIterator<T>&
     return !(*this == other);
 }
 
+template <typename T>
+bool ConstLinkedListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return current == nullptr;
+}
+
 template <typename T>
 const T& ConstLinkedListIterator<T>::operator * () const
 {
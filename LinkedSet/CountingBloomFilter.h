@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "HashMix.h"
+#include "ListNode.h"
+#include "ListObserver.h"
+
+// A probabilistic membership filter with small counters instead of bits, so
+// that items can be removed again. mightContain() never returns false for an
+// item that has been added (and not removed), but may return true for one
+// that hasn't; how often depends on the memory given to the filter.
+// Attached to a list as an observer, it tracks the list's contents by itself.
+template <typename T, typename Hash = std::hash<T>>
+class CountingBloomFilter : public ListObserver<T>
+{
+public:
+    // Size the filter so that, holding expectedItems items, about
+    // falsePositiveRate of the lookups for missing items come back positive.
+    CountingBloomFilter(unsigned int expectedItems, double falsePositiveRate);
+
+    // Size the filter to fit in bytes of memory (rounded down to a power of
+    // two, but at least 64), with the number of hash functions chosen for
+    // expectedItems items.
+    static CountingBloomFilter<T, Hash> withMemory(std::size_t bytes, unsigned int expectedItems);
+
+    // Record an item.
+    void add(const T& item);
+
+    // Forget an item that was recorded earlier.
+    void remove(const T& item);
+
+    // Forget every item.
+    void clear();
+
+    // Check if an item might have been recorded.
+    // Returns false only if it definitely wasn't.
+    bool mightContain(const T& item) const;
+
+    // Get the number of items currently recorded.
+    unsigned int getItemCount() const;
+
+    // Get the number of hash functions used per item.
+    unsigned int getHashCount() const;
+
+    // Get the memory used by the counters, in bytes.
+    std::size_t getMemoryUsage() const;
+
+    // Estimate the false-positive rate at the current number of items.
+    double getFalsePositiveRate() const;
+
+    // ListObserver callbacks
+    void inserted(const ListNode<T>* previous, const ListNode<T>* node) override;
+    void removing(const ListNode<T>* previous, const ListNode<T>* node) override;
+    void relocated(const ListNode<T>* node) override;
+    void clearing() override;
+
+private:
+    // Marks the constructor that takes the sizes directly.
+    struct Sizes
+    {
+    };
+
+    // Construct a filter with (at least) counterCount counters and hashCount hash functions.
+    CountingBloomFilter(Sizes, std::size_t counterCount, unsigned int hashCount);
+
+    // Get the first hash of an item; the others are derived from it.
+    std::uint64_t hash(const T& item) const;
+
+    // Get the position of the i-th counter for a hash.
+    std::size_t position(std::uint64_t hash, unsigned int i) const;
+
+    // Counters stop at this value, since an overflowed counter can't be trusted to go back down.
+    static constexpr std::uint8_t saturated{ 0xFF };
+
+    // One counter per slot; the number of slots is a power of two.
+    std::vector<std::uint8_t> counters;
+
+    // Number of hash functions (counters touched) per item.
+    unsigned int hashCount;
+
+    // Number of items currently recorded.
+    unsigned int itemCount{ 0 };
+};
+
+template <typename T, typename Hash>
+CountingBloomFilter<T, Hash>::CountingBloomFilter(unsigned int expectedItems, double falsePositiveRate)
+    : CountingBloomFilter{ Sizes{},
+        static_cast<std::size_t>(std::ceil(-static_cast<double>(expectedItems > 0 ? expectedItems : 1) * std::log(falsePositiveRate) / (std::log(2.0) * std::log(2.0)))),
+        static_cast<unsigned int>(std::round(-std::log2(falsePositiveRate))) }
+{
+}
+
+template <typename T, typename Hash>
+CountingBloomFilter<T, Hash> CountingBloomFilter<T, Hash>::withMemory(std::size_t bytes, unsigned int expectedItems)
+{
+    // Round down, since the counters can't go over budget; one byte each.
+    std::size_t slots{ std::max<std::size_t>(std::bit_floor(bytes), 64) };
+
+    // The best number of hash functions is (counters / items) ln 2.
+    double perItem{ static_cast<double>(slots) / (expectedItems > 0 ? expectedItems : 1) };
+    return CountingBloomFilter<T, Hash>{ Sizes{}, slots, static_cast<unsigned int>(std::round(perItem * std::log(2.0))) };
+}
+
+template <typename T, typename Hash>
+CountingBloomFilter<T, Hash>::CountingBloomFilter(Sizes, std::size_t counterCount, unsigned int hashCount)
+    : hashCount{ hashCount > 0 ? hashCount : 1 }
+{
+    // A power of two lets positions be found with a mask rather than a division.
+    std::size_t slots{ 64 };
+    while (slots < counterCount)
+    {
+        slots *= 2;
+    }
+
+    counters.resize(slots);
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::add(const T& item)
+{
+    std::uint64_t h{ hash(item) };
+    for (unsigned int i{ 0 }; i < hashCount; i++)
+    {
+        std::uint8_t& counter{ counters[position(h, i)] };
+        if (counter != saturated)
+        {
+            counter++;
+        }
+    }
+
+    itemCount++;
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::remove(const T& item)
+{
+    std::uint64_t h{ hash(item) };
+    for (unsigned int i{ 0 }; i < hashCount; i++)
+    {
+        std::uint8_t& counter{ counters[position(h, i)] };
+        if (counter != saturated && counter != 0)
+        {
+            counter--;
+        }
+    }
+
+    itemCount--;
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::clear()
+{
+    std::fill(counters.begin(), counters.end(), std::uint8_t{ 0 });
+    itemCount = 0;
+}
+
+template <typename T, typename Hash>
+bool CountingBloomFilter<T, Hash>::mightContain(const T& item) const
+{
+    std::uint64_t h{ hash(item) };
+    for (unsigned int i{ 0 }; i < hashCount; i++)
+    {
+        if (counters[position(h, i)] == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T, typename Hash>
+unsigned int CountingBloomFilter<T, Hash>::getItemCount() const
+{
+    return itemCount;
+}
+
+template <typename T, typename Hash>
+unsigned int CountingBloomFilter<T, Hash>::getHashCount() const
+{
+    return hashCount;
+}
+
+template <typename T, typename Hash>
+std::size_t CountingBloomFilter<T, Hash>::getMemoryUsage() const
+{
+    return counters.size() * sizeof(std::uint8_t);
+}
+
+template <typename T, typename Hash>
+double CountingBloomFilter<T, Hash>::getFalsePositiveRate() const
+{
+    // (1 - e^(-kn/m))^k
+    double k{ static_cast<double>(hashCount) };
+    return std::pow(1.0 - std::exp(-k * itemCount / counters.size()), k);
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::inserted(const ListNode<T>*, const ListNode<T>* node)
+{
+    add(node->value);
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::removing(const ListNode<T>*, const ListNode<T>* node)
+{
+    remove(node->value);
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::relocated(const ListNode<T>*)
+{
+    // Only addresses changed, not contents.
+}
+
+template <typename T, typename Hash>
+void CountingBloomFilter<T, Hash>::clearing()
+{
+    clear();
+}
+
+template <typename T, typename Hash>
+std::uint64_t CountingBloomFilter<T, Hash>::hash(const T& item) const
+{
+    return mixHash(static_cast<std::uint64_t>(Hash{}(item)));
+}
+
+template <typename T, typename Hash>
+std::size_t CountingBloomFilter<T, Hash>::position(std::uint64_t hash, unsigned int i) const
+{
+    // Double hashing: the i-th position is h1 + i * h2, with h2 odd so every slot can be reached.
+    std::uint64_t h1{ hash & 0xFFFFFFFFull };
+    std::uint64_t h2{ (hash >> 32) | 1 };
+    return static_cast<std::size_t>((h1 + i * h2) & (counters.size() - 1));
+}
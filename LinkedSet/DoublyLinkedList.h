@@ -0,0 +1,533 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include "DoublyListNode.h"
+#include "ConstDoublyLinkedListIterator.h"
+#include "MutableDoublyLinkedListIterator.h"
+
+// A container class for a doubly-linked list.
+// Each node also links back to its predecessor, so any node can be erased
+// in O(1) through an iterator and the list can be walked in both directions.
+// It has the same interface as LinkedList, so it can back a LinkedSet.
+template <typename T>
+class DoublyLinkedList
+{
+public:
+    // Iterator types
+    using iterator = MutableDoublyLinkedListIterator<T>;
+    using const_iterator = ConstDoublyLinkedListIterator<T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Default constructor
+    DoublyLinkedList() = default;
+
+    // Destructor
+    ~DoublyLinkedList();
+
+    // Copy constructor
+    DoublyLinkedList(const DoublyLinkedList<T>& original);
+
+    // Copy assignment op
+    DoublyLinkedList<T>& operator= (const DoublyLinkedList<T>& original);
+
+    // Move constructor
+    DoublyLinkedList(DoublyLinkedList<T>&& original);
+
+    // Move assignment op
+    DoublyLinkedList<T>& operator= (DoublyLinkedList<T>&& original);
+
+    // Clear list without destroying container
+    void clear();
+
+    // Add node to the beginning of the list
+    void addFirst(T value);
+
+    // Add node to the end of the list
+    void addLast(T value);
+
+    // Remove node from the beginning of the list
+    void removeFirst();
+
+    // Remove node from the end of the list
+    void removeLast();
+
+    // Remove the node an iterator points at.
+    // Returns an iterator to the node that followed it.
+    MutableDoublyLinkedListIterator<T> erase(MutableDoublyLinkedListIterator<T> position);
+
+    // Move every node after position (every node, if position is end()) to a
+    // new list, which is returned. The nodes are relinked, not copied; the
+    // only work is counting them.
+    DoublyLinkedList<T> splitAfter(MutableDoublyLinkedListIterator<T> position);
+
+    // Move every node of other to the end of this list in O(1), leaving other empty.
+    void append(DoublyLinkedList<T>&& other);
+
+    // Get element at the beginning of the list
+    const T& getFirst() const;
+
+    // Get element at the beginning of the list
+    T& getFirst();
+
+    // Get element at the end of the list
+    const T& getLast() const;
+
+    // Get element at the end of the list
+    T& getLast();
+
+    // Get number of nodes in the list
+    unsigned int getSize() const;
+
+    // Count the changes that have freed or moved nodes, including through
+    // iterators. While the count stays the same, iterators kept from earlier
+    // are still valid.
+    std::uint64_t getInvalidations() const;
+
+    // Start of forward iterator
+    ConstDoublyLinkedListIterator<T> begin() const;
+
+    // End of forward iterator
+    ConstDoublyLinkedListIterator<T> end() const;
+
+    // Start of forward mutable iterator
+    MutableDoublyLinkedListIterator<T> begin();
+
+    // End of forward mutable iterator
+    MutableDoublyLinkedListIterator<T> end();
+
+    // Start of reverse iterator (the last node)
+    const_reverse_iterator rbegin() const;
+
+    // End of reverse iterator
+    const_reverse_iterator rend() const;
+
+    // Start of reverse mutable iterator (the last node)
+    reverse_iterator rbegin();
+
+    // End of reverse mutable iterator
+    reverse_iterator rend();
+
+    template <typename T2>
+    friend class ConstDoublyLinkedListIterator;
+
+    template <typename T2>
+    friend class MutableDoublyLinkedListIterator;
+
+private:
+    // Add a new node directly after an existing one
+    void insertAfter(DoublyListNode<T>* node, const T& value);
+
+    // Unlink a node from its neighbours and delete it
+    void unlink(DoublyListNode<T>* node);
+
+    // Pointer to first node in the list
+    DoublyListNode<T>* first{ nullptr };
+
+    // Pointer to last node in the list
+    DoublyListNode<T>* last{ nullptr };
+
+    // Number of nodes in the list
+    unsigned int size{ 0 };
+
+    // Number of changes that freed or moved nodes (see getInvalidations)
+    std::uint64_t invalidations{ 0 };
+};
+
+template <typename T>
+DoublyLinkedList<T>::~DoublyLinkedList()
+{
+    clear();
+}
+
+template <typename T>
+DoublyLinkedList<T>::DoublyLinkedList(const DoublyLinkedList<T>& original)
+{
+    for (DoublyListNode<T>* node{ original.first }; node; node = node->next)
+    {
+        addLast(node->value);
+    }
+}
+
+template <typename T>
+DoublyLinkedList<T>& DoublyLinkedList<T>::operator= (const DoublyLinkedList<T>& original)
+{
+    if (this != &original)
+    {
+        clear();
+
+        for (DoublyListNode<T>* node{ original.first }; node; node = node->next)
+        {
+            addLast(node->value);
+        }
+    }
+
+    return *this;
+}
+
+template <typename T>
+DoublyLinkedList<T>::DoublyLinkedList(DoublyLinkedList<T>&& original)
+    : first{ original.first }, last{ original.last }, size{ original.size }
+{
+    original.first = nullptr;
+    original.last = nullptr;
+    original.size = 0;
+    original.invalidations++;
+}
+
+template <typename T>
+DoublyLinkedList<T>& DoublyLinkedList<T>::operator= (DoublyLinkedList<T>&& original)
+{
+    if (this != &original)
+    {
+        clear();
+
+        first = original.first;
+        last = original.last;
+        size = original.size;
+        original.first = nullptr;
+        original.last = nullptr;
+        original.size = 0;
+        original.invalidations++;
+    }
+
+    return *this;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::clear()
+{
+    // Keep track of the next node to delete.
+    DoublyListNode<T>* toDelete{ first };
+
+    while (toDelete)
+    {
+        // Use first as temp storage
+        first = toDelete->next;
+
+        delete toDelete;
+
+        // Advance to the next node.
+        toDelete = first;
+    }
+
+    last = nullptr;
+    size = 0;
+    invalidations++;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::addFirst(T value)
+{
+    // Create a new node storing the new element
+    DoublyListNode<T>* newNode{ new DoublyListNode<T>() };
+    newNode->value = value;
+
+    // Link the new node and the old first node to each other
+    newNode->next = first;
+    if (first)
+    {
+        first->previous = newNode;
+    }
+    else
+    {
+        // If there is just one element in the
+        // list, first and last are the same.
+        last = newNode;
+    }
+
+    first = newNode;
+    size++;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::addLast(T value)
+{
+    if (last)
+    {
+        insertAfter(last, value);
+    }
+    else
+    {
+        addFirst(value);
+    }
+}
+
+template <typename T>
+void DoublyLinkedList<T>::removeFirst()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    unlink(first);
+}
+
+template <typename T>
+void DoublyLinkedList<T>::removeLast()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    unlink(last);
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T> DoublyLinkedList<T>::erase(MutableDoublyLinkedListIterator<T> position)
+{
+    if (!position.current)
+    {
+        throw std::logic_error("No item to erase");
+    }
+
+    DoublyListNode<T>* next{ position.current->next };
+    unlink(position.current);
+    return MutableDoublyLinkedListIterator<T>{ next, *this };
+}
+
+template <typename T>
+DoublyLinkedList<T> DoublyLinkedList<T>::splitAfter(MutableDoublyLinkedListIterator<T> position)
+{
+    DoublyLinkedList<T> rest{};
+    DoublyListNode<T>* previous{ position.current };
+    DoublyListNode<T>* node{ previous ? previous->next : first };
+    if (!node)
+    {
+        return rest;
+    }
+
+    for (DoublyListNode<T>* moved{ node }; moved; moved = moved->next)
+    {
+        rest.size++;
+    }
+
+    // Cut the links between previous and node.
+    rest.first = node;
+    rest.last = last;
+    node->previous = nullptr;
+    if (previous)
+    {
+        previous->next = nullptr;
+    }
+    else
+    {
+        first = nullptr;
+    }
+    last = previous;
+    size -= rest.size;
+    invalidations++;
+    return rest;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::append(DoublyLinkedList<T>&& other)
+{
+    if (&other == this || other.size == 0)
+    {
+        return;
+    }
+
+    if (last)
+    {
+        last->next = other.first;
+        other.first->previous = last;
+    }
+    else
+    {
+        first = other.first;
+    }
+    last = other.last;
+    size += other.size;
+    other.first = nullptr;
+    other.last = nullptr;
+    other.size = 0;
+    other.invalidations++;
+}
+
+template <typename T>
+const T& DoublyLinkedList<T>::getFirst() const
+{
+    if (first)
+    {
+        return first->value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+T& DoublyLinkedList<T>::getFirst()
+{
+    if (first)
+    {
+        return first->value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+const T& DoublyLinkedList<T>::getLast() const
+{
+    if (last)
+    {
+        return last->value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+T& DoublyLinkedList<T>::getLast()
+{
+    if (last)
+    {
+        return last->value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+unsigned int DoublyLinkedList<T>::getSize() const
+{
+    return size;
+}
+
+template <typename T>
+std::uint64_t DoublyLinkedList<T>::getInvalidations() const
+{
+    return invalidations;
+}
+
+template <typename T>
+ConstDoublyLinkedListIterator<T> DoublyLinkedList<T>::begin() const
+{
+    return ConstDoublyLinkedListIterator<T>{ first, *this };
+}
+
+template <typename T>
+ConstDoublyLinkedListIterator<T> DoublyLinkedList<T>::end() const
+{
+    return ConstDoublyLinkedListIterator<T>{ nullptr, *this };
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T> DoublyLinkedList<T>::begin()
+{
+    return MutableDoublyLinkedListIterator<T>{ first, *this };
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T> DoublyLinkedList<T>::end()
+{
+    return MutableDoublyLinkedListIterator<T>{ nullptr, *this };
+}
+
+template <typename T>
+typename DoublyLinkedList<T>::const_reverse_iterator DoublyLinkedList<T>::rbegin() const
+{
+    return const_reverse_iterator{ end() };
+}
+
+template <typename T>
+typename DoublyLinkedList<T>::const_reverse_iterator DoublyLinkedList<T>::rend() const
+{
+    return const_reverse_iterator{ begin() };
+}
+
+template <typename T>
+typename DoublyLinkedList<T>::reverse_iterator DoublyLinkedList<T>::rbegin()
+{
+    return reverse_iterator{ end() };
+}
+
+template <typename T>
+typename DoublyLinkedList<T>::reverse_iterator DoublyLinkedList<T>::rend()
+{
+    return reverse_iterator{ begin() };
+}
+
+template <typename T>
+void DoublyLinkedList<T>::insertAfter(DoublyListNode<T>* node, const T& value)
+{
+    // Create a new node storing the new element
+    DoublyListNode<T>* newNode{ new DoublyListNode<T>() };
+    newNode->value = value;
+
+    // Link it in between node and whatever came after it
+    newNode->previous = node;
+    newNode->next = node->next;
+    if (node->next)
+    {
+        node->next->previous = newNode;
+    }
+    else
+    {
+        last = newNode;
+    }
+
+    node->next = newNode;
+    size++;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::unlink(DoublyListNode<T>* node)
+{
+    // Point the neighbours (or the ends of the list) past the node
+    if (node->previous)
+    {
+        node->previous->next = node->next;
+    }
+    else
+    {
+        first = node->next;
+    }
+
+    if (node->next)
+    {
+        node->next->previous = node->previous;
+    }
+    else
+    {
+        last = node->previous;
+    }
+
+    delete node;
+    size--;
+    invalidations++;
+}
+
+template <typename T>
+std::ostream& operator << (
+    std::ostream& os, const DoublyLinkedList<T>& list)
+{
+    os << "[";
+
+    for (auto i{ list.begin() }; i != list.end(); i++)
+    {
+        if (i != list.begin())
+        {
+            // Print a comma between elements
+            os << ", ";
+        }
+
+        os << *i;
+    }
+
+    os << "]";
+    return os;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// A struct for representing a single node of a doubly-linked list.
+template <typename T>
+struct DoublyListNode
+{
+public:
+    // The data stored in the node.
+    T value;
+
+    // A pointer to the previous node in the list.
+    DoublyListNode<T>* previous{ nullptr };
+
+    // A pointer to the next node in the list.
+    DoublyListNode<T>* next{ nullptr };
+};
@@ -0,0 +1,203 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <type_traits>
+#include <unordered_map>
+#include "DoublyLinkedList.h"
+#include "HashIndex.h"
+#include "LinkedList.h"
+#include "LinkedSet.h"
+
+// An ordered set whose items each live until an expiry time, e.g. a window of
+// recently seen IDs. Alongside the LinkedSet holding the items, a chain of
+// (item, expiry) entries is kept in expiry order, so expire(now) only visits
+// the entries that are due; with LinkedList<T> a HashIndex makes each removal
+// O(1) (with BPlusTree<T>, O(log n)).
+// Expired items stay in the set until expire() is called, but contains()
+// already treats them as absent, reading only their entry.
+// Time is anything ordered with >, e.g. a clock's time_point or a tick count.
+// List selects the list implementation, as for LinkedSet.
+template <typename T, typename Time = std::chrono::steady_clock::time_point, typename List = LinkedList<T>>
+class ExpiringSet
+{
+public:
+    // Construct an empty set.
+    ExpiringSet();
+
+    // The entries point into the set itself, so it can't be copied.
+    ExpiringSet(const ExpiringSet<T, Time, List>& original) = delete;
+    ExpiringSet<T, Time, List>& operator= (const ExpiringSet<T, Time, List>& original) = delete;
+
+    // Check if the set contains an item that hasn't expired by now.
+    bool contains(const T& item, const Time& now) const;
+
+    // Add an item that lives until expiry (when now reaches it), or give an
+    // item already there a new expiry.
+    // Returns true if an item was added; false if only its expiry changed.
+    bool add(const T& item, const Time& expiry);
+
+    // Remove an item from the set, expired or not.
+    // Return true if an item was removed; false otherwise.
+    bool remove(const T& item);
+
+    // Remove every item that has expired by now, soonest first.
+    // Returns the number of items removed.
+    unsigned int expire(const Time& now);
+
+    // Remove all items from the set.
+    void clear();
+
+    // Get the number of items in the set, including expired ones expire() hasn't removed yet.
+    unsigned int getSize() const;
+
+    // Create an iterator that starts at the smallest item (expired ones included).
+    typename List::const_iterator begin() const;
+
+    // Create an iterator that has reached the end of the set.
+    typename List::const_iterator end() const;
+
+    template <typename T2, typename Time2, typename List2>
+    friend std::ostream& operator << (std::ostream& out, const ExpiringSet<T2, Time2, List2>& set);
+
+private:
+    // An item and when it expires
+    struct Entry
+    {
+        T item{};
+        Time expiry{};
+    };
+
+    // Link an entry into the chain after every entry that doesn't expire later.
+    // Returns where it went.
+    typename DoublyLinkedList<Entry>::iterator schedule(const T& item, const Time& expiry);
+
+    // Index of the items' nodes, so removing an item doesn't walk the list
+    // (LinkedList<T> only). Declared first so it outlives the items.
+    HashIndex<T> index;
+
+    // The items, in order
+    LinkedSet<T, List> items;
+
+    // The entries, soonest expiry first
+    DoublyLinkedList<Entry> timeline;
+
+    // Where each item's entry is
+    std::unordered_map<T, typename DoublyLinkedList<Entry>::iterator> entries;
+};
+
+template <typename T, typename Time, typename List>
+ExpiringSet<T, Time, List>::ExpiringSet()
+{
+    if constexpr (std::is_same<List, LinkedList<T>>::value)
+    {
+        items.setIndex(&index);
+    }
+}
+
+template <typename T, typename Time, typename List>
+bool ExpiringSet<T, Time, List>::contains(const T& item, const Time& now) const
+{
+    auto entry{ entries.find(item) };
+    return entry != entries.end() && entry->second->expiry > now;
+}
+
+template <typename T, typename Time, typename List>
+bool ExpiringSet<T, Time, List>::add(const T& item, const Time& expiry)
+{
+    auto entry{ entries.find(item) };
+    if (entry != entries.end())
+    {
+        // Already there; just move its entry.
+        timeline.erase(entry->second);
+        entry->second = schedule(item, expiry);
+        return false;
+    }
+
+    items.add(item);
+    entries.emplace(item, schedule(item, expiry));
+    return true;
+}
+
+template <typename T, typename Time, typename List>
+bool ExpiringSet<T, Time, List>::remove(const T& item)
+{
+    auto entry{ entries.find(item) };
+    if (entry == entries.end())
+    {
+        return false;
+    }
+
+    timeline.erase(entry->second);
+    entries.erase(entry);
+    items.remove(item);
+    return true;
+}
+
+template <typename T, typename Time, typename List>
+unsigned int ExpiringSet<T, Time, List>::expire(const Time& now)
+{
+    unsigned int removed{ 0 };
+    while (timeline.getSize() > 0 && !(timeline.getFirst().expiry > now))
+    {
+        const T& item{ timeline.getFirst().item };
+        items.remove(item);
+        entries.erase(item);
+        timeline.removeFirst();
+        removed++;
+    }
+
+    return removed;
+}
+
+template <typename T, typename Time, typename List>
+void ExpiringSet<T, Time, List>::clear()
+{
+    items.clear();
+    timeline.clear();
+    entries.clear();
+}
+
+template <typename T, typename Time, typename List>
+unsigned int ExpiringSet<T, Time, List>::getSize() const
+{
+    return items.getSize();
+}
+
+template <typename T, typename Time, typename List>
+typename List::const_iterator ExpiringSet<T, Time, List>::begin() const
+{
+    return items.begin();
+}
+
+template <typename T, typename Time, typename List>
+typename List::const_iterator ExpiringSet<T, Time, List>::end() const
+{
+    return items.end();
+}
+
+template <typename T, typename Time, typename List>
+typename DoublyLinkedList<typename ExpiringSet<T, Time, List>::Entry>::iterator ExpiringSet<T, Time, List>::schedule(const T& item, const Time& expiry)
+{
+    // Expiries mostly arrive in order (e.g. with a fixed time to live), so
+    // search back from the latest; then this takes O(1).
+    typename DoublyLinkedList<Entry>::iterator i{ timeline.end() };
+    while (i != timeline.begin())
+    {
+        --i;
+        if (!(i->expiry > expiry))
+        {
+            i.addNext(Entry{ item, expiry });
+            return ++i;
+        }
+    }
+
+    timeline.addFirst(Entry{ item, expiry });
+    return timeline.begin();
+}
+
+template <typename T, typename Time, typename List>
+std::ostream& operator << (std::ostream& out, const ExpiringSet<T, Time, List>& set)
+{
+    out << set.items;
+    return out;
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#endif
+#include "ConstFrozenSetIterator.h"
+#include "SimdSearch.h"
+
+template <typename T>
+class LinkedList;
+
+template <typename T, typename List>
+class LinkedSet;
+
+// An immutable ordered set for sets that are built once and then only
+// queried (see LinkedSet::freeze). The items are stored in one array in
+// Eytzinger order, i.e. breadth-first through an implicit balanced search
+// tree, so the first levels of every search share the same few cache lines.
+// Searches are branchless, and fetch the nodes a few levels further down
+// ahead of time.
+template <typename T>
+class FrozenSet
+{
+public:
+    // Iterator type
+    using const_iterator = ConstFrozenSetIterator<T>;
+
+    // Default constructor
+    FrozenSet() = default;
+
+    // Construct a set from items that are sorted and distinct.
+    explicit FrozenSet(const std::vector<T>& sorted);
+
+    // Checks if the set contains a particular item.
+    // Returns true if the item is found; false otherwise.
+    bool contains(const T& item) const;
+
+    // Get the number of elements in the set.
+    unsigned int getSize() const;
+
+    // Count the items in [low, high). The layout isn't in item order, so
+    // this looks at every item, but with the SIMD kernels.
+    unsigned int countInRange(const T& low, const T& high) const;
+
+    // Convert back into a LinkedSet that can be changed again.
+    // (Defined in LinkedSet.h, which has to be included to call it.)
+    template <typename List = LinkedList<T>>
+    LinkedSet<T, List> thaw() const;
+
+    // Create an iterator that starts at the smallest item in the set.
+    ConstFrozenSetIterator<T> begin() const;
+
+    // Create an iterator that has reached the end of the set.
+    ConstFrozenSetIterator<T> end() const;
+
+    template <typename T2>
+    friend std::ostream& operator << (std::ostream& out, const FrozenSet<T2>& set);
+
+private:
+    // Fill the subtree rooted at position k with sorted items, starting at next.
+    // Returns the index of the first item not used.
+    std::size_t build(const std::vector<T>& sorted, std::size_t next, std::size_t k);
+
+    // Hint that the item at position k is about to be needed.
+    void prefetch(std::size_t k) const;
+
+    // Number of tree levels that fit in a cache line; a search fetches the
+    // node this many levels below the current one, so it is already loaded
+    // by the time the search gets there.
+    static constexpr unsigned int prefetchLevels{
+        static_cast<unsigned int>(std::bit_width(std::max<std::size_t>(64 / sizeof(T), 1)) - 1) };
+
+    // The items in Eytzinger order, 1-based: the children of position k are at 2k and 2k + 1.
+    // Position 0 is unused, so the root is at 1.
+    std::vector<T> layout{ T{} };
+};
+
+template <typename T>
+FrozenSet<T>::FrozenSet(const std::vector<T>& sorted)
+    : layout(sorted.size() + 1)
+{
+    build(sorted, 0, 1);
+}
+
+template <typename T>
+bool FrozenSet<T>::contains(const T& item) const
+{
+    std::size_t size{ layout.size() - 1 };
+
+    // Walk down to a leaf, going right whenever the item is bigger. The
+    // comparison picks the child rather than a branch, so there is nothing to mispredict.
+    std::size_t k{ 1 };
+    while (k <= size)
+    {
+        prefetch(k << prefetchLevels);
+        k = 2 * k + (item > layout[k] ? 1 : 0);
+    }
+
+    // The last time the search went left was at the smallest item not smaller than the
+    // one searched for; undo the right turns after it, and then that left turn.
+    k >>= std::countr_one(k) + 1;
+    return k != 0 && layout[k] == item;
+}
+
+template <typename T>
+unsigned int FrozenSet<T>::getSize() const
+{
+    return static_cast<unsigned int>(layout.size() - 1);
+}
+
+template <typename T>
+unsigned int FrozenSet<T>::countInRange(const T& low, const T& high) const
+{
+    return simdCountInRange(layout.data() + 1, getSize(), low, high);
+}
+
+template <typename T>
+ConstFrozenSetIterator<T> FrozenSet<T>::begin() const
+{
+    // The smallest item is the leftmost one.
+    std::size_t size{ layout.size() - 1 };
+    std::size_t k{ size > 0 ? 1u : 0u };
+    while (k > 0 && 2 * k <= size)
+    {
+        k *= 2;
+    }
+
+    return ConstFrozenSetIterator<T>{ layout.data(), size, k };
+}
+
+template <typename T>
+ConstFrozenSetIterator<T> FrozenSet<T>::end() const
+{
+    return ConstFrozenSetIterator<T>{ layout.data(), layout.size() - 1, 0 };
+}
+
+template <typename T>
+std::size_t FrozenSet<T>::build(const std::vector<T>& sorted, std::size_t next, std::size_t k)
+{
+    // An in-order walk of the implicit tree visits the positions in item order.
+    if (k < layout.size())
+    {
+        next = build(sorted, next, 2 * k);
+        layout[k] = sorted[next++];
+        next = build(sorted, next, 2 * k + 1);
+    }
+
+    return next;
+}
+
+template <typename T>
+void FrozenSet<T>::prefetch(std::size_t k) const
+{
+    // Clamped so that the address stays inside the array.
+    const T* address{ layout.data() + std::min(k, layout.size() - 1) };
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_M_X64) || defined(_M_IX86)
+    _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+template <typename T>
+std::ostream& operator << (std::ostream& out, const FrozenSet<T>& set)
+{
+    // Printed like a list: [a, b, c]
+    out << "[";
+    for (ConstFrozenSetIterator<T> i{ set.begin() }; i != set.end(); ++i)
+    {
+        if (i != set.begin())
+        {
+            out << ", ";
+        }
+        out << *i;
+    }
+    out << "]";
+    return out;
+}
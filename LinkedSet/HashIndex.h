@@ -0,0 +1,283 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "HashMix.h"
+#include "ListNode.h"
+#include "ListObserver.h"
+
+// An open-addressing hash table from each item of a singly-linked list to
+// its node and the node before it, so that an item can be found, or
+// unlinked, without walking the list. Attached to a list as an observer,
+// it tracks the list's contents by itself. Items must be distinct, as they
+// are in a set.
+template <typename T, typename Hash = std::hash<T>>
+class HashIndex : public ListObserver<T>
+{
+public:
+    // Construct an empty index with room for expectedItems items before it grows.
+    explicit HashIndex(unsigned int expectedItems = 0);
+
+    // Check if an item is indexed.
+    bool contains(const T& item) const;
+
+    // Get the node holding an item, or nullptr if it isn't indexed.
+    const ListNode<T>* find(const T& item) const;
+
+    // Get the node before the one holding an item (nullptr if it is the
+    // first node), or nothing if the item isn't indexed.
+    std::optional<const ListNode<T>*> findPrevious(const T& item) const;
+
+    // Forget every item.
+    void clear();
+
+    // Get the number of items indexed.
+    unsigned int getItemCount() const;
+
+    // Get the memory used by the table, in bytes.
+    std::size_t getMemoryUsage() const;
+
+    // ListObserver callbacks
+    void inserted(const ListNode<T>* previous, const ListNode<T>* node) override;
+    void removing(const ListNode<T>* previous, const ListNode<T>* node) override;
+    void relocated(const ListNode<T>* node) override;
+    void clearing() override;
+
+private:
+    // A slot of the table; empty while node is nullptr.
+    // The item is kept in the slot, so probing never has to follow a node
+    // pointer (the nodes may have moved by the time relocated() is called).
+    struct Slot
+    {
+        // The item.
+        T item{};
+
+        // The node holding the item.
+        const ListNode<T>* node{ nullptr };
+
+        // The node before it, or nullptr if it is the first node.
+        const ListNode<T>* previous{ nullptr };
+    };
+
+    // Get the slot holding an item, or nullptr if it isn't indexed.
+    Slot* findSlot(const T& item);
+    const Slot* findSlot(const T& item) const;
+
+    // Get the slot an item would ideally live in.
+    std::size_t home(const T& item) const;
+
+    // Put a slot into the table; its item must not be indexed yet.
+    void insert(Slot slot);
+
+    // Empty a slot, shifting back the slots after it so no lookup stops short.
+    void erase(Slot* slot);
+
+    // Double the number of slots and put every node back in.
+    void grow();
+
+    // The table; the number of slots is a power of two and kept at most 3/4 full.
+    std::vector<Slot> slots;
+
+    // Number of items indexed.
+    unsigned int itemCount{ 0 };
+};
+
+template <typename T, typename Hash>
+HashIndex<T, Hash>::HashIndex(unsigned int expectedItems)
+{
+    std::size_t count{ 16 };
+    while (count * 3 / 4 < expectedItems)
+    {
+        count *= 2;
+    }
+
+    slots.resize(count);
+}
+
+template <typename T, typename Hash>
+bool HashIndex<T, Hash>::contains(const T& item) const
+{
+    return findSlot(item) != nullptr;
+}
+
+template <typename T, typename Hash>
+const ListNode<T>* HashIndex<T, Hash>::find(const T& item) const
+{
+    const Slot* slot{ findSlot(item) };
+    return slot ? slot->node : nullptr;
+}
+
+template <typename T, typename Hash>
+std::optional<const ListNode<T>*> HashIndex<T, Hash>::findPrevious(const T& item) const
+{
+    const Slot* slot{ findSlot(item) };
+    if (!slot)
+    {
+        return std::nullopt;
+    }
+
+    return slot->previous;
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::clear()
+{
+    std::fill(slots.begin(), slots.end(), Slot{});
+    itemCount = 0;
+}
+
+template <typename T, typename Hash>
+unsigned int HashIndex<T, Hash>::getItemCount() const
+{
+    return itemCount;
+}
+
+template <typename T, typename Hash>
+std::size_t HashIndex<T, Hash>::getMemoryUsage() const
+{
+    return slots.size() * sizeof(Slot);
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::inserted(const ListNode<T>* previous, const ListNode<T>* node)
+{
+    insert(Slot{ node->value, node, previous });
+
+    // The node that used to follow previous now follows the new node.
+    if (node->next)
+    {
+        if (Slot* following{ findSlot(node->next->value) })
+        {
+            following->previous = node;
+        }
+    }
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::removing(const ListNode<T>* previous, const ListNode<T>* node)
+{
+    if (node->next)
+    {
+        if (Slot* following{ findSlot(node->next->value) })
+        {
+            following->previous = previous;
+        }
+    }
+
+    if (Slot* slot{ findSlot(node->value) })
+    {
+        erase(slot);
+    }
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::relocated(const ListNode<T>* node)
+{
+    if (Slot* slot{ findSlot(node->value) })
+    {
+        slot->node = node;
+    }
+
+    if (node->next)
+    {
+        if (Slot* following{ findSlot(node->next->value) })
+        {
+            following->previous = node;
+        }
+    }
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::clearing()
+{
+    clear();
+}
+
+template <typename T, typename Hash>
+typename HashIndex<T, Hash>::Slot* HashIndex<T, Hash>::findSlot(const T& item)
+{
+    return const_cast<Slot*>(static_cast<const HashIndex<T, Hash>&>(*this).findSlot(item));
+}
+
+template <typename T, typename Hash>
+const typename HashIndex<T, Hash>::Slot* HashIndex<T, Hash>::findSlot(const T& item) const
+{
+    // Linear probing: an item is somewhere in the run of full slots starting at its home.
+    std::size_t mask{ slots.size() - 1 };
+    for (std::size_t i{ home(item) }; slots[i].node; i = (i + 1) & mask)
+    {
+        if (slots[i].item == item)
+        {
+            return &slots[i];
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename T, typename Hash>
+std::size_t HashIndex<T, Hash>::home(const T& item) const
+{
+    return static_cast<std::size_t>(mixHash(static_cast<std::uint64_t>(Hash{}(item)))) & (slots.size() - 1);
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::insert(Slot slot)
+{
+    if ((itemCount + 1) * 4 > slots.size() * 3)
+    {
+        grow();
+    }
+
+    std::size_t mask{ slots.size() - 1 };
+    std::size_t i{ home(slot.item) };
+    while (slots[i].node)
+    {
+        i = (i + 1) & mask;
+    }
+
+    slots[i] = std::move(slot);
+    itemCount++;
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::erase(Slot* slot)
+{
+    // Rather than leaving a tombstone, pull back any later slot of the run
+    // whose home is at or before the gap, so the run has no holes.
+    std::size_t mask{ slots.size() - 1 };
+    std::size_t gap{ static_cast<std::size_t>(slot - slots.data()) };
+    for (std::size_t i{ (gap + 1) & mask }; slots[i].node; i = (i + 1) & mask)
+    {
+        // Distance travelled from home, compared with the distance from the gap.
+        std::size_t wanted{ home(slots[i].item) };
+        if (((i - wanted) & mask) >= ((i - gap) & mask))
+        {
+            slots[gap] = std::move(slots[i]);
+            gap = i;
+        }
+    }
+
+    slots[gap] = Slot{};
+    itemCount--;
+}
+
+template <typename T, typename Hash>
+void HashIndex<T, Hash>::grow()
+{
+    std::vector<Slot> old(slots.size() * 2);
+    old.swap(slots);
+    itemCount = 0;
+
+    for (Slot& slot : old)
+    {
+        if (slot.node)
+        {
+            insert(std::move(slot));
+        }
+    }
+}
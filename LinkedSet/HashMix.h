@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// Scramble the bits of a hash (the splitmix64 finalizer). Standard hashes
+// are often the identity for integers, so neighbouring keys would otherwise
+// land next to each other in a table or filter.
+inline std::uint64_t mixHash(std::uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+// Check if std::hash can hash T. Code that only hashes items once a filter
+// or index is attached checks this, so that it still compiles for other types.
+template <typename T, typename = void>
+struct IsHashable : std::false_type
+{
+};
+
+template <typename T>
+struct IsHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type
+{
+};
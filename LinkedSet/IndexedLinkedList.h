@@ -0,0 +1,366 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "IndexedListNode.h"
+#include "ConstIndexedListIterator.h"
+#include "MutableIndexedListIterator.h"
+
+// A container class for a singly-linked list whose nodes live in a single
+// pooled array and link to each other by 32-bit index.
+// For small T this roughly halves the memory used per element compared to
+// LinkedList on 64-bit builds, and since no node stores an address, the whole
+// node array can be copied byte for byte (e.g. into shared memory).
+// Growing the array invalidates references to elements, but not iterators.
+template <typename T>
+class IndexedLinkedList
+{
+public:
+    // Iterator types
+    using iterator = MutableIndexedListIterator<T>;
+    using const_iterator = ConstIndexedListIterator<T>;
+
+    // Default constructor
+    IndexedLinkedList() = default;
+
+    // Copy constructor; indices stay valid, since the array is copied as is
+    IndexedLinkedList(const IndexedLinkedList<T>& original) = default;
+
+    // Copy assignment op
+    IndexedLinkedList<T>& operator= (const IndexedLinkedList<T>& original) = default;
+
+    // Move constructor; leaves the original empty
+    IndexedLinkedList(IndexedLinkedList<T>&& original);
+
+    // Move assignment op; leaves the original empty
+    IndexedLinkedList<T>& operator= (IndexedLinkedList<T>&& original);
+
+    // Clear list without destroying container
+    void clear();
+
+    // Make room for at least capacity nodes without reallocating
+    void reserve(unsigned int capacity);
+
+    // Add node to the beginning of the list
+    void addFirst(T value);
+
+    // Add node to the end of the list
+    void addLast(T value);
+
+    // Remove node from the beginning of the list
+    void removeFirst();
+
+    // Get element at the beginning of the list
+    const T& getFirst() const;
+
+    // Get element at the beginning of the list
+    T& getFirst();
+
+    // Get element at the end of the list
+    const T& getLast() const;
+
+    // Get element at the end of the list
+    T& getLast();
+
+    // Get number of nodes in the list
+    unsigned int getSize() const;
+
+    // Count the changes that have freed nodes, including through iterators.
+    // While the count stays the same, iterators kept from earlier are still
+    // valid (a freed slot may otherwise hold another node by now).
+    std::uint64_t getInvalidations() const;
+
+    // Get the node array; links are indices into this array.
+    const std::vector<IndexedListNode<T>>& getNodes() const;
+
+    // Start of forward iterator
+    ConstIndexedListIterator<T> begin() const;
+
+    // End of forward iterator
+    ConstIndexedListIterator<T> end() const;
+
+    // Start of forward mutable iterator
+    MutableIndexedListIterator<T> begin();
+
+    // End of forward mutable iterator
+    MutableIndexedListIterator<T> end();
+
+    template <typename T2>
+    friend class ConstIndexedListIterator;
+
+    template <typename T2>
+    friend class MutableIndexedListIterator;
+
+private:
+    // Take a free slot (or grow the array) and store a copy of value in it
+    std::uint32_t createNode(const T& value);
+
+    // Put a node's slot on the free list
+    void destroyNode(std::uint32_t index);
+
+    // All nodes, live and free
+    std::vector<IndexedListNode<T>> nodes;
+
+    // Index of first node in the list
+    std::uint32_t first{ IndexedListNode<T>::none };
+
+    // Index of last node in the list
+    std::uint32_t last{ IndexedListNode<T>::none };
+
+    // Index of the first free slot, chained through next
+    std::uint32_t freeList{ IndexedListNode<T>::none };
+
+    // Number of nodes in the list
+    unsigned int size{ 0 };
+
+    // Number of changes that freed nodes (see getInvalidations)
+    std::uint64_t invalidations{ 0 };
+};
+
+template <typename T>
+IndexedLinkedList<T>::IndexedLinkedList(IndexedLinkedList<T>&& original)
+    : nodes{ std::move(original.nodes) }, first{ original.first }, last{ original.last },
+    freeList{ original.freeList }, size{ original.size }
+{
+    original.clear();
+}
+
+template <typename T>
+IndexedLinkedList<T>& IndexedLinkedList<T>::operator= (IndexedLinkedList<T>&& original)
+{
+    if (this != &original)
+    {
+        nodes = std::move(original.nodes);
+        first = original.first;
+        last = original.last;
+        freeList = original.freeList;
+        size = original.size;
+        invalidations++;
+        original.clear();
+    }
+
+    return *this;
+}
+
+template <typename T>
+void IndexedLinkedList<T>::clear()
+{
+    // Every node lives in the array, so there is nothing to walk.
+    nodes.clear();
+    first = IndexedListNode<T>::none;
+    last = IndexedListNode<T>::none;
+    freeList = IndexedListNode<T>::none;
+    size = 0;
+    invalidations++;
+}
+
+template <typename T>
+void IndexedLinkedList<T>::reserve(unsigned int capacity)
+{
+    nodes.reserve(capacity);
+}
+
+template <typename T>
+void IndexedLinkedList<T>::addFirst(T value)
+{
+    std::uint32_t newNode{ createNode(value) };
+
+    // Link the new node to the old first node
+    nodes[newNode].next = first;
+    first = newNode;
+
+    if (last == IndexedListNode<T>::none)
+    {
+        // If there is just one element in the
+        // list, first and last are the same.
+        last = first;
+    }
+
+    size++;
+}
+
+template <typename T>
+void IndexedLinkedList<T>::addLast(T value)
+{
+    std::uint32_t newNode{ createNode(value) };
+
+    if (size == 0)
+    {
+        first = newNode;
+    }
+    else
+    {
+        nodes[last].next = newNode;
+    }
+
+    last = newNode;
+    size++;
+}
+
+template <typename T>
+void IndexedLinkedList<T>::removeFirst()
+{
+    if (size == 0)
+    {
+        throw std::out_of_range("Empty list");
+    }
+
+    std::uint32_t oldFirst{ first };
+    first = nodes[oldFirst].next;
+    destroyNode(oldFirst);
+    size--;
+
+    if (size == 0)
+    {
+        last = IndexedListNode<T>::none;
+    }
+}
+
+template <typename T>
+const T& IndexedLinkedList<T>::getFirst() const
+{
+    if (size > 0)
+    {
+        return nodes[first].value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+T& IndexedLinkedList<T>::getFirst()
+{
+    if (size > 0)
+    {
+        return nodes[first].value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+const T& IndexedLinkedList<T>::getLast() const
+{
+    if (size > 0)
+    {
+        return nodes[last].value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+T& IndexedLinkedList<T>::getLast()
+{
+    if (size > 0)
+    {
+        return nodes[last].value;
+    }
+    else
+    {
+        throw std::out_of_range("Empty list");
+    }
+}
+
+template <typename T>
+unsigned int IndexedLinkedList<T>::getSize() const
+{
+    return size;
+}
+
+template <typename T>
+std::uint64_t IndexedLinkedList<T>::getInvalidations() const
+{
+    return invalidations;
+}
+
+template <typename T>
+const std::vector<IndexedListNode<T>>& IndexedLinkedList<T>::getNodes() const
+{
+    return nodes;
+}
+
+template <typename T>
+ConstIndexedListIterator<T> IndexedLinkedList<T>::begin() const
+{
+    return ConstIndexedListIterator<T>{ first, *this };
+}
+
+template <typename T>
+ConstIndexedListIterator<T> IndexedLinkedList<T>::end() const
+{
+    return ConstIndexedListIterator<T>{ IndexedListNode<T>::none, *this };
+}
+
+template <typename T>
+MutableIndexedListIterator<T> IndexedLinkedList<T>::begin()
+{
+    return MutableIndexedListIterator<T>{ first, *this };
+}
+
+template <typename T>
+MutableIndexedListIterator<T> IndexedLinkedList<T>::end()
+{
+    return MutableIndexedListIterator<T>{ IndexedListNode<T>::none, *this };
+}
+
+template <typename T>
+std::uint32_t IndexedLinkedList<T>::createNode(const T& value)
+{
+    if (freeList != IndexedListNode<T>::none)
+    {
+        // Reuse a free slot.
+        std::uint32_t index{ freeList };
+        freeList = nodes[index].next;
+        nodes[index].value = value;
+        nodes[index].next = IndexedListNode<T>::none;
+        return index;
+    }
+
+    if (nodes.size() >= IndexedListNode<T>::none)
+    {
+        throw std::length_error("Too many nodes for 32-bit links");
+    }
+
+    nodes.push_back(IndexedListNode<T>{ value, IndexedListNode<T>::none });
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+}
+
+template <typename T>
+void IndexedLinkedList<T>::destroyNode(std::uint32_t index)
+{
+    // Let go of whatever the value holds on to, then chain the slot onto the free list.
+    nodes[index].value = T{};
+    nodes[index].next = freeList;
+    freeList = index;
+    invalidations++;
+}
+
+template <typename T>
+std::ostream& operator << (
+    std::ostream& os, const IndexedLinkedList<T>& list)
+{
+    os << "[";
+
+    for (auto i{ list.begin() }; i != list.end(); i++)
+    {
+        if (i != list.begin())
+        {
+            // Print a comma between elements
+            os << ", ";
+        }
+
+        os << *i;
+    }
+
+    os << "]";
+    return os;
+}
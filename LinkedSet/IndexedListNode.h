@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+// A struct for representing a single node of an index-linked list.
+// Nodes live in one array and refer to each other by position rather than
+// by address, so a 32-bit link replaces a 64-bit pointer.
+template <typename T>
+struct IndexedListNode
+{
+public:
+    // Link value meaning "no node".
+    static constexpr std::uint32_t none{ 0xFFFFFFFF };
+
+    // The data stored in the node.
+    T value;
+
+    // The index of the next node in the list.
+    std::uint32_t next{ none };
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "ListNode.h"
+
+// Raw storage for a list's first few nodes, kept inside the list itself.
+// Nodes are constructed and destroyed in it by the list.
+template <typename T, unsigned int Capacity>
+class InlineNodeStorage
+{
+public:
+    // Get the first slot.
+    ListNode<T>* nodes();
+
+    // Get the first slot.
+    const ListNode<T>* nodes() const;
+
+private:
+    // The bytes of the slots
+    alignas(ListNode<T>) unsigned char bytes[Capacity * sizeof(ListNode<T>)]{};
+};
+
+// No inline nodes (they are too big): nothing to store, so the list can
+// hold this as an empty member.
+template <typename T>
+class InlineNodeStorage<T, 0>
+{
+public:
+    // Get the first slot; there are none.
+    ListNode<T>* nodes();
+
+    // Get the first slot; there are none.
+    const ListNode<T>* nodes() const;
+};
+
+template <typename T, unsigned int Capacity>
+ListNode<T>* InlineNodeStorage<T, Capacity>::nodes()
+{
+    return reinterpret_cast<ListNode<T>*>(bytes);
+}
+
+template <typename T, unsigned int Capacity>
+const ListNode<T>* InlineNodeStorage<T, Capacity>::nodes() const
+{
+    return reinterpret_cast<const ListNode<T>*>(bytes);
+}
+
+template <typename T>
+ListNode<T>* InlineNodeStorage<T, 0>::nodes()
+{
+    return nullptr;
+}
+
+template <typename T>
+const ListNode<T>* InlineNodeStorage<T, 0>::nodes() const
+{
+    return nullptr;
+}
@@ -1,7 +1,23 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <ostream>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LINKEDLIST_SSE2
+#endif
+#include "InlineNodeStorage.h"
 #include "ListNode.h"
-#include "LinkedSet.h"
+#include "ListObserver.h"
+#include "NodePool.h"
+#include "NodeReclaimer.h"
+#include "ThreadPool.h"
 
 template <typename T>
 class ConstLinkedListIterator;
@@ -14,6 +30,10 @@ template <typename T>
 class LinkedList
 {
 public:
+    // Iterator types
+    using iterator = MutableLinkedListIterator<T>;
+    using const_iterator = ConstLinkedListIterator<T>;
+
     // Default constructor
     LinkedList() = default;
 
@@ -35,15 +55,53 @@ public:
     // Clear list without destroying container
     void clear();
 
+    // Allocate new nodes from contiguous blocks instead of one at a time.
+    // For trivially copyable, trivially destructible T this also lets copies
+    // duplicate whole blocks with memcpy, and clear() release the blocks
+    // without visiting every node.
+    void setPooledStorage(bool pooled);
+
+    // Hand the nodes to a reclaimer instead of freeing them inline whenever
+    // the list is cleared or destroyed; pass nullptr to free inline again.
+    // The reclaimer must outlive the list.
+    void setReclaimer(NodeReclaimer<T>* reclaimer);
+
+    // Start telling an observer about every node linked in or out of the list.
+    // The observer is first told about the nodes already there, in order, as
+    // if each had just been linked in.
+    // Observers belong to the list object rather than its contents: copies and
+    // moved-to lists start without any, while assigning new contents to a list
+    // tells its observers about the change.
+    void addObserver(ListObserver<T>* observer);
+
+    // Stop telling an observer about changes.
+    void removeObserver(ListObserver<T>* observer);
+
     // Add node to the beginning of the list
     void addFirst(T value);
 
     // Add node to the end of the list
     void addLast(T value);
 
+    // Add count values to the end of the list, in order.
+    // Long runs of heap nodes are built on the given threads, one chunk per
+    // thread, and the chunks are then stitched onto the end of the list.
+    void addLastRange(const T* values, unsigned int count, ThreadPool& threads);
+
     // Remove node from the beginning of the list
     void removeFirst();
 
+    // Move every node after position (every node, if position is end()) to a
+    // new list, which is returned. Heap nodes are relinked rather than copied,
+    // so the only work is counting them; nodes kept inline or in the pool
+    // belong to this list's storage, so those are copied instead.
+    LinkedList<T> splitAfter(MutableLinkedListIterator<T> position);
+
+    // Move every node of other to the end of this list, leaving other empty.
+    // Takes O(1) if other's nodes are on the heap and nobody observes either
+    // list; otherwise every node of other is visited (or copied, if inline or pooled).
+    void append(LinkedList<T>&& other);
+
     // Get element at the beginning of the list
     const T& getFirst() const;
 
@@ -59,6 +117,34 @@ public:
     // Get number of nodes in the list
     unsigned int getSize() const;
 
+    // Count the changes that have freed or moved nodes, including through
+    // iterators. While the count stays the same, iterators kept from earlier
+    // are still valid.
+    std::uint64_t getInvalidations() const;
+
+    // Check if every node is stored inside the list object itself.
+    // Small lists keep their nodes inline and only move them to the heap
+    // once they grow past inlineCapacity, which invalidates iterators.
+    bool isInline() const;
+
+    // Search the inline nodes for a value, in storage rather than list order.
+    // Only meaningful while isInline() is true.
+    bool inlineContains(const T& value) const;
+
+    // Number of nodes that can be stored inline (up to 8, in at most 128 bytes)
+    static constexpr unsigned int inlineCapacity{
+        sizeof(ListNode<T>) * 8 <= 128 ? 8 : static_cast<unsigned int>(128 / sizeof(ListNode<T>)) };
+
+    // Visit up to maxNodes nodes, relocating them into contiguous memory in
+    // iteration order. Nodes that already sit in the pool after the node
+    // before them (later in its block, or in a newer block) are left where
+    // they are, so compacting a list that is already compact moves nothing,
+    // and a second pass after a change settles. Each call picks up where the previous one
+    // left off, so a long list can be compacted a little at a time.
+    // Returns true once the whole list has been visited.
+    // Relocating a node invalidates any iterators pointing at it.
+    bool compact(unsigned int maxNodes = std::numeric_limits<unsigned int>::max());
+
     // Start of forward iterator
     ConstLinkedListIterator<T> begin() const;
 
@@ -76,6 +162,43 @@ public:
 
 
 private:
+    // Allocate a node holding a copy of value
+    ListNode<T>* createNode(const T& value);
+
+    // Destroy a node and give back its memory
+    void destroyNode(ListNode<T>* node);
+
+    // Check if every node lives in the pool, so whole blocks can be copied or freed at once
+    bool isFullyPooled() const;
+
+    // Make sure another node can be added; if the inline storage is full,
+    // every node is moved out to the heap. Returns the new address of position.
+    ListNode<T>* makeRoom(ListNode<T>* position);
+
+    // Move every inline node out to the heap. Returns the new address of position.
+    ListNode<T>* moveToHeap(ListNode<T>* position);
+
+    // Move the nodes of an inline list into this (empty) list's inline storage.
+    void takeInlineNodes(LinkedList<T>& original);
+
+    // Get the i-th inline node slot
+    ListNode<T>* inlineSlot(unsigned int i);
+
+    // Tell the observers a node has been linked in after previous
+    void notifyInserted(const ListNode<T>* previous, const ListNode<T>* node);
+
+    // Tell the observers about every node, from node onwards, as if each had just been linked in
+    void notifyInsertedFrom(const ListNode<T>* previous, const ListNode<T>* node);
+
+    // Tell the observers a node is about to be unlinked from after previous
+    void notifyRemoving(const ListNode<T>* previous, const ListNode<T>* node);
+
+    // Tell the observers a node has moved
+    void notifyRelocated(const ListNode<T>* node);
+
+    // Check if a node lives in the inline storage
+    bool isInlineNode(const ListNode<T>* node) const;
+
     // Pointer to first node in the list
     ListNode<T>* first{ nullptr };
 
@@ -84,6 +207,34 @@ private:
 
     // Number of nodes in the list
     unsigned int size{ 0 };
+
+    // Contiguous storage for nodes that have been compacted
+    NodePool<T> pool;
+
+    // Last node relocated by an unfinished compact() pass, if any
+    ListNode<T>* compactCursor{ nullptr };
+
+    // Where to send the nodes on clear(), if they shouldn't be freed inline
+    NodeReclaimer<T>* reclaimer{ nullptr };
+
+    // Should new nodes be allocated from the pool?
+    bool pooled{ false };
+
+    // Bit i is set if inline slot i holds a node
+    unsigned int inlineUsed{ 0 };
+
+    // Number of nodes in the inline slots; either 0 or size
+    unsigned int inlineCount{ 0 };
+
+    // Who to tell about nodes being linked in or out
+    std::vector<ListObserver<T>*> observers;
+
+    // Number of changes that freed or moved nodes (see getInvalidations)
+    std::uint64_t invalidations{ 0 };
+
+    // Storage for the first few nodes, so small lists need no allocations
+    // (none at all if the nodes are too big to keep inline)
+    [[no_unique_address]] InlineNodeStorage<T, inlineCapacity> inlineStorage;
 };
 
 template<typename T>
@@ -94,7 +245,21 @@ LinkedList<T>::~LinkedList()
 
 template<typename T>
 LinkedList<T>::LinkedList(const LinkedList<T>& original)
+    : pooled { original.pooled }
 {
+    if constexpr (std::is_trivially_copyable<T>::value)
+    {
+        if (original.isFullyPooled())
+        {
+            // Duplicate the blocks in bulk instead of adding the nodes one by one.
+            first = original.first;
+            last = original.last;
+            pool.copyFrom(original.pool, first, last);
+            size = original.size;
+            return;
+        }
+    }
+
     ListNode<T>* newNode{ original.first };
 
 
@@ -118,6 +283,20 @@ LinkedList<T>& LinkedList<T>::operator=(const LinkedList<T>& original)
     if (!(first == original.first && last == original.last && size == original.size)) {
         this->clear();
 
+        if constexpr (std::is_trivially_copyable<T>::value)
+        {
+            if (original.isFullyPooled())
+            {
+                // Duplicate the blocks in bulk instead of adding the nodes one by one.
+                first = original.first;
+                last = original.last;
+                pool.copyFrom(original.pool, first, last);
+                size = original.size;
+                notifyInsertedFrom(nullptr, first);
+                return *this;
+            }
+        }
+
         ListNode<T>* newNode{ original.first };
 
 
@@ -137,34 +316,110 @@ LinkedList<T>& LinkedList<T>::operator=(const LinkedList<T>& original)
 
         return *this;
     }
+
+    return *this;
 }
 
 template<typename T>
 LinkedList<T>::LinkedList(LinkedList<T>&& original)
-    : first { original.first }, last { original.last }, size { original.size }
+    : first { original.first }, last { original.last }, size { original.size },
+    pool { std::move(original.pool) }, compactCursor { original.compactCursor }, reclaimer { original.reclaimer },
+    pooled { original.pooled }
 {
+    if (original.inlineCount > 0)
+    {
+        // Inline nodes live inside the original, so they have to be moved one by one.
+        takeInlineNodes(original);
+        return;
+    }
+
+    for (ListObserver<T>* observer : original.observers)
+    {
+        observer->clearing();
+    }
+
     original.first = nullptr;
     original.last = nullptr;
     original.size = 0;
+    original.compactCursor = nullptr;
+    original.invalidations++;
 }
 
 template<typename T>
 LinkedList<T>& LinkedList<T>::operator=(LinkedList<T>&& original)
 {
     if (!(first == original.first && last == original.last && size == original.size)) {
+        // Free the nodes being replaced (and any pool they live in).
+        this->clear();
+        pooled = original.pooled;
+
+        if (original.inlineCount > 0)
+        {
+            // Inline nodes live inside the original, so they have to be moved one by one.
+            takeInlineNodes(original);
+            notifyInsertedFrom(nullptr, first);
+            return *this;
+        }
+
+        for (ListObserver<T>* observer : original.observers)
+        {
+            observer->clearing();
+        }
+
         first = original.first;
         last = original.last;
         size = original.size;
+        pool = std::move(original.pool);
+        compactCursor = original.compactCursor;
         original.first = nullptr;
         original.last = nullptr;
         original.size = 0;
+        original.compactCursor = nullptr;
+        original.invalidations++;
+        notifyInsertedFrom(nullptr, first);
         return *this;
     }
+
+    return *this;
 }
 
 template<typename T>
 void LinkedList<T>::clear()
 {
+    if (size > 0)
+    {
+        for (ListObserver<T>* observer : observers)
+        {
+            observer->clearing();
+        }
+        invalidations++;
+    }
+
+    if (reclaimer && inlineCount == 0)
+    {
+        // Detach the whole chain in one go and let the reclaimer free it.
+        reclaimer->retire(first, size, std::move(pool));
+        first = nullptr;
+        last = nullptr;
+        size = 0;
+        compactCursor = nullptr;
+        return;
+    }
+
+    if constexpr (std::is_trivially_destructible<T>::value)
+    {
+        if (isFullyPooled())
+        {
+            // Nothing to destroy, so just hand back the blocks.
+            pool.releaseAll();
+            first = nullptr;
+            last = nullptr;
+            size = 0;
+            compactCursor = nullptr;
+            return;
+        }
+    }
+
     // Keep track of the next node to delete.
     ListNode<T>* toDelete{ first };
 
@@ -174,7 +429,7 @@ void LinkedList<T>::clear()
         // Use first as temp storage
         first = toDelete->next;
 
-        delete toDelete;
+        destroyNode(toDelete);
 
         // Advance to the next node.
         toDelete = first;
@@ -183,16 +438,48 @@ void LinkedList<T>::clear()
 
     last = nullptr;
     size = 0;
+
+    // Every node is gone, so any compacted blocks can go too.
+    pool.releaseAll();
+    compactCursor = nullptr;
+}
+
+template<typename T>
+void LinkedList<T>::setPooledStorage(bool pooled)
+{
+    this->pooled = pooled;
+}
+
+template<typename T>
+void LinkedList<T>::setReclaimer(NodeReclaimer<T>* reclaimer)
+{
+    this->reclaimer = reclaimer;
+}
+
+template<typename T>
+void LinkedList<T>::addObserver(ListObserver<T>* observer)
+{
+    const ListNode<T>* previous{ nullptr };
+    for (const ListNode<T>* node{ first }; node; previous = node, node = node->next)
+    {
+        observer->inserted(previous, node);
+    }
+
+    observers.push_back(observer);
+}
+
+template<typename T>
+void LinkedList<T>::removeObserver(ListObserver<T>* observer)
+{
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
 }
 
 template <typename T>
 void LinkedList<T>::addFirst(T value)
 {
-    // Create a new node
-    ListNode<T>* newNode{ new ListNode<T>() };
-
-    // Store the new element in the new node
-    newNode->value = value;
+    // Create a new node storing the new element
+    makeRoom(nullptr);
+    ListNode<T>* newNode{ createNode(value) };
 
     // Link the new node to the old first node
     newNode->next = first;
@@ -208,29 +495,121 @@ void LinkedList<T>::addFirst(T value)
     }
 
     size++;
+    notifyInserted(nullptr, newNode);
 }
 
 template<typename T>
 void LinkedList<T>::addLast(T value)
 {
+    makeRoom(nullptr);
+
     if (size == 0) {
-        ListNode<T>* newNode{ new  ListNode<T>() };
-        newNode->value = value;
+        ListNode<T>* newNode{ createNode(value) };
         first = newNode;
         last = newNode;
         size++;
-
+        notifyInserted(nullptr, newNode);
     }
     else {
-        ListNode<T>* newNode{ new ListNode<T>() };
-        newNode->value = value;
+        ListNode<T>* newNode{ createNode(value) };
+        ListNode<T>* previous{ last };
 
         last->next = newNode;
         last = newNode;
         size++;
+        notifyInserted(previous, newNode);
+    }
+
+}
 
+template<typename T>
+void LinkedList<T>::addLastRange(const T* values, unsigned int count, ThreadPool& threads)
+{
+    // Inline nodes have to go to the heap all at once, so let addLast() take
+    // care of that before building any heap nodes in bulk.
+    unsigned int added{ 0 };
+    while (added < count && (inlineCount > 0 || size < inlineCapacity))
+    {
+        addLast(values[added]);
+        added++;
     }
 
+    // Node pools aren't thread safe, and short runs aren't worth splitting.
+    unsigned int chunks{ std::min(threads.getThreadCount(), (count - added) / 1024) };
+    if (pooled || chunks <= 1)
+    {
+        for (; added < count; added++)
+        {
+            addLast(values[added]);
+        }
+        return;
+    }
+
+    // Each thread builds its own chain of nodes.
+    struct Chain
+    {
+        ListNode<T>* first;
+        ListNode<T>* last;
+    };
+    std::vector<Chain> chains(chunks, Chain{ nullptr, nullptr });
+    const T* remaining{ values + added };
+    unsigned int remainingCount{ count - added };
+
+    try
+    {
+        threads.run(chunks, [&](unsigned int chunk) {
+            unsigned int begin{ static_cast<unsigned int>(static_cast<unsigned long long>(remainingCount) * chunk / chunks) };
+            unsigned int end{ static_cast<unsigned int>(static_cast<unsigned long long>(remainingCount) * (chunk + 1) / chunks) };
+            Chain& chain{ chains[chunk] };
+
+            for (unsigned int i{ begin }; i < end; i++)
+            {
+                ListNode<T>* newNode{ new ListNode<T>() };
+                newNode->value = remaining[i];
+
+                if (chain.last)
+                {
+                    chain.last->next = newNode;
+                }
+                else
+                {
+                    chain.first = newNode;
+                }
+                chain.last = newNode;
+            }
+        });
+    }
+    catch (...)
+    {
+        // Throw away whatever was built before the failure.
+        for (Chain& chain : chains)
+        {
+            while (chain.first)
+            {
+                ListNode<T>* toDelete{ chain.first };
+                chain.first = toDelete->next;
+                delete toDelete;
+            }
+        }
+        throw;
+    }
+
+    // Stitch the chains together in order.
+    ListNode<T>* previous{ last };
+    for (Chain& chain : chains)
+    {
+        if (last)
+        {
+            last->next = chain.first;
+        }
+        else
+        {
+            first = chain.first;
+        }
+        last = chain.last;
+    }
+    size += remainingCount;
+    notifyInsertedFrom(previous, previous ? previous->next : first);
 }
 
 template<typename T>
@@ -239,8 +618,9 @@ void LinkedList<T>::removeFirst()
     if (size == 0) {
         throw std::out_of_range("Empty list");
     }
+    notifyRemoving(nullptr, first);
     if (size == 1) {
-        delete first;
+        destroyNode(first);
         first = nullptr;
         last = nullptr;
         size--;
@@ -248,11 +628,117 @@ void LinkedList<T>::removeFirst()
     else {
         ListNode<T>* tmpNode{ first };
         first = tmpNode->next;
-        delete tmpNode;
+        destroyNode(tmpNode);
         size--;
     }
 }
 
+template<typename T>
+LinkedList<T> LinkedList<T>::splitAfter(MutableLinkedListIterator<T> position)
+{
+    LinkedList<T> rest{};
+    rest.pooled = pooled;
+    ListNode<T>* previous{ position.current };
+    ListNode<T>* node{ previous ? previous->next : first };
+    if (!node)
+    {
+        return rest;
+    }
+
+    if (inlineCount > 0 || pool.getLiveCount() > 0)
+    {
+        // The nodes live in storage this list owns, so copy them over and free them here.
+        while (node)
+        {
+            ListNode<T>* next{ node->next };
+            // Observers look at the value, so tell them before it is moved out.
+            notifyRemoving(previous, node);
+            rest.addLast(std::move(node->value));
+            destroyNode(node);
+            size--;
+            node = next;
+        }
+    }
+    else
+    {
+        // Every node from node onwards leaves, as if removed one by one after previous.
+        for (ListNode<T>* moved{ node }; moved; moved = moved->next)
+        {
+            notifyRemoving(previous, moved);
+            if (moved == compactCursor)
+            {
+                compactCursor = nullptr;
+            }
+            rest.size++;
+        }
+
+        rest.first = node;
+        rest.last = last;
+        size -= rest.size;
+        invalidations++;
+    }
+
+    if (previous)
+    {
+        previous->next = nullptr;
+    }
+    else
+    {
+        first = nullptr;
+    }
+    last = previous;
+    return rest;
+}
+
+template<typename T>
+void LinkedList<T>::append(LinkedList<T>&& other)
+{
+    if (&other == this || other.size == 0)
+    {
+        return;
+    }
+
+    if (other.inlineCount > 0 || other.pool.getLiveCount() > 0)
+    {
+        // Other's nodes belong to its storage, so copy them.
+        for (ListNode<T>* node{ other.first }; node; node = node->next)
+        {
+            addLast(std::move(node->value));
+        }
+        other.clear();
+        return;
+    }
+
+    if (inlineCount > 0)
+    {
+        // At most inlineCapacity nodes have to move before the heap chains can be linked.
+        moveToHeap(nullptr);
+    }
+
+    for (ListObserver<T>* observer : other.observers)
+    {
+        observer->clearing();
+    }
+
+    ListNode<T>* previous{ last };
+    if (last)
+    {
+        last->next = other.first;
+    }
+    else
+    {
+        first = other.first;
+    }
+    last = other.last;
+    size += other.size;
+    other.first = nullptr;
+    other.last = nullptr;
+    other.size = 0;
+    other.compactCursor = nullptr;
+    other.invalidations++;
+    notifyInsertedFrom(previous, previous ? previous->next : first);
+}
+
 template <typename T>
 T const& LinkedList<T>::getFirst() const
 {
@@ -311,6 +797,331 @@ unsigned int LinkedList<T>::getSize() const
     return size;
 }
 
+template<typename T>
+std::uint64_t LinkedList<T>::getInvalidations() const
+{
+    return invalidations;
+}
+
+template<typename T>
+bool LinkedList<T>::isInline() const
+{
+    return inlineCount > 0 || size == 0;
+}
+
+template<typename T>
+bool LinkedList<T>::inlineContains(const T& value) const
+{
+#ifdef LINKEDLIST_SSE2
+    if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 4
+        && sizeof(ListNode<T>) == 16 && inlineCapacity == 8)
+    {
+        // Each node is 16 bytes with its value at the start, so gather the first
+        // 4 bytes of all 8 slots into two vectors and compare them in one go.
+        const __m128i* slots{ reinterpret_cast<const __m128i*>(inlineStorage.nodes()) };
+        __m128i low{ _mm_unpacklo_epi64(
+            _mm_unpacklo_epi32(_mm_loadu_si128(slots), _mm_loadu_si128(slots + 1)),
+            _mm_unpacklo_epi32(_mm_loadu_si128(slots + 2), _mm_loadu_si128(slots + 3))) };
+        __m128i high{ _mm_unpacklo_epi64(
+            _mm_unpacklo_epi32(_mm_loadu_si128(slots + 4), _mm_loadu_si128(slots + 5)),
+            _mm_unpacklo_epi32(_mm_loadu_si128(slots + 6), _mm_loadu_si128(slots + 7))) };
+
+        // Values narrower than 4 bytes are followed by padding, so mask it off.
+        using Unsigned = typename std::make_unsigned<T>::type;
+        const std::uint32_t mask{ static_cast<std::uint32_t>(static_cast<Unsigned>(~Unsigned{ 0 })) };
+        const __m128i masks{ _mm_set1_epi32(static_cast<int>(mask)) };
+        const __m128i key{ _mm_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(static_cast<Unsigned>(value)))) };
+
+        unsigned int hits{ static_cast<unsigned int>(
+            _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(low, masks), key)))
+            | _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(high, masks), key))) << 4) };
+
+        // Ignore matches in empty slots.
+        return (hits & inlineUsed) != 0;
+    }
+#endif
+
+    const ListNode<T>* slots{ inlineStorage.nodes() };
+    for (unsigned int i{ 0 }; i < inlineCapacity; i++)
+    {
+        if ((inlineUsed & (1u << i)) && slots[i].value == value)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename T>
+bool LinkedList<T>::compact(unsigned int maxNodes)
+{
+    if (inlineCount > 0)
+    {
+        // Inline nodes are already packed together.
+        return true;
+    }
+
+    // Resume after the last node relocated by the previous call.
+    ListNode<T>* previous{ compactCursor };
+    ListNode<T>* node{ previous ? previous->next : first };
+
+    for (unsigned int visited{ 0 }; node && visited < maxNodes; visited++)
+    {
+        // Leave nodes that are already in place (e.g. from an earlier pass).
+        if (previous ? pool.follows(previous, node) : pool.owns(node))
+        {
+            previous = node;
+            node = node->next;
+            continue;
+        }
+
+        // Move the value into the next slot of the pool so that the
+        // relocated nodes end up side by side in iteration order.
+        ListNode<T>* relocated{ new (pool.allocateSequential()) ListNode<T>{ std::move(node->value), node->next } };
+
+        // Splice the new node in place of the old one.
+        if (previous)
+        {
+            previous->next = relocated;
+        }
+        else
+        {
+            first = relocated;
+        }
+
+        if (last == node)
+        {
+            last = relocated;
+        }
+
+        destroyNode(node);
+        notifyRelocated(relocated);
+
+        previous = relocated;
+        node = relocated->next;
+    }
+
+    // Remember where to pick up next time, or start over once the pass is done.
+    compactCursor = node ? previous : nullptr;
+    return node == nullptr;
+}
+
+template<typename T>
+ListNode<T>* LinkedList<T>::createNode(const T& value)
+{
+    ListNode<T>* newNode{ nullptr };
+
+    if (inlineCount == size && inlineCount < inlineCapacity)
+    {
+        // Use the first free inline slot.
+        unsigned int i{ 0 };
+        while (inlineUsed & (1u << i))
+        {
+            i++;
+        }
+
+        newNode = new (inlineSlot(i)) ListNode<T>();
+        inlineUsed |= 1u << i;
+        inlineCount++;
+    }
+    else if (pooled)
+    {
+        newNode = new (pool.allocate()) ListNode<T>();
+    }
+    else
+    {
+        newNode = new ListNode<T>();
+    }
+
+    newNode->value = value;
+    return newNode;
+}
+
+template<typename T>
+void LinkedList<T>::destroyNode(ListNode<T>* node)
+{
+    invalidations++;
+    if (node == compactCursor)
+    {
+        // Lost our place; the next compact() call starts a new pass.
+        compactCursor = nullptr;
+    }
+
+    if (isInlineNode(node))
+    {
+        // Free the inline slot.
+        node->~ListNode<T>();
+        inlineUsed &= ~(1u << static_cast<unsigned int>(node - inlineSlot(0)));
+        inlineCount--;
+    }
+    else if (pool.owns(node))
+    {
+        // Compacted nodes live in the pool's blocks rather than on their own.
+        node->~ListNode<T>();
+        pool.release(node);
+    }
+    else
+    {
+        delete node;
+    }
+}
+
+template<typename T>
+bool LinkedList<T>::isFullyPooled() const
+{
+    return size > 0 && pool.getLiveCount() == size;
+}
+
+template<typename T>
+ListNode<T>* LinkedList<T>::makeRoom(ListNode<T>* position)
+{
+    if (inlineCount == 0 || inlineCount < inlineCapacity)
+    {
+        // Already on the heap, or there is still a free inline slot.
+        return position;
+    }
+
+    // The inline storage is full.
+    return moveToHeap(position);
+}
+
+template<typename T>
+ListNode<T>* LinkedList<T>::moveToHeap(ListNode<T>* position)
+{
+    ListNode<T>* previous{ nullptr };
+    ListNode<T>* node{ first };
+    while (node)
+    {
+        ListNode<T>* next{ node->next };
+        ListNode<T>* moved{ pooled ? new (pool.allocate()) ListNode<T>() : new ListNode<T>() };
+        moved->value = std::move(node->value);
+
+        if (previous)
+        {
+            previous->next = moved;
+        }
+        else
+        {
+            first = moved;
+        }
+
+        if (node == position)
+        {
+            position = moved;
+        }
+
+        node->~ListNode<T>();
+        previous = moved;
+        node = next;
+    }
+
+    last = previous;
+    inlineUsed = 0;
+    inlineCount = 0;
+    invalidations++;
+
+    for (ListNode<T>* moved{ first }; moved && !observers.empty(); moved = moved->next)
+    {
+        notifyRelocated(moved);
+    }
+
+    return position;
+}
+
+template<typename T>
+void LinkedList<T>::takeInlineNodes(LinkedList<T>& original)
+{
+    // Pack the nodes into the first slots, in list order.
+    unsigned int i{ 0 };
+    ListNode<T>* previous{ nullptr };
+    for (ListNode<T>* node{ original.first }; node; node = node->next, i++)
+    {
+        ListNode<T>* moved{ new (inlineSlot(i)) ListNode<T>() };
+        moved->value = std::move(node->value);
+
+        if (previous)
+        {
+            previous->next = moved;
+        }
+        else
+        {
+            first = moved;
+        }
+
+        previous = moved;
+    }
+
+    // Now that the values have been moved out, the original's nodes can go.
+    original.clear();
+
+    last = previous;
+    size = i;
+    inlineUsed = (1u << i) - 1;
+    inlineCount = i;
+}
+
+template<typename T>
+ListNode<T>* LinkedList<T>::inlineSlot(unsigned int i)
+{
+    return inlineStorage.nodes() + i;
+}
+
+template<typename T>
+void LinkedList<T>::notifyInserted(const ListNode<T>* previous, const ListNode<T>* node)
+{
+    for (ListObserver<T>* observer : observers)
+    {
+        observer->inserted(previous, node);
+    }
+}
+
+template<typename T>
+void LinkedList<T>::notifyInsertedFrom(const ListNode<T>* previous, const ListNode<T>* node)
+{
+    if (observers.empty())
+    {
+        return;
+    }
+
+    for (; node; previous = node, node = node->next)
+    {
+        notifyInserted(previous, node);
+    }
+}
+
+template<typename T>
+void LinkedList<T>::notifyRemoving(const ListNode<T>* previous, const ListNode<T>* node)
+{
+    for (ListObserver<T>* observer : observers)
+    {
+        observer->removing(previous, node);
+    }
+}
+
+template<typename T>
+void LinkedList<T>::notifyRelocated(const ListNode<T>* node)
+{
+    for (ListObserver<T>* observer : observers)
+    {
+        observer->relocated(node);
+    }
+}
+
+template<typename T>
+bool LinkedList<T>::isInlineNode(const ListNode<T>* node) const
+{
+    if constexpr (inlineCapacity == 0)
+    {
+        return false;
+    }
+    else
+    {
+        std::less<const ListNode<T>*> before{};
+        return !before(node, inlineStorage.nodes()) && before(node, inlineStorage.nodes() + inlineCapacity);
+    }
+}
+
 template <typename T>
 std::ostream& operator << (
     std::ostream& os, const LinkedList<T>& list)
@@ -370,3 +1181,5 @@ MutableLinkedListIterator<T> LinkedList<T>::end()
 {
     return MutableLinkedListIterator<T>{nullptr, * this};
 }
+
+#include "LinkedSet.h"
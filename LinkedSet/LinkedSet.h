@@ -1,161 +1,1195 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "AdaptiveList.h"
+#include "BPlusTree.h"
+#include "CountingBloomFilter.h"
+#include "FrozenSet.h"
+#include "HashMix.h"
+#include "HashIndex.h"
 #include "LinkedList.h"
+#include "ParallelSort.h"
+#include "RangeAggregates.h"
+#include "ReservoirSample.h"
+#include "SplitPoints.h"
+#include "ThreadPool.h"
 
 template <typename T>
+class DoublyLinkedList;
+
+// What a change in a batch does to its item (see LinkedSet::apply).
+enum class SetOperation
+{
+	Add,
+	Remove
+};
+
+// An ordered set stored in a sorted linked list.
+// List selects the list implementation: LinkedList<T> by default, or any
+// list with the same interface (e.g. IndexedLinkedList<T> or DoublyLinkedList<T>).
+// With BPlusTree<T> items are found by searching the tree rather than walking it,
+// and likewise with AdaptiveList<T>, which picks its own representation.
+template <typename T, typename List = LinkedList<T>>
 class LinkedSet
 {
 public:
+	// Default constructor
+	LinkedSet() = default;
+
+	// Construct a set holding every distinct item of an unsorted vector.
+	// The items are sorted and deduplicated on pool's threads and the nodes
+	// built in bulk, giving the same set as adding the items one by one.
+	explicit LinkedSet(std::vector<T> items, ThreadPool& pool = ThreadPool::shared());
+
+	// Copy constructor; the copy has no filter or index.
+	LinkedSet(const LinkedSet<T, List>& original);
+
+	// Copy assignment op; keeps this set's filter and index, which are updated to the new contents.
+	LinkedSet<T, List>& operator= (const LinkedSet<T, List>& original);
+
+	// Move constructor; the new set has no filter or index.
+	LinkedSet(LinkedSet<T, List>&& original);
+
+	// Move assignment op; keeps this set's filter and index, which are updated to the new contents.
+	LinkedSet<T, List>& operator= (LinkedSet<T, List>&& original);
+
 	// Checks if the set contains a particular item.
 	// Returns true if the item is found; false otherwise.
+	// Searches start from where the last add or remove stopped when the item
+	// comes after it. Lookups don't move that position themselves, so const
+	// sets can be searched from several threads at once.
 	bool contains(const T& item) const;
 
+	// Checks if the set contains an item, searching from hint if it comes
+	// before the item, and leaves hint at the last item smaller than it (or at
+	// end() if there is none). Passing the same hint to each lookup in a run of
+	// ascending items makes each one amortized O(1), with no state shared
+	// between callers. Trees search in O(log n) and leave hint alone.
+	bool contains(typename List::const_iterator& hint, const T& item) const;
+
 	// Add an item to the set if it doesn't already exist.
 	// Return true if an item was added; false otherwise.
+	// While writes are buffered, the item is only queued and true is returned.
 	bool add(const T& item);
 
+	// Add an item to the set if it doesn't already exist, searching from hint
+	// if it comes before the item (e.g. the result of the previous call when
+	// adding in ascending order), or as add(item) would otherwise.
+	// Returns an iterator to the item. Buffered writes are merged first.
+	typename List::iterator add(typename List::iterator hint, const T& item);
+
 	// Remove an item from the set.
 	// Return true if an item was removed; false otherwise.
+	// While writes are buffered, the removal is only queued and true is returned.
 	bool remove(const T& item);
 
+	// Buffer adds and removes in an unsorted log instead of applying them
+	// one by one; the log is merged into the list in a single pass once it
+	// holds threshold changes, or before anything reads the list.
+	// contains() checks the log, so it stays exact without merging.
+	// Pass 0 to merge what is buffered and go back to applying changes directly.
+	void setWriteBuffer(unsigned int threshold);
+
+	// Merge any buffered changes into the list.
+	void flush() const;
+
+	// Check a membership filter before searching the list, so that most
+	// contains() calls for missing items return without touching a node.
+	// The filter is filled with the current items and then kept up to date
+	// by the list itself (see ListObserver); pass nullptr to detach it.
+	// Only supported by LinkedList; the filter must outlive the set.
+	void setFilter(CountingBloomFilter<T>* filter);
+
+	// Look items up in a hash index instead of searching the list, making
+	// contains() and remove() O(1); add() still walks the list to find where
+	// the item goes. Like a filter, the index is filled with the current items
+	// and then kept up to date by the list; pass nullptr to detach it.
+	// Only supported by LinkedList; the index must outlive the set.
+	void setIndex(HashIndex<T>* index);
+
+	// What apply() did with a batch of changes.
+	struct BatchResult
+	{
+		// For each change, in batch order: true if it changed the set.
+		std::vector<bool> applied;
+
+		// Number of changes that changed the set.
+		unsigned int count;
+	};
+
+	// Add and remove a batch of items in a single walk over the list.
+	// The batch doesn't have to be sorted; changes to the same item are
+	// made in the order they appear, just as with separate add()/remove() calls.
+	BatchResult apply(const std::vector<std::pair<T, SetOperation>>& batch);
+
+	// Remove the item an iterator points at in O(1); needs a list that
+	// supports erase (e.g. DoublyLinkedList<T>).
+	// Returns an iterator to the item after it.
+	typename List::iterator erase(typename List::iterator position);
+
 	// Remove all items from the set.
 	void clear();
 
+	// Get the smallest item.
+	// Throws std::out_of_range if the set is empty.
+	T getFirst() const;
+
+	// Get the largest item.
+	// Throws std::out_of_range if the set is empty.
+	T getLast() const;
+
+	// Remove the smallest item in O(1).
+	// Throws std::out_of_range if the set is empty.
+	void removeFirst();
+
+	// Remove the largest item. With DoublyLinkedList<T> this takes O(1) and
+	// with BPlusTree<T> O(log n); otherwise the item before it is searched for
+	// as by remove(), from the finger if that is before it.
+	// Throws std::out_of_range if the set is empty.
+	void removeLast();
+
+	// Move every item that isn't smaller than key to a new set, which is returned.
+	// LinkedList<T> and DoublyLinkedList<T> cut their chain of nodes where key
+	// goes instead of copying what comes after, and BPlusTree<T> cuts the path
+	// to key in O(log n); other lists move the items one by one.
+	// The new set has no filter or index.
+	LinkedSet<T, List> splitAt(const T& key);
+
+	// Move every item of other into this set, leaving other empty.
+	// When all of other's items are bigger than this set's, LinkedList<T> and
+	// DoublyLinkedList<T> link other's nodes on in O(1) and BPlusTree<T> joins
+	// the trees in O(log n); otherwise other's items are merged in a single walk.
+	void join(LinkedSet<T, List>&& other);
+
+	// Copy the set into an immutable FrozenSet, which answers contains() with
+	// a cache-friendly binary search; FrozenSet::thaw() turns it back into a LinkedSet.
+	FrozenSet<T> freeze() const;
+
+	// Allocate the set's nodes from contiguous blocks (see LinkedList::setPooledStorage).
+	void setPooledStorage(bool pooled);
+
+	// Free the set's nodes through a reclaimer (see LinkedList::setReclaimer).
+	void setReclaimer(NodeReclaimer<T>* reclaimer);
+
 	// Get the number of elements in the set.
 	unsigned int getSize() const;
 
+	// Move up to maxNodes elements into contiguous memory so that iterating
+	// the set is cache friendly again; call repeatedly to spread out the work.
+	// Returns true once the whole set has been compacted.
+	bool compact(unsigned int maxNodes = std::numeric_limits<unsigned int>::max());
+
 	// Create an iterator that starts at the beginning of the set.
-	ConstLinkedListIterator<T> begin() const;
+	typename List::const_iterator begin() const;
 
 	// Create an iterator that has reached the end of the set.
-	ConstLinkedListIterator<T> end() const;
+	typename List::const_iterator end() const;
 
 	// Create an iterator that starts at the beginning of the set.
-	MutableLinkedListIterator<T> begin();
+	typename List::iterator begin();
 
 	// Create an iterator that has reached the end of the set.
-	MutableLinkedListIterator<T> end();
+	typename List::iterator end();
+
+	// Create a reverse iterator that starts at the largest item in the set;
+	// needs a list that can be walked backwards (e.g. DoublyLinkedList<T>).
+	auto rbegin() const;
+
+	// Create a reverse iterator that has reached the start of the set.
+	auto rend() const;
 
-	template <typename T2>
-	friend std::ostream& operator << (std::ostream& out, const LinkedSet<T2>& orderedList);
+	// Call f on every item in [low, high), in order.
+	// With BPlusTree<T> this is a search followed by a scan of the leaf arrays.
+	template <typename Function>
+	void forEachInRange(const T& low, const T& high, Function f) const;
+
+	// Count the items in [low, high).
+	// With BPlusTree<T> this takes O(log n); otherwise the range is walked.
+	unsigned int countInRange(const T& low, const T& high) const;
+
+	// Count the items smaller than item, i.e. the position item has or would have.
+	// With BPlusTree<T> this takes O(log n); otherwise the list is walked.
+	unsigned int rank(const T& item) const;
+
+	// Get the item at position k (the (k + 1)th smallest).
+	// With BPlusTree<T> this takes O(log n); otherwise the list is walked.
+	// Throws std::out_of_range if there are only k items or fewer.
+	T select(unsigned int k) const;
+
+	// Get the item at position k, as select(k).
+	T operator[] (unsigned int k) const;
+
+	// Combine Aggregate (see RangeAggregates.h) over the items in [low, high).
+	// With BPlusTree<T, Aggregate> this takes O(log n); otherwise the range is walked.
+	template <typename Aggregate>
+	typename Aggregate::Value aggregate(const T& low, const T& high) const;
+
+	// Pick k distinct items uniformly at random (every item if there are only
+	// k or fewer), returned in ascending order. random is a random bit
+	// generator such as std::mt19937.
+	// With BPlusTree<T> this draws k positions and selects each, in O(k log n);
+	// otherwise the list is walked once, keeping a reservoir of k items.
+	template <typename Random>
+	std::vector<T> sample(unsigned int k, Random& random) const;
+
+	// Call f on every item, spreading the work across pool's threads.
+	// f may be called from several threads at once, in no particular order.
+	template <typename Function>
+	void parallelForEach(Function f, ThreadPool& pool = ThreadPool::shared()) const;
+
+	// Combine init and every item with op, spreading the work across pool's threads.
+	// op must be associative; items are combined in order within each thread's share.
+	template <typename Result, typename BinaryOp>
+	Result parallelReduce(Result init, BinaryOp op, ThreadPool& pool = ThreadPool::shared()) const;
+
+	// Count the items that satisfy predicate, spreading the work across pool's threads.
+	template <typename Predicate>
+	unsigned int parallelCountIf(Predicate predicate, ThreadPool& pool = ThreadPool::shared()) const;
+
+	template <typename T2, typename List2>
+	friend std::ostream& operator << (std::ostream& out, const LinkedSet<T2, List2>& orderedList);
 
 private:
+	// Cut the set into segments of nearly equal length and call
+	// visit(segment, first, last) for each one on pool's threads.
+	// Returns the number of segments.
+	template <typename Visit>
+	unsigned int forEachSegment(ThreadPool& pool, Visit visit) const;
+
+	// Put the finger at i, stamped with the list's invalidation count.
+	void moveFinger(typename List::iterator i);
+
+	// Check if there is a finger and the list hasn't freed or moved any
+	// nodes since it was put down (e.g. through an iterator handed out).
+	bool hasFinger() const;
+
+	// Find the last item smaller than item, starting from the finger if it is
+	// smaller too. The finger is only read, so changes have to move it themselves.
+	// Returns end() if there is none, i.e. item belongs at the front.
+	typename List::iterator findPrevious(const T& item) const;
+
+	// Add an item if it isn't there yet, searching from the finger.
+	// Returns where the item is and whether it was added.
+	std::pair<typename List::iterator, bool> insert(const T& item);
+
+	// Make a batch of changes in one walk over the list, taking them in the
+	// given order (sorted by item). Sets applied[j] if change j changed the set.
+	// Returns the number of changes that did.
+	unsigned int applyInOrder(const std::vector<std::pair<T, SetOperation>>& changes,
+		const std::vector<std::size_t>& order, std::vector<bool>& applied) const;
+
+	// Get the positions of a batch's changes sorted by item, keeping changes
+	// to the same item in batch order.
+	static std::vector<std::size_t> sortedOrder(const std::vector<std::pair<T, SetOperation>>& changes);
+
 	// The underlying linked list.
-	LinkedList<T> list;
+	// (Reads merge buffered changes into it, so even const methods can change it;
+	// they go through std::as_const otherwise.)
+	mutable List list;
+
+	// Buffered changes, oldest first; removes are tombstones.
+	mutable std::vector<std::pair<T, SetOperation>> log;
+
+	// Number of buffered changes that triggers a merge; 0 if writes aren't buffered.
+	unsigned int bufferThreshold{ 0 };
+
+	// Filter consulted by contains(), if any.
+	CountingBloomFilter<T>* filter{ nullptr };
+
+	// Index used by contains() and remove(), if any.
+	HashIndex<T>* index{ nullptr };
+
+	// Where the last add or remove stopped, so the next search can resume there
+	// if its item is bigger; dropped whenever its node may have gone away.
+	// Only changes move it, so const lookups can run concurrently.
+	mutable std::optional<typename List::iterator> finger;
+
+	// The list's invalidation count when the finger was put down; the finger
+	// is only used while the count hasn't moved on.
+	std::uint64_t fingerStamp{ 0 };
+
+	// Where to cut the list for parallel traversal; dropped whenever the set
+	// changes or a mutable iterator is handed out, and found again if the
+	// list has freed nodes since (e.g. through such an iterator).
+	mutable SplitPoints<typename List::const_iterator> splitPoints;
+
+	// Sets smaller than this are never split, since waking threads would cost more.
+	static constexpr unsigned int minParallelSize{ 4096 };
 };
 
-template<typename T>
-bool LinkedSet<T>::contains(const T& item) const
+template<typename T, typename List>
+LinkedSet<T, List>::LinkedSet(std::vector<T> items, ThreadPool& pool)
 {
-	//loop to traverse list
-	for (ConstLinkedListIterator<T> i{ list.begin() }; i != list.end(); i++) {
-		//if the item matches the element at certain point return true
-		if (*i == item) {
-			return true;
+	parallelSortUnique(items, pool);
+
+	//the items are already in order, so they can go straight on the end of the list
+	if constexpr (std::is_same<List, LinkedList<T>>::value) {
+		list.addLastRange(items.data(), static_cast<unsigned int>(items.size()), pool);
+	}
+	else {
+		for (const T& item : items) {
+			list.addLast(item);
 		}
 	}
-	return false;
 }
 
-template<typename T>
-bool LinkedSet<T>::add(const T& item)
+template<typename T, typename List>
+LinkedSet<T, List>::LinkedSet(const LinkedSet<T, List>& original)
+	: list{ original.list }, log{ original.log }, bufferThreshold{ original.bufferThreshold }
 {
-	//check to see if item passed in is in the list and add it if it isnt
-	if (!(this->contains(item))) {
+}
 
-		//make sure the list isnt empty and add the item if it is.
-		if (list.getSize() == 0) {
-			list.addFirst(item);
-			return true;
+template<typename T, typename List>
+LinkedSet<T, List>& LinkedSet<T, List>::operator= (const LinkedSet<T, List>& original)
+{
+	if (this != &original) {
+		splitPoints.invalidate();
+		finger.reset();
+		list = original.list;
+		log = original.log;
+		bufferThreshold = original.bufferThreshold;
+	}
+	return *this;
+}
+
+template<typename T, typename List>
+LinkedSet<T, List>::LinkedSet(LinkedSet<T, List>&& original)
+	: list{ std::move(original.list) }, log{ std::move(original.log) }, bufferThreshold{ original.bufferThreshold }
+{
+	//the original's finger and split points now point into this set's nodes
+	original.log.clear();
+	original.finger.reset();
+	original.splitPoints.invalidate();
+}
+
+template<typename T, typename List>
+LinkedSet<T, List>& LinkedSet<T, List>::operator= (LinkedSet<T, List>&& original)
+{
+	if (this != &original) {
+		splitPoints.invalidate();
+		finger.reset();
+		list = std::move(original.list);
+		log = std::move(original.log);
+		bufferThreshold = original.bufferThreshold;
+		original.log.clear();
+		original.finger.reset();
+		original.splitPoints.invalidate();
+	}
+	return *this;
+}
+
+template<typename T, typename List>
+bool LinkedSet<T, List>::contains(const T& item) const
+{
+	//the newest buffered change to the item decides, if there is one
+	for (auto change{ log.rbegin() }; change != log.rend(); change++) {
+		if (change->first == item) {
+			return change->second == SetOperation::Add;
 		}
+	}
 
-		//case where item being added is the smallest in the list
-		if (list.getFirst() > item) {
-			list.addFirst(item);
+	//(only items std::hash can hash can have a filter or index, so the rest skip them at compile time)
+	if constexpr (IsHashable<T>::value) {
+		//the index knows exactly which items are in the list
+		if (index) {
+			return index->contains(item);
+		}
+
+		//most missing items can be turned away by the filter
+		if (filter && !filter->mightContain(item)) {
+			return false;
+		}
+	}
+
+	//small sets keep their nodes inline, so they can be searched without following links
+	if constexpr (std::is_same<List, LinkedList<T>>::value) {
+		if (list.isInline()) {
+			return list.inlineContains(item);
+		}
+	}
+
+	//the list is sorted, so the item can only be right after the last smaller one
+	typename List::iterator i{ findPrevious(item) };
+	if (i == list.end()) {
+		return list.getSize() > 0 && list.getFirst() == item;
+	}
+	return i.hasNext() && i.peekNext() == item;
+}
+
+template<typename T, typename List>
+bool LinkedSet<T, List>::contains(typename List::const_iterator& hint, const T& item) const
+{
+	//buffered changes, indexes and trees all answer without walking the list
+	if constexpr (IsBPlusTree<List>::value || std::is_same<List, AdaptiveList<T>>::value) {
+		return contains(item);
+	}
+	else {
+		if (!log.empty() || index) {
+			return contains(item);
+		}
+
+		typename List::const_iterator end{ std::as_const(list).end() };
+		typename List::const_iterator i{ hint != end && item > *hint ? hint : std::as_const(list).begin() };
+		if (i == end || !(item > *i)) {
+			hint = end;
+			return i != end && *i == item;
+		}
+
+		//the item can only be right after the last smaller one
+		typename List::const_iterator next{ i };
+		for (++next; next != end && item > *next; ++next) {
+			i = next;
+		}
+		hint = i;
+		return next != end && *next == item;
+	}
+}
+
+template<typename T, typename List>
+bool LinkedSet<T, List>::add(const T& item)
+{
+	//queue the item instead if writes are buffered
+	if (bufferThreshold > 0) {
+		log.emplace_back(item, SetOperation::Add);
+		if (log.size() >= bufferThreshold) {
+			flush();
+		}
+		return true;
+	}
+
+	//the index can tell straight away if the item is already there
+	if constexpr (IsHashable<T>::value) {
+		if (index && index->contains(item)) {
+			return false;
+		}
+	}
+
+	return insert(item).second;
+}
+
+template<typename T, typename List>
+typename List::iterator LinkedSet<T, List>::add(typename List::iterator hint, const T& item)
+{
+	flush();
+
+	//a hint before the item is as good a place to start as the finger
+	if (hint != list.end() && item > *hint) {
+		moveFinger(hint);
+	}
+
+	return insert(item).first;
+}
+
+template<typename T, typename List>
+std::pair<typename List::iterator, bool> LinkedSet<T, List>::insert(const T& item)
+{
+	typename List::iterator i{ findPrevious(item) };
+
+	//no smaller item, so the item is either first already or goes at the front
+	if (i == list.end()) {
+		if (list.getSize() > 0 && list.getFirst() == item) {
+			return { list.begin(), false };
+		}
+
+		splitPoints.invalidate();
+		list.addFirst(item);
+		moveFinger(list.begin());
+		return { list.begin(), true };
+	}
+
+	if (i.hasNext() && i.peekNext() == item) {
+		moveFinger(i);
+		return { ++i, false };
+	}
+
+	//the finger moves onto the new item, ready for the next bigger one
+	splitPoints.invalidate();
+	i.addNext(item);
+	moveFinger(++i);
+	return { i, true };
+}
+
+	template<typename T, typename List>
+	bool LinkedSet<T, List>::remove(const T & item)
+	{
+		//queue a tombstone instead if writes are buffered
+		if (bufferThreshold > 0) {
+			log.emplace_back(item, SetOperation::Remove);
+			if (log.size() >= bufferThreshold) {
+				flush();
+			}
 			return true;
 		}
 
-		//loop to traverse the rest of the list
-		for (MutableLinkedListIterator<T> i{ list.begin() }; i != list.end(); i++) {
-			//check to see if iterator is at the end of the list
-			if (i.hasNext()) {
-				//next item is bigger so item is inserted after current
-				if (i.peekNext() > item) {
-					i.addNext(item);
-					return true;
+		//the index says which node comes before the item, so it can be unlinked straight away
+		if constexpr (std::is_same<List, LinkedList<T>>::value && IsHashable<T>::value) {
+			if (index) {
+				std::optional<const ListNode<T>*> previous{ index->findPrevious(item) };
+				if (!previous) {
+					return false;
+				}
+
+				splitPoints.invalidate();
+				bool keepFinger{ hasFinger() && !(**finger == item) };
+				if (*previous) {
+					typename List::iterator{ const_cast<ListNode<T>*>(*previous), list }.removeNext();
+				}
+				else {
+					list.removeFirst();
+				}
+				//only the item's own node was freed, so a finger elsewhere is still good
+				if (keepFinger) {
+					moveFinger(*finger);
 				}
+				return true;
 			}
-			//iterator is at end of list
-			else {
-				i.addNext(item);
+		}
+
+		//search for the item, keeping the finger before it so it stays valid
+		typename List::iterator i{ findPrevious(item) };
+		if (i == list.end()) {
+			if (list.getSize() > 0 && list.getFirst() == item) {
+				splitPoints.invalidate();
+				finger.reset();
+				this->list.removeFirst();
 				return true;
 			}
+			return false;
 		}
-	}
-	//item was found in list
-	else {
+
+		if (i.hasNext() && i.peekNext() == item) {
+			splitPoints.invalidate();
+			i.removeNext();
+			//i stays valid through the remove, but with some lists a copy of it may not
+			moveFinger(i);
+			return true;
+		}
+		moveFinger(i);
 		return false;
 	}
-}
 
-	template<typename T>
-	bool LinkedSet<T>::remove(const T & item)
+	template<typename T, typename List>
+	void LinkedSet<T, List>::setWriteBuffer(unsigned int threshold)
 	{
-		//for loop to traverse list
-		for (MutableLinkedListIterator<T> i{ list.begin() }; i != list.end(); i++) {
-			//if item macthes first element remove first and return true
-			if (*i == item && *i == this->list.getFirst()) {
-				this->list.removeFirst();
-				return true;
+		bufferThreshold = threshold;
+		if (threshold == 0) {
+			flush();
+		}
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::flush() const
+	{
+		if (log.empty()) {
+			return;
+		}
+
+		//changes to the same item stay in the order they were made, so the newest one wins
+		std::vector<bool> applied(log.size());
+		applyInOrder(log, sortedOrder(log), applied);
+		log.clear();
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::setFilter(CountingBloomFilter<T>* filter)
+	{
+		if (this->filter) {
+			list.removeObserver(this->filter);
+		}
+
+		this->filter = filter;
+		if (filter) {
+			//the list tells the filter about the current items, and keeps it up to date from then on
+			flush();
+			filter->clear();
+			list.addObserver(filter);
+		}
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::setIndex(HashIndex<T>* index)
+	{
+		if (this->index) {
+			list.removeObserver(this->index);
+		}
+
+		this->index = index;
+		if (index) {
+			flush();
+			index->clear();
+			list.addObserver(index);
+		}
+	}
+
+	template<typename T, typename List>
+	typename LinkedSet<T, List>::BatchResult LinkedSet<T, List>::apply(const std::vector<std::pair<T, SetOperation>>& batch)
+	{
+		flush();
+
+		BatchResult result{ std::vector<bool>(batch.size()), 0 };
+		result.count = applyInOrder(batch, sortedOrder(batch), result.applied);
+		return result;
+	}
+
+	template<typename T, typename List>
+	unsigned int LinkedSet<T, List>::applyInOrder(const std::vector<std::pair<T, SetOperation>>& changes,
+		const std::vector<std::size_t>& order, std::vector<bool>& applied) const
+	{
+		if (order.empty()) {
+			return 0;
+		}
+		splitPoints.invalidate();
+		finger.reset();
+
+		unsigned int count{ 0 };
+
+		//changes that come before (or at) the first item are made at the front of the list
+		std::size_t k{ 0 };
+		for (; k < order.size() && (list.getSize() == 0 || !(changes[order[k]].first > list.getFirst())); k++) {
+			const std::pair<T, SetOperation>& change{ changes[order[k]] };
+			bool found{ list.getSize() > 0 && list.getFirst() == change.first };
+
+			if (found && change.second == SetOperation::Remove) {
+				list.removeFirst();
+				applied[order[k]] = true;
+				count++;
+			}
+			else if (!found && change.second == SetOperation::Add) {
+				list.addFirst(change.first);
+				applied[order[k]] = true;
+				count++;
 			}
-			//check if there is an element after current and remove it if it equals item
-			if (i.hasNext() && i.peekNext() == item) {
+		}
+
+		//the rest are made with a single walk, always stopping just before the item
+		typename List::iterator i{ list.begin() };
+		for (; k < order.size(); k++) {
+			const std::pair<T, SetOperation>& change{ changes[order[k]] };
+			while (i.hasNext() && change.first > i.peekNext()) {
+				i++;
+			}
+			bool found{ i.hasNext() && i.peekNext() == change.first };
+
+			if (found && change.second == SetOperation::Remove) {
 				i.removeNext();
-				return true;
+				applied[order[k]] = true;
+				count++;
+			}
+			else if (!found && change.second == SetOperation::Add) {
+				i.addNext(change.first);
+				applied[order[k]] = true;
+				count++;
 			}
 		}
-		return false;
+
+		return count;
+	}
+
+	template<typename T, typename List>
+	std::vector<std::size_t> LinkedSet<T, List>::sortedOrder(const std::vector<std::pair<T, SetOperation>>& changes)
+	{
+		std::vector<std::size_t> order(changes.size());
+		std::iota(order.begin(), order.end(), std::size_t{ 0 });
+
+		//batches that arrive sorted are left as they are
+		auto before{ [&](std::size_t a, std::size_t b) { return changes[b].first > changes[a].first; } };
+		if (!std::is_sorted(order.begin(), order.end(), before)) {
+			std::stable_sort(order.begin(), order.end(), before);
+		}
+		return order;
+	}
+
+	template<typename T, typename List>
+	typename List::iterator LinkedSet<T, List>::erase(typename List::iterator position)
+	{
+		splitPoints.invalidate();
+		finger.reset();
+		return list.erase(position);
 	}
 
-	template<typename T>
-	void LinkedSet<T>::clear()
+	template<typename T, typename List>
+	void LinkedSet<T, List>::clear()
 	{
+		splitPoints.invalidate();
+		finger.reset();
+		log.clear();
 		list.clear();
 	}
 
-	template<typename T>
-	unsigned int LinkedSet<T>::getSize() const
+	template<typename T, typename List>
+	T LinkedSet<T, List>::getFirst() const
+	{
+		flush();
+		return list.getFirst();
+	}
+
+	template<typename T, typename List>
+	T LinkedSet<T, List>::getLast() const
+	{
+		flush();
+		return list.getLast();
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::removeFirst()
 	{
+		flush();
+		splitPoints.invalidate();
+		finger.reset();
+		list.removeFirst();
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::removeLast()
+	{
+		flush();
+		splitPoints.invalidate();
+		if constexpr (IsBPlusTree<List>::value || std::is_same<List, DoublyLinkedList<T>>::value) {
+			finger.reset();
+			list.removeLast();
+		}
+		else {
+			if (list.getSize() == 0) {
+				throw std::out_of_range("Empty list");
+			}
+
+			//unlink the last item through the one before it
+			typename List::iterator i{ findPrevious(std::as_const(list).getLast()) };
+			if (i == list.end()) {
+				finger.reset();
+				list.removeFirst();
+			}
+			else {
+				i.removeNext();
+				moveFinger(i);
+			}
+		}
+	}
+
+	template<typename T, typename List>
+	LinkedSet<T, List> LinkedSet<T, List>::splitAt(const T& key)
+	{
+		flush();
+		splitPoints.invalidate();
+		LinkedSet<T, List> rest{};
+		if constexpr (IsBPlusTree<List>::value) {
+			rest.list = list.splitAt(key);
+		}
+		else if constexpr (std::is_same<List, LinkedList<T>>::value || std::is_same<List, DoublyLinkedList<T>>::value) {
+			rest.list = list.splitAfter(findPrevious(key));
+		}
+		else {
+			//move the items one by one, or all of them if none is smaller than key
+			typename List::iterator i{ findPrevious(key) };
+			if (i == list.end()) {
+				for (const T& item : std::as_const(list)) {
+					rest.list.addLast(item);
+				}
+				list.clear();
+			}
+			else {
+				while (i.hasNext()) {
+					rest.list.addLast(i.peekNext());
+					i.removeNext();
+				}
+			}
+		}
+
+		//the finger may have been on one of the items that left
+		finger.reset();
+		return rest;
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::join(LinkedSet<T, List>&& other)
+	{
+		if (&other == this) {
+			return;
+		}
+
+		flush();
+		other.flush();
+		splitPoints.invalidate();
+		finger.reset();
+		other.splitPoints.invalidate();
+		other.finger.reset();
+		if (other.list.getSize() == 0) {
+			return;
+		}
+
+		if (list.getSize() == 0 || other.list.getFirst() > list.getLast()) {
+			//other's items all go on the end
+			if constexpr (IsBPlusTree<List>::value) {
+				list.join(std::move(other.list));
+				return;
+			}
+			else if constexpr (std::is_same<List, LinkedList<T>>::value || std::is_same<List, DoublyLinkedList<T>>::value) {
+				list.append(std::move(other.list));
+				return;
+			}
+			else {
+				for (const T& item : std::as_const(other.list)) {
+					list.addLast(item);
+				}
+			}
+		}
+		else {
+			//the finger follows each insert, so walking other in order merges in one pass
+			for (const T& item : std::as_const(other.list)) {
+				insert(item);
+			}
+		}
+
+		other.list.clear();
+	}
+
+	template<typename T, typename List>
+	FrozenSet<T> LinkedSet<T, List>::freeze() const
+	{
+		return FrozenSet<T>{ std::vector<T>(begin(), end()) };
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::setPooledStorage(bool pooled)
+	{
+		splitPoints.invalidate();
+		list.setPooledStorage(pooled);
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::setReclaimer(NodeReclaimer<T>* reclaimer)
+	{
+		list.setReclaimer(reclaimer);
+	}
+
+	template<typename T, typename List>
+	unsigned int LinkedSet<T, List>::getSize() const
+	{
+		flush();
 		return list.getSize();
 	}
 
-	template<typename T>
-	ConstLinkedListIterator<T> LinkedSet<T>::begin() const
+	template<typename T, typename List>
+	bool LinkedSet<T, List>::compact(unsigned int maxNodes)
 	{
-		return list.begin();
+		flush();
+		splitPoints.invalidate();
+		finger.reset();
+		return list.compact(maxNodes);
 	}
 
-	template<typename T>
-	ConstLinkedListIterator<T> LinkedSet<T>::end() const
+	template<typename T, typename List>
+	typename List::const_iterator LinkedSet<T, List>::begin() const
 	{
-		return list.end();
+		flush();
+		return std::as_const(list).begin();
 	}
 
-	template<typename T>
-	MutableLinkedListIterator<T> LinkedSet<T>::begin()
+	template<typename T, typename List>
+	typename List::const_iterator LinkedSet<T, List>::end() const
 	{
+		flush();
+		return std::as_const(list).end();
+	}
+
+	template<typename T, typename List>
+	typename List::iterator LinkedSet<T, List>::begin()
+	{
+		flush();
+		splitPoints.invalidate();
+		finger.reset();
 		return list.begin();
 	}
 
-	template<typename T>
-	MutableLinkedListIterator<T> LinkedSet<T>::end()
+	template<typename T, typename List>
+	typename List::iterator LinkedSet<T, List>::end()
 	{
+		flush();
+		splitPoints.invalidate();
+		finger.reset();
 		return list.end();
 	}
 
+	template<typename T, typename List>
+	auto LinkedSet<T, List>::rbegin() const
+	{
+		flush();
+		return std::as_const(list).rbegin();
+	}
 
-	template <typename T>
-	std::ostream& operator << (std::ostream & out, const LinkedSet<T> & set)
+	template<typename T, typename List>
+	auto LinkedSet<T, List>::rend() const
+	{
+		flush();
+		return std::as_const(list).rend();
+	}
+
+	template<typename T, typename List>
+	template <typename Function>
+	void LinkedSet<T, List>::forEachInRange(const T& low, const T& high, Function f) const
 	{
+		flush();
+		if constexpr (IsBPlusTree<List>::value) {
+			list.scan(low, high, f);
+		}
+		else {
+			//start from the last item before low, or from the front if there is none
+			typename List::iterator i{ findPrevious(low) };
+			i = i == list.end() ? list.begin() : ++i;
+			for (; i != list.end() && high > *i; i++) {
+				f(*i);
+			}
+		}
+	}
+
+	template<typename T, typename List>
+	unsigned int LinkedSet<T, List>::countInRange(const T& low, const T& high) const
+	{
+		flush();
+		if constexpr (IsBPlusTree<List>::value) {
+			return list.countInRange(low, high);
+		}
+		else {
+			unsigned int count{ 0 };
+			forEachInRange(low, high, [&](const T&) { count++; });
+			return count;
+		}
+	}
+
+	template<typename T, typename List>
+	unsigned int LinkedSet<T, List>::rank(const T& item) const
+	{
+		flush();
+		if constexpr (IsBPlusTree<List>::value) {
+			return list.rank(item);
+		}
+		else {
+			unsigned int count{ 0 };
+			for (typename List::const_iterator i{ std::as_const(list).begin() }; i != std::as_const(list).end() && item > *i; ++i) {
+				count++;
+			}
+			return count;
+		}
+	}
+
+	template<typename T, typename List>
+	T LinkedSet<T, List>::select(unsigned int k) const
+	{
+		flush();
+		if constexpr (IsBPlusTree<List>::value) {
+			return list.select(k);
+		}
+		else {
+			if (k >= list.getSize()) {
+				throw std::out_of_range("Index out of range");
+			}
+			return *std::next(std::as_const(list).begin(), k);
+		}
+	}
+
+	template<typename T, typename List>
+	T LinkedSet<T, List>::operator[] (unsigned int k) const
+	{
+		return select(k);
+	}
+
+	template<typename T, typename List>
+	template <typename Random>
+	std::vector<T> LinkedSet<T, List>::sample(unsigned int k, Random& random) const
+	{
+		flush();
+		unsigned int size{ list.getSize() };
+		if (k >= size) {
+			return std::vector<T>(std::as_const(list).begin(), std::as_const(list).end());
+		}
+
+		std::vector<T> picked{};
+		if constexpr (IsBPlusTree<List>::value) {
+			//Floyd's algorithm: k draws give k distinct positions, each set of them equally likely
+			std::unordered_set<unsigned int> chosen{};
+			chosen.reserve(k);
+			std::vector<unsigned int> positions{};
+			positions.reserve(k);
+			for (unsigned int j{ size - k }; j < size; j++) {
+				unsigned int position{ std::uniform_int_distribution<unsigned int>{ 0, j }(random) };
+				if (!chosen.insert(position).second) {
+					position = j;
+					chosen.insert(position);
+				}
+				positions.push_back(position);
+			}
+
+			std::sort(positions.begin(), positions.end());
+			picked.reserve(k);
+			for (unsigned int position : positions) {
+				picked.push_back(list.select(position));
+			}
+		}
+		else {
+			picked = reservoirSample(std::as_const(list).begin(), std::as_const(list).end(), k, random);
+			std::sort(picked.begin(), picked.end(), [](const T& a, const T& b) { return b > a; });
+		}
+		return picked;
+	}
+
+	template<typename T, typename List>
+	template <typename Aggregate>
+	typename Aggregate::Value LinkedSet<T, List>::aggregate(const T& low, const T& high) const
+	{
+		flush();
+		if constexpr (std::is_same<List, BPlusTree<T, Aggregate>>::value) {
+			return list.aggregate(low, high);
+		}
+		else {
+			typename Aggregate::Value value{ Aggregate::identity() };
+			forEachInRange(low, high, [&](const T& item) { value = Aggregate::combine(value, Aggregate::of(item)); });
+			return value;
+		}
+	}
+
+	template<typename T, typename List>
+	template <typename Function>
+	void LinkedSet<T, List>::parallelForEach(Function f, ThreadPool& pool) const
+	{
+		forEachSegment(pool, [&](unsigned int, typename List::const_iterator first, typename List::const_iterator last) {
+			for (typename List::const_iterator i{ first }; i != last; ++i) {
+				f(*i);
+			}
+		});
+	}
+
+	template<typename T, typename List>
+	template <typename Result, typename BinaryOp>
+	Result LinkedSet<T, List>::parallelReduce(Result init, BinaryOp op, ThreadPool& pool) const
+	{
+		//each segment is reduced on its own, starting from its first item
+		std::vector<std::optional<Result>> partials{};
+		partials.resize(pool.getThreadCount() * 4);
+		unsigned int segments{ forEachSegment(pool, [&](unsigned int segment, typename List::const_iterator first, typename List::const_iterator last) {
+			Result partial(*first);
+			for (typename List::const_iterator i{ ++first }; i != last; ++i) {
+				partial = op(partial, *i);
+			}
+			partials[segment] = partial;
+		}) };
+
+		//then the segments are combined in list order
+		for (unsigned int segment{ 0 }; segment < segments; segment++) {
+			init = op(init, *partials[segment]);
+		}
+		return init;
+	}
+
+	template<typename T, typename List>
+	template <typename Predicate>
+	unsigned int LinkedSet<T, List>::parallelCountIf(Predicate predicate, ThreadPool& pool) const
+	{
+		std::vector<unsigned int> counts(pool.getThreadCount() * 4, 0);
+		unsigned int segments{ forEachSegment(pool, [&](unsigned int segment, typename List::const_iterator first, typename List::const_iterator last) {
+			unsigned int count{ 0 };
+			for (typename List::const_iterator i{ first }; i != last; ++i) {
+				if (predicate(*i)) {
+					count++;
+				}
+			}
+			counts[segment] = count;
+		}) };
+
+		unsigned int total{ 0 };
+		for (unsigned int segment{ 0 }; segment < segments; segment++) {
+			total += counts[segment];
+		}
+		return total;
+	}
+
+	template<typename T, typename List>
+	void LinkedSet<T, List>::moveFinger(typename List::iterator i)
+	{
+		finger = i;
+		fingerStamp = list.getInvalidations();
+	}
+
+	template<typename T, typename List>
+	bool LinkedSet<T, List>::hasFinger() const
+	{
+		return finger && fingerStamp == list.getInvalidations();
+	}
+
+	template<typename T, typename List>
+	typename List::iterator LinkedSet<T, List>::findPrevious(const T& item) const
+	{
+		//a tree is searched from the root unless the item comes straight after the finger
+		if constexpr (IsBPlusTree<List>::value || std::is_same<List, AdaptiveList<T>>::value) {
+			if (hasFinger() && item > **finger && !(finger->hasNext() && item > finger->peekNext())) {
+				return *finger;
+			}
+
+			return list.findPrevious(item);
+		}
+
+		typename List::iterator i{ list.end() };
+		if (hasFinger() && item > **finger) {
+			i = *finger;
+		}
+		else if (list.getSize() > 0 && item > list.getFirst()) {
+			i = list.begin();
+		}
+		else {
+			return list.end();
+		}
+
+		while (i.hasNext() && item > i.peekNext()) {
+			i++;
+		}
+		return i;
+	}
+
+	template<typename T, typename List>
+	template <typename Visit>
+	unsigned int LinkedSet<T, List>::forEachSegment(ThreadPool& pool, Visit visit) const
+	{
+		unsigned int size{ getSize() };
+		if (size == 0) {
+			return 0;
+		}
+
+		//small sets (or single threaded pools) aren't worth splitting
+		if (size < minParallelSize || pool.getThreadCount() == 1) {
+			visit(0, std::as_const(list).begin(), std::as_const(list).end());
+			return 1;
+		}
+
+		//a few segments per thread so that a slow thread doesn't hold up the rest
+		unsigned int segments{ pool.getThreadCount() * 4 };
+		std::vector<typename List::const_iterator> points{ splitPoints.get(list, size, segments) };
+		pool.run(segments, [&](unsigned int segment) {
+			visit(segment, points[segment], points[segment + 1]);
+		});
+		return segments;
+	}
+
+
+	template <typename T, typename List>
+	std::ostream& operator << (std::ostream & out, const LinkedSet<T, List> & set)
+	{
+		set.flush();
 		out << set.list;
 		return out;
 	}
+
+	template <typename T>
+	template <typename List>
+	LinkedSet<T, List> FrozenSet<T>::thaw() const
+	{
+		//the items are already sorted and distinct, so they go straight into the list
+		return LinkedSet<T, List>{ std::vector<T>(begin(), end()) };
+	}
@@ -0,0 +1,26 @@
+#pragma once
+#include "ListNode.h"
+
+// Gets told about every node a LinkedList links in or out, so that
+// structures kept alongside the list (filters, indexes) can stay up to date
+// no matter how the list is changed, including through its iterators.
+// An observer must outlive the lists it is attached to, or be detached first.
+template <typename T>
+class ListObserver
+{
+public:
+    // Virtual destructor
+    virtual ~ListObserver() = default;
+
+    // A node has just been linked in after previous (nullptr if it is now the first node).
+    virtual void inserted(const ListNode<T>* previous, const ListNode<T>* node) = 0;
+
+    // A node is about to be unlinked from after previous (nullptr if it is the first node).
+    virtual void removing(const ListNode<T>* previous, const ListNode<T>* node) = 0;
+
+    // A node has just moved to a new address; its predecessor links to the new one.
+    virtual void relocated(const ListNode<T>* node) = 0;
+
+    // Every node is about to be removed at once.
+    virtual void clearing() = 0;
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "ConstAdaptiveListIterator.h"
+
+// Forward mutable iterator for an AdaptiveList.
+// Adding or removing items through it may move items between
+// representations, which invalidates every other iterator into the list;
+// this one finds its item again afterwards, in O(log n).
+// The items are copies (see ConstAdaptiveListIterator), so changing them
+// through the iterator doesn't change the list.
+template <typename T>
+class MutableAdaptiveListIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // Construct an iterator that doesn't point into any list.
+    MutableAdaptiveListIterator() = default;
+
+    // Construct from a position in a list.
+    MutableAdaptiveListIterator(AdaptiveList<T>& list, ConstAdaptiveListIterator<T> at);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next item.
+    MutableAdaptiveListIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next item, returning the old position.
+    MutableAdaptiveListIterator<T> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same item.
+    bool operator == (const MutableAdaptiveListIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same item.
+    bool operator != (const MutableAdaptiveListIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access the current item.
+    T& operator * () const;
+
+    // Dereference to access the current item.
+    T* operator -> () const;
+
+    // Is there another item after the current one?
+    bool hasNext() const;
+
+    // Get the item after the current one.
+    T& peekNext();
+
+    // Add an item after the current one; it must keep the items in order.
+    void addNext(T value);
+
+    // Remove the item after the current one.
+    void removeNext();
+
+private:
+    // Find the current item again after the list has changed.
+    void reposition(const T& item);
+
+    // The list that is being iterated (and potentially modified).
+    AdaptiveList<T>* list{ nullptr };
+
+    // Where the iterator is
+    ConstAdaptiveListIterator<T> at{};
+
+    // Copy of the item after the current one, as returned by peekNext()
+    T following{};
+};
+
+template <typename T>
+MutableAdaptiveListIterator<T>::MutableAdaptiveListIterator(AdaptiveList<T>& list, ConstAdaptiveListIterator<T> at)
+    : list{ &list }, at{ at }
+{
+}
+
+template <typename T>
+MutableAdaptiveListIterator<T>& MutableAdaptiveListIterator<T>::operator ++ ()
+{
+    ++at;
+    return *this;
+}
+
+template <typename T>
+MutableAdaptiveListIterator<T> MutableAdaptiveListIterator<T>::operator ++ (int)
+{
+    MutableAdaptiveListIterator<T> old{ *this };
+    ++at;
+    return old;
+}
+
+template <typename T>
+bool MutableAdaptiveListIterator<T>::operator == (const MutableAdaptiveListIterator<T>& other) const
+{
+    return at == other.at;
+}
+
+template <typename T>
+bool MutableAdaptiveListIterator<T>::operator != (const MutableAdaptiveListIterator<T>& other) const
+{
+    return at != other.at;
+}
+
+template <typename T>
+bool MutableAdaptiveListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return at == std::default_sentinel;
+}
+
+template <typename T>
+T& MutableAdaptiveListIterator<T>::operator * () const
+{
+    return const_cast<T&>(*at);
+}
+
+template <typename T>
+T* MutableAdaptiveListIterator<T>::operator -> () const
+{
+    return const_cast<T*>(at.operator->());
+}
+
+template <typename T>
+bool MutableAdaptiveListIterator<T>::hasNext() const
+{
+    if (at == std::default_sentinel)
+    {
+        return false;
+    }
+
+    ConstAdaptiveListIterator<T> next{ at };
+    return ++next != std::default_sentinel;
+}
+
+template <typename T>
+T& MutableAdaptiveListIterator<T>::peekNext()
+{
+    // Prevent reading past the end of the list.
+    if (!hasNext())
+    {
+        throw std::logic_error(
+            "No item to peek at");
+    }
+
+    ConstAdaptiveListIterator<T> next{ at };
+    following = *++next;
+    return following;
+}
+
+template <typename T>
+void MutableAdaptiveListIterator<T>::addNext(T value)
+{
+    if (list->getSize() == 0)
+    {
+        // Empty list
+        list->insert(value);
+        return;
+    }
+
+    T item{ *at };
+    list->insert(value);
+    reposition(item);
+}
+
+template <typename T>
+void MutableAdaptiveListIterator<T>::removeNext()
+{
+    // Prevent removing past the end of the list.
+    if (!hasNext())
+    {
+        throw std::logic_error(
+            "No item to remove");
+    }
+
+    T item{ *at };
+    list->erase(peekNext());
+    reposition(item);
+}
+
+template <typename T>
+void MutableAdaptiveListIterator<T>::reposition(const T& item)
+{
+    at = list->lowerBound(item);
+}
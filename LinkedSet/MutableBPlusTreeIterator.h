@@ -0,0 +1,188 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "BPlusTreeNode.h"
+
+template <typename T, typename Aggregate>
+class BPlusTree;
+
+// Forward mutable iterator for a B+-tree.
+// Adding or removing items through it may split or free leaves, which
+// invalidates every other iterator into the tree (but not this one).
+template <typename T, typename Aggregate = void>
+class MutableBPlusTreeIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // Construct an iterator that doesn't point into any tree.
+    MutableBPlusTreeIterator() = default;
+
+    // Construct from a leaf, the position of an item in it and a reference to the tree.
+    MutableBPlusTreeIterator(BPlusTreeLeaf<T>* leaf, unsigned int index, BPlusTree<T, Aggregate>& tree);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next item.
+    MutableBPlusTreeIterator<T, Aggregate>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next item, returning the old position.
+    MutableBPlusTreeIterator<T, Aggregate> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same item.
+    bool operator == (const MutableBPlusTreeIterator<T, Aggregate>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same item.
+    bool operator != (const MutableBPlusTreeIterator<T, Aggregate>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the tree.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access the current item.
+    T& operator * () const;
+
+    // Dereference to access the current item.
+    T* operator -> () const;
+
+    // Is there another item after the current one?
+    bool hasNext() const;
+
+    // Get the item after the current one.
+    T& peekNext();
+
+    // Add an item after the current one; it must keep the items in order.
+    void addNext(T value);
+
+    // Remove the item after the current one.
+    void removeNext();
+
+    template <typename T2, typename Aggregate2>
+    friend class BPlusTree;
+
+private:
+    // The leaf holding the current item, or nullptr at the end.
+    BPlusTreeLeaf<T>* leaf{ nullptr };
+
+    // Position of the current item in the leaf.
+    unsigned int index{ 0 };
+
+    // The tree that is being iterated (and potentially modified).
+    BPlusTree<T, Aggregate>* tree{ nullptr };
+};
+
+template <typename T, typename Aggregate>
+MutableBPlusTreeIterator<T, Aggregate>::MutableBPlusTreeIterator(BPlusTreeLeaf<T>* leaf, unsigned int index, BPlusTree<T, Aggregate>& tree)
+    : leaf{ leaf }, index{ index }, tree{ &tree }
+{
+}
+
+template <typename T, typename Aggregate>
+MutableBPlusTreeIterator<T, Aggregate>& MutableBPlusTreeIterator<T, Aggregate>::operator ++ ()
+{
+    // Move along the leaf, then on to the next one.
+    if (++index == leaf->count)
+    {
+        leaf = leaf->next;
+        index = 0;
+    }
+
+    return *this;
+}
+
+template <typename T, typename Aggregate>
+MutableBPlusTreeIterator<T, Aggregate> MutableBPlusTreeIterator<T, Aggregate>::operator ++ (int)
+{
+    MutableBPlusTreeIterator<T, Aggregate> old{ *this };
+    ++*this;
+    return old;
+}
+
+template <typename T, typename Aggregate>
+bool MutableBPlusTreeIterator<T, Aggregate>::operator == (const MutableBPlusTreeIterator<T, Aggregate>& other) const
+{
+    return leaf == other.leaf && index == other.index;
+}
+
+template <typename T, typename Aggregate>
+bool MutableBPlusTreeIterator<T, Aggregate>::operator != (const MutableBPlusTreeIterator<T, Aggregate>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T, typename Aggregate>
+bool MutableBPlusTreeIterator<T, Aggregate>::operator == (std::default_sentinel_t) const
+{
+    return leaf == nullptr;
+}
+
+template <typename T, typename Aggregate>
+T& MutableBPlusTreeIterator<T, Aggregate>::operator * () const
+{
+    return leaf->items[index];
+}
+
+template <typename T, typename Aggregate>
+T* MutableBPlusTreeIterator<T, Aggregate>::operator -> () const
+{
+    return &leaf->items[index];
+}
+
+template <typename T, typename Aggregate>
+bool MutableBPlusTreeIterator<T, Aggregate>::hasNext() const
+{
+    return leaf != nullptr
+        && (index + 1 < leaf->count || leaf->next != nullptr);
+}
+
+template <typename T, typename Aggregate>
+T& MutableBPlusTreeIterator<T, Aggregate>::peekNext()
+{
+    // Prevent null pointer access when trying to peek past the end of the tree.
+    if (!hasNext())
+    {
+        throw std::logic_error(
+            "No item to peek at");
+    }
+
+    return index + 1 < leaf->count ? leaf->items[index + 1] : leaf->next->items[0];
+}
+
+template <typename T, typename Aggregate>
+void MutableBPlusTreeIterator<T, Aggregate>::addNext(T value)
+{
+    if (tree->size == 0)
+    {
+        // Empty tree
+        tree->addFirst(value);
+    }
+    else
+    {
+        tree->insertAfter(*this, std::move(value));
+    }
+}
+
+template <typename T, typename Aggregate>
+void MutableBPlusTreeIterator<T, Aggregate>::removeNext()
+{
+    // Prevent null pointer access when trying to remove past the end of the tree.
+    if (!hasNext())
+    {
+        throw std::logic_error(
+            "No item to remove");
+    }
+
+    if (index + 1 < leaf->count)
+    {
+        tree->eraseAt(leaf, index + 1);
+    }
+    else
+    {
+        tree->eraseAt(leaf->next, 0);
+    }
+}
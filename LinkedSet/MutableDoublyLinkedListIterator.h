@@ -0,0 +1,204 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "DoublyListNode.h"
+
+template <typename T>
+class DoublyLinkedList;
+
+// Bidirectional mutable iterator for a doubly-linked list
+template <typename T>
+class MutableDoublyLinkedListIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // Construct an iterator that doesn't point into any list.
+    MutableDoublyLinkedListIterator() = default;
+
+    // Construct from a starting node and a reference to the list.
+    MutableDoublyLinkedListIterator(DoublyListNode<T>* start, DoublyLinkedList<T>& list);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next node.
+    MutableDoublyLinkedListIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next node, returning the old position.
+    MutableDoublyLinkedListIterator<T> operator ++ (int);
+
+    // Pre-decrement operator (--i):
+    // Moves iterator back to the previous node (or the last node from end()).
+    MutableDoublyLinkedListIterator<T>& operator -- ();
+
+    // Post-decrement operator (i--):
+    // Moves iterator back to the previous node, returning the old position.
+    MutableDoublyLinkedListIterator<T> operator -- (int);
+
+    // Equality operator; checks if iterators are at the same node.
+    bool operator == (const MutableDoublyLinkedListIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same node.
+    bool operator != (const MutableDoublyLinkedListIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access value at the current node.
+    T& operator * () const;
+
+    // Dereference to access value at the current node.
+    T* operator -> () const;
+
+    // Is there another node after the current one?
+    bool hasNext() const;
+
+    // Get the value at the node after the current one.
+    T& peekNext();
+
+    // Add a node after the current one.
+    void addNext(T value);
+
+    // Remove the node after the current one.
+    void removeNext();
+
+    template <typename T2>
+    friend class DoublyLinkedList;
+
+private:
+    // The node the iterator is currently visiting.
+    DoublyListNode<T>* current{ nullptr };
+
+    // The list that is being iterated (and potentially modified).
+    DoublyLinkedList<T>* list{ nullptr };
+};
+
+template <typename T>
+MutableDoublyLinkedListIterator<T>::MutableDoublyLinkedListIterator(DoublyListNode<T>* start, DoublyLinkedList<T>& list)
+    : current{ start }, list{ &list }
+{
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T>& MutableDoublyLinkedListIterator<T>::operator ++ ()
+{
+    // Advance to the next node.
+    current = current->next;
+
+    // Pre-increment operator (++i) can be easily chained.
+    return *this;
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T> MutableDoublyLinkedListIterator<T>::operator ++ (int)
+{
+    MutableDoublyLinkedListIterator<T> old{ *this };
+    current = current->next;
+    return old;
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T>& MutableDoublyLinkedListIterator<T>::operator -- ()
+{
+    // Step back to the previous node; end() steps back to the last node.
+    current = current ? current->previous : list->last;
+
+    return *this;
+}
+
+template <typename T>
+MutableDoublyLinkedListIterator<T> MutableDoublyLinkedListIterator<T>::operator -- (int)
+{
+    MutableDoublyLinkedListIterator<T> old{ *this };
+    --*this;
+    return old;
+}
+
+template <typename T>
+bool MutableDoublyLinkedListIterator<T>::operator == (const MutableDoublyLinkedListIterator<T>& other) const
+{
+    return this->current == other.current;
+}
+
+template <typename T>
+bool MutableDoublyLinkedListIterator<T>::operator != (const MutableDoublyLinkedListIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool MutableDoublyLinkedListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return current == nullptr;
+}
+
+template <typename T>
+T& MutableDoublyLinkedListIterator<T>::operator * () const
+{
+    return current->value;
+}
+
+template <typename T>
+T* MutableDoublyLinkedListIterator<T>::operator -> () const
+{
+    return &(current->value);
+}
+
+template <typename T>
+bool MutableDoublyLinkedListIterator<T>::hasNext() const
+{
+    // Check that neither this node nor the next are nullptr.
+    return current != nullptr
+        && current->next != nullptr;
+}
+
+template <typename T>
+T& MutableDoublyLinkedListIterator<T>::peekNext()
+{
+    // Prevent null pointer access when trying to peek past the end of the list.
+    if (hasNext())
+    {
+        return current->next->value;
+    }
+    else
+    {
+        throw std::logic_error(
+            "No item to peek at");
+    }
+}
+
+template <typename T>
+void MutableDoublyLinkedListIterator<T>::addNext(T value)
+{
+    if (list->size == 0)
+    {
+        // Empty list
+        list->addFirst(value);
+    }
+    else
+    {
+        list->insertAfter(current, value);
+    }
+}
+
+template <typename T>
+void MutableDoublyLinkedListIterator<T>::removeNext()
+{
+    // Prevent null pointer access when trying to remove past the end of the list.
+    if (hasNext())
+    {
+        list->unlink(current->next);
+    }
+    else
+    {
+        // Thrown if the list is empty.
+        throw std::logic_error(
+            "No item to remove");
+    }
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include "IndexedListNode.h"
+
+template <typename T>
+class IndexedLinkedList;
+
+// Forward mutable iterator for an index-linked list
+template <typename T>
+class MutableIndexedListIterator
+{
+public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // Construct an iterator that doesn't point into any list.
+    MutableIndexedListIterator() = default;
+
+    // Construct from a starting node index and a reference to the list.
+    MutableIndexedListIterator(std::uint32_t start, IndexedLinkedList<T>& list);
+
+    // Pre-increment operator (++i):
+    // Advances iterator to the next node.
+    MutableIndexedListIterator<T>& operator ++ ();
+
+    // Post-increment operator (i++):
+    // Advances iterator to the next node, returning the old position.
+    MutableIndexedListIterator<T> operator ++ (int);
+
+    // Equality operator; checks if iterators are at the same node.
+    bool operator == (const MutableIndexedListIterator<T>& other) const;
+
+    // Inequality operator; checks if iterators are not at the same node.
+    bool operator != (const MutableIndexedListIterator<T>& other) const;
+
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
+    // Dereference to access value at the current node.
+    T& operator * () const;
+
+    // Dereference to access value at the current node.
+    T* operator -> () const;
+
+    // Is there another node after the current one?
+    bool hasNext() const;
+
+    // Get the value at the node after the current one.
+    T& peekNext();
+
+    // Add a node after the current one.
+    void addNext(T value);
+
+    // Remove the node after the current one.
+    void removeNext();
+
+private:
+    // The index of the node the iterator is currently visiting.
+    std::uint32_t current{ IndexedListNode<T>::none };
+
+    // The list that is being iterated (and potentially modified).
+    IndexedLinkedList<T>* list{ nullptr };
+};
+
+template <typename T>
+MutableIndexedListIterator<T>::MutableIndexedListIterator(std::uint32_t start, IndexedLinkedList<T>& list)
+    : current{ start }, list{ &list }
+{
+}
+
+template <typename T>
+MutableIndexedListIterator<T>& MutableIndexedListIterator<T>::operator ++ ()
+{
+    // Advance to the next node.
+    current = list->nodes[current].next;
+
+    // Pre-increment operator (++i) can be easily chained.
+    return *this;
+}
+
+template <typename T>
+MutableIndexedListIterator<T> MutableIndexedListIterator<T>::operator ++ (int)
+{
+    MutableIndexedListIterator<T> old{ *this };
+    current = list->nodes[current].next;
+    return old;
+}
+
+template <typename T>
+bool MutableIndexedListIterator<T>::operator == (const MutableIndexedListIterator<T>& other) const
+{
+    return this->current == other.current;
+}
+
+template <typename T>
+bool MutableIndexedListIterator<T>::operator != (const MutableIndexedListIterator<T>& other) const
+{
+    return !(*this == other);
+}
+
+template <typename T>
+bool MutableIndexedListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return current == IndexedListNode<T>::none;
+}
+
+template <typename T>
+T& MutableIndexedListIterator<T>::operator * () const
+{
+    return list->nodes[current].value;
+}
+
+template <typename T>
+T* MutableIndexedListIterator<T>::operator -> () const
+{
+    return &(list->nodes[current].value);
+}
+
+template <typename T>
+bool MutableIndexedListIterator<T>::hasNext() const
+{
+    // Check that neither this node nor the next are missing.
+    return current != IndexedListNode<T>::none
+        && list->nodes[current].next != IndexedListNode<T>::none;
+}
+
+template <typename T>
+T& MutableIndexedListIterator<T>::peekNext()
+{
+    // Prevent out of range access when trying to peek past the end of the list.
+    if (hasNext())
+    {
+        return list->nodes[list->nodes[current].next].value;
+    }
+    else
+    {
+        throw std::logic_error(
+            "No item to peek at");
+    }
+}
+
+template <typename T>
+void MutableIndexedListIterator<T>::addNext(T value)
+{
+    // Create a new node storing the new element.
+    // (This may grow the node array, so nodes are only looked up afterwards.)
+    std::uint32_t newNode{ list->createNode(value) };
+
+    if (list->size == 0)
+    {
+        // Empty list
+        list->first = newNode;
+        list->last = newNode;
+    }
+    else
+    {
+        // Link the new node in after the current one.
+        list->nodes[newNode].next = list->nodes[current].next;
+        list->nodes[current].next = newNode;
+
+        // Function called on last element in list
+        if (list->last == current)
+        {
+            list->last = newNode;
+        }
+    }
+
+    list->size++;
+}
+
+template <typename T>
+void MutableIndexedListIterator<T>::removeNext()
+{
+    // Prevent out of range access when trying to remove past the end of the list.
+    if (hasNext())
+    {
+        // Link current to the node that comes after the node being deleted.
+        std::uint32_t next{ list->nodes[current].next };
+        list->nodes[current].next = list->nodes[next].next;
+
+        // If the node to be deleted is the last node, the current node becomes the last node.
+        if (list->last == next)
+        {
+            list->last = current;
+        }
+
+        list->destroyNode(next);
+        list->size--;
+    }
+    else
+    {
+        // Thrown if the list is empty.
+        throw std::logic_error(
+            "No item to remove");
+    }
+}
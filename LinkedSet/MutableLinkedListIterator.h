@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
 #include "ListNode.h"
 
 // Forward mutable iterator for a linked list
@@ -6,6 +9,16 @@ template <typename T>
 class MutableLinkedListIterator
 {
 public:
+    // Standard iterator traits
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // Construct an iterator that doesn't point into any list.
+    MutableLinkedListIterator() = default;
+
     // Construct from a starting node and a reference to the list.
     MutableLinkedListIterator(ListNode<T>* start, LinkedList<T>& list);
 
@@ -14,8 +27,8 @@ public:
     MutableLinkedListIterator<T>& operator ++ ();
 
     // Post-increment operator (i++):
-    // Advances iterator to the next node.
-    void operator ++ (int);
+    // Advances iterator to the next node, returning the old position.
+    MutableLinkedListIterator<T> operator ++ (int);
 
     // Equality operator; checks if iterators are at the same node.
     bool operator == (const MutableLinkedListIterator<T>& other) const;
@@ -23,11 +36,14 @@ public:
     // Inequality operator; checks if iterators are not at the same node.
     bool operator != (const MutableLinkedListIterator<T>& other) const;
 
+    // Sentinel comparison; checks if the iterator has run off the end of the list.
+    bool operator == (std::default_sentinel_t) const;
+
     // Dereference to access value at the current node.
-    T& operator * ();
+    T& operator * () const;
 
     // Dereference to access value at the current node.
-    T* operator -> ();
+    T* operator -> () const;
 
     // Is there another node after the current one?
     bool hasNext() const;
@@ -41,18 +57,20 @@ public:
     // Remove the node after the current one.
     void removeNext();
 
+    template <typename T2>
+    friend class LinkedList;
 
 private:
     // The node the iterator is currently visiting.
-    ListNode<T>* current;
+    ListNode<T>* current{ nullptr };
 
     // The list that is being iterated (and potentially modified).
-    LinkedList<T>& list;
+    LinkedList<T>* list{ nullptr };
 };
 
 template <typename T>
 MutableLinkedListIterator<T>::MutableLinkedListIterator(ListNode<T>* start, LinkedList<T>& list)
-    : current{ start }, list{ list }
+    : current{ start }, list{ &list }
 {
 }
 
@@ -67,12 +85,11 @@ MutableLinkedListIterator<T>& MutableLinkedListIterator<T>::operator ++ ()
 }
 
 template <typename T>
-void MutableLinkedListIterator<T>::operator ++ (int)
+MutableLinkedListIterator<T> MutableLinkedListIterator<T>::operator ++ (int)
 {
-    // Advance to the next node.
+    MutableLinkedListIterator<T> old{ *this };
     current = current->next;
-
-    // Chain assignment disabled for pre-increment.
+    return old;
 }
 
 template <typename T>
@@ -88,13 +105,19 @@ bool MutableLinkedListIterator<T>::operator != (const MutableLinkedListIterator<
 }
 
 template <typename T>
-T& MutableLinkedListIterator<T>::operator * ()
+bool MutableLinkedListIterator<T>::operator == (std::default_sentinel_t) const
+{
+    return current == nullptr;
+}
+
+template <typename T>
+T& MutableLinkedListIterator<T>::operator * () const
 {
     return current->value;
 }
 
 template <typename T>
-T* MutableLinkedListIterator<T>::operator -> ()
+T* MutableLinkedListIterator<T>::operator -> () const
 {
     return &(current->value);
 }
@@ -119,28 +142,28 @@ T& MutableLinkedListIterator<T>::peekNext()
 template<class T>
 void MutableLinkedListIterator<T>::addNext(T value)
 {
-    // Create a new node
-    ListNode<T>* newNode{ new ListNode<T>() };
+    // Make sure there is room for another node (this may move the current one).
+    current = list->makeRoom(current);
 
-    // Store the new element in the new node
-    newNode->value = value;
+    // Create a new node storing the new element
+    ListNode<T>* newNode{ list->createNode(value) };
 
     
     //empty list
-    if (list.getSize() == 0) {
-        list.first = newNode;
-        list.last = newNode;
+    if (list->getSize() == 0) {
+        list->first = newNode;
+        list->last = newNode;
     }
     //List has a single element
-    if (list.getSize() == 1) {
+    if (list->getSize() == 1) {
         current->next = newNode;
-        list.last = newNode;
+        list->last = newNode;
     }
     else{
         //function called on last element in list
         if (current->next == nullptr) {
             current->next = newNode;
-            list.last = newNode;
+            list->last = newNode;
         }
         //function called on element with element(s) after
         else {
@@ -149,7 +172,8 @@ void MutableLinkedListIterator<T>::addNext(T value)
         }
     }
     //increment size
-    this->list.size++;
+    list->size++;
+    list->notifyInserted(list->first == newNode ? nullptr : current, newNode);
 }
 
 
@@ -171,17 +195,19 @@ void MutableLinkedListIterator<T>::removeNext()
     // Prevent null pointer access when trying to remove past the end of the list.
     if (hasNext())
     {
+        list->notifyRemoving(current, next);
+
         // Link current to the node that comes after the node being deleted.
         current->next = next->next;
 
         // If the node to be deleted is the last node, the current node becomes the last node.
-        if (list.last == next)
+        if (list->last == next)
         {
-            list.last = current;
+            list->last = current;
         }
 
-        delete next;
-        list.size--;
+        list->destroyNode(next);
+        list->size--;
     }
     else
     {
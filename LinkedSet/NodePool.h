@@ -0,0 +1,414 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "ListNode.h"
+
+// A block allocator for list nodes.
+// Nodes are carved out of large contiguous blocks, so nodes that are
+// allocated one after another sit next to each other in memory.
+// The pool only hands out raw storage; constructing and destroying the
+// nodes themselves is left to the list that owns the pool.
+template <typename T>
+class NodePool
+{
+public:
+    // Default constructor
+    NodePool() = default;
+
+    // Destructor; frees every block still held by the pool.
+    ~NodePool();
+
+    // Pools own raw memory, so they can't be copied.
+    NodePool(const NodePool<T>& original) = delete;
+    NodePool<T>& operator= (const NodePool<T>& original) = delete;
+
+    // Move constructor
+    NodePool(NodePool<T>&& original) noexcept;
+
+    // Move assignment op
+    NodePool<T>& operator= (NodePool<T>&& original) noexcept;
+
+    // Get storage for one node, reusing freed slots where possible.
+    ListNode<T>* allocate();
+
+    // Get storage for one node directly after the previous sequential allocation.
+    // Freed slots are never reused, so consecutive calls return adjacent addresses
+    // (until a block fills up and a new one is started).
+    ListNode<T>* allocateSequential();
+
+    // Give back the storage of a node that has already been destroyed.
+    // Blocks that become empty are returned to the heap.
+    void release(ListNode<T>* node);
+
+    // Free all blocks at once.
+    // Any nodes still living in the pool must already have been destroyed
+    // (or be trivially destructible, in which case there is nothing to destroy).
+    void releaseAll();
+
+    // Replace this pool's contents with a byte-for-byte copy of original's blocks.
+    // first and last point to the ends of a chain living in original; on return
+    // they point to the ends of the copied chain, with every link redirected
+    // into the new blocks. Only valid for trivially copyable T.
+    void copyFrom(const NodePool<T>& original, ListNode<T>*& first, ListNode<T>*& last);
+
+    // Check if a node lives in one of the pool's blocks.
+    bool owns(const ListNode<T>* node) const;
+
+    // Check if node lives in one of the pool's blocks after previous: later
+    // in the same block, or in a block created after previous's. This is the
+    // order allocateSequential() hands out slots in. previous must be from
+    // this pool.
+    bool follows(const ListNode<T>* previous, const ListNode<T>* node) const;
+
+    // Check if the pool currently holds any blocks.
+    bool isEmpty() const;
+
+    // Get the number of nodes currently allocated from the pool.
+    unsigned int getLiveCount() const;
+
+    // Number of nodes in each block (about one 4 KiB page worth).
+    static constexpr unsigned int blockCapacity{
+        sizeof(ListNode<T>) < 4096 / 16 ? 4096 / sizeof(ListNode<T>) : 16 };
+
+private:
+    // A single contiguous run of node slots.
+    struct Block
+    {
+        // The storage for the slots.
+        ListNode<T>* nodes;
+
+        // Number of slots handed out from the end of the block so far.
+        unsigned int used;
+
+        // Number of slots currently holding a node.
+        unsigned int live;
+
+        // Singly-linked chain of released slots, threaded through the slots themselves.
+        void* freeList;
+
+        // Position of the block in creation order; later blocks have bigger ones.
+        unsigned int serial;
+    };
+
+    // Create an empty block and insert it in address order.
+    Block* createBlock();
+
+    // Return a block's storage to the heap and forget about it.
+    void destroyBlock(Block* block);
+
+    // Find the block a node lives in, or nullptr if it isn't from this pool.
+    Block* findBlock(const ListNode<T>* node) const;
+
+    // Find the position in blocks of the block a node lives in,
+    // or blocks.size() if it isn't from this pool.
+    std::size_t findBlockIndex(const ListNode<T>* node) const;
+
+    // All blocks, sorted by address so owns() can binary search.
+    std::vector<Block*> blocks;
+
+    // Block that sequential allocations currently come from.
+    Block* current{ nullptr };
+
+    // Number of blocks with released slots waiting to be reused.
+    unsigned int blocksWithHoles{ 0 };
+
+    // Number of nodes currently allocated from the pool.
+    unsigned int liveCount{ 0 };
+
+    // Number of blocks created so far, i.e. the serial of the next one.
+    unsigned int createdBlocks{ 0 };
+};
+
+template <typename T>
+NodePool<T>::~NodePool()
+{
+    releaseAll();
+}
+
+template <typename T>
+NodePool<T>::NodePool(NodePool<T>&& original) noexcept
+    : blocks{ std::move(original.blocks) }, current{ original.current },
+    blocksWithHoles{ original.blocksWithHoles }, liveCount{ original.liveCount },
+    createdBlocks{ original.createdBlocks }
+{
+    original.blocks.clear();
+    original.current = nullptr;
+    original.blocksWithHoles = 0;
+    original.liveCount = 0;
+}
+
+template <typename T>
+NodePool<T>& NodePool<T>::operator= (NodePool<T>&& original) noexcept
+{
+    if (this != &original)
+    {
+        releaseAll();
+        blocks = std::move(original.blocks);
+        current = original.current;
+        blocksWithHoles = original.blocksWithHoles;
+        liveCount = original.liveCount;
+        createdBlocks = original.createdBlocks;
+        original.blocks.clear();
+        original.current = nullptr;
+        original.blocksWithHoles = 0;
+        original.liveCount = 0;
+    }
+
+    return *this;
+}
+
+template <typename T>
+ListNode<T>* NodePool<T>::allocate()
+{
+    // Prefer a released slot in the current block, then a fresh one at its end.
+    if (current && current->freeList)
+    {
+        void* slot{ current->freeList };
+        current->freeList = *static_cast<void**>(slot);
+        if (!current->freeList)
+        {
+            blocksWithHoles--;
+        }
+        current->live++;
+        liveCount++;
+        return static_cast<ListNode<T>*>(slot);
+    }
+
+    if ((!current || current->used == blockCapacity) && blocksWithHoles > 0)
+    {
+        // Switch to any block that still has a hole before growing the pool.
+        for (Block* block : blocks)
+        {
+            if (block->freeList)
+            {
+                current = block;
+                return allocate();
+            }
+        }
+    }
+
+    return allocateSequential();
+}
+
+template <typename T>
+ListNode<T>* NodePool<T>::allocateSequential()
+{
+    if (!current || current->used == blockCapacity)
+    {
+        current = createBlock();
+    }
+
+    ListNode<T>* slot{ current->nodes + current->used };
+    current->used++;
+    current->live++;
+    liveCount++;
+    return slot;
+}
+
+template <typename T>
+void NodePool<T>::release(ListNode<T>* node)
+{
+    Block* block{ findBlock(node) };
+
+    // Thread the slot onto the block's free list.
+    if (!block->freeList)
+    {
+        blocksWithHoles++;
+    }
+    *reinterpret_cast<void**>(node) = block->freeList;
+    block->freeList = node;
+    block->live--;
+    liveCount--;
+
+    if (block->live == 0)
+    {
+        if (block == current)
+        {
+            // Keep the current block around, but start it over from the beginning.
+            block->used = 0;
+            block->freeList = nullptr;
+            blocksWithHoles--;
+        }
+        else
+        {
+            destroyBlock(block);
+        }
+    }
+}
+
+template <typename T>
+void NodePool<T>::releaseAll()
+{
+    for (Block* block : blocks)
+    {
+        ::operator delete(block->nodes);
+        delete block;
+    }
+
+    blocks.clear();
+    current = nullptr;
+    blocksWithHoles = 0;
+    liveCount = 0;
+}
+
+template <typename T>
+void NodePool<T>::copyFrom(const NodePool<T>& original, ListNode<T>*& first, ListNode<T>*& last)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "copyFrom() copies nodes byte for byte");
+
+    releaseAll();
+
+    // Copy every block wholesale; copies[i] is the copy of original.blocks[i].
+    std::vector<Block*> copies{};
+    copies.reserve(original.blocks.size());
+    for (const Block* block : original.blocks)
+    {
+        Block* copy{ createBlock() };
+        std::memcpy(copy->nodes, block->nodes, block->used * sizeof(ListNode<T>));
+        copy->used = block->used;
+        copy->live = block->live;
+        copy->freeList = block->freeList;
+        copy->serial = block->serial;
+        copies.push_back(copy);
+
+        if (block == original.current)
+        {
+            current = copy;
+        }
+    }
+
+    blocksWithHoles = original.blocksWithHoles;
+    liveCount = original.liveCount;
+    createdBlocks = original.createdBlocks;
+
+    // Map an address inside original onto the same offset inside the copy.
+    // The previous lookup is cached, since neighbouring nodes usually share a block.
+    std::size_t hit{ 0 };
+    auto translate{ [&](const void* address) -> void*
+    {
+        if (!address)
+        {
+            return nullptr;
+        }
+
+        const ListNode<T>* node{ static_cast<const ListNode<T>*>(address) };
+        if (!(node >= original.blocks[hit]->nodes && node < original.blocks[hit]->nodes + blockCapacity))
+        {
+            hit = original.findBlockIndex(node);
+        }
+
+        return copies[hit]->nodes + (node - original.blocks[hit]->nodes);
+    } };
+
+    // Redirect each block's free list...
+    for (Block* copy : copies)
+    {
+        copy->freeList = translate(copy->freeList);
+        for (void* slot{ copy->freeList }; slot; slot = *static_cast<void**>(slot))
+        {
+            *static_cast<void**>(slot) = translate(*static_cast<void**>(slot));
+        }
+    }
+
+    // ...and the chain itself.
+    first = static_cast<ListNode<T>*>(translate(first));
+    last = static_cast<ListNode<T>*>(translate(last));
+    for (ListNode<T>* node{ first }; node; node = node->next)
+    {
+        node->next = static_cast<ListNode<T>*>(translate(node->next));
+    }
+}
+
+template <typename T>
+bool NodePool<T>::owns(const ListNode<T>* node) const
+{
+    return findBlock(node) != nullptr;
+}
+
+template <typename T>
+bool NodePool<T>::follows(const ListNode<T>* previous, const ListNode<T>* node) const
+{
+    Block* previousBlock{ findBlock(previous) };
+    Block* block{ findBlock(node) };
+    if (!previousBlock || !block)
+    {
+        return false;
+    }
+
+    // A new block can land anywhere in memory, so blocks are ordered by when they were made.
+    return block == previousBlock ? std::less<const ListNode<T>*>{}(previous, node) : block->serial > previousBlock->serial;
+}
+
+template <typename T>
+bool NodePool<T>::isEmpty() const
+{
+    return blocks.empty();
+}
+
+template <typename T>
+unsigned int NodePool<T>::getLiveCount() const
+{
+    return liveCount;
+}
+
+template <typename T>
+typename NodePool<T>::Block* NodePool<T>::createBlock()
+{
+    Block* block{ new Block{ nullptr, 0, 0, nullptr, createdBlocks++ } };
+    block->nodes = static_cast<ListNode<T>*>(::operator new(blockCapacity * sizeof(ListNode<T>)));
+
+    // Keep the blocks sorted by address.
+    auto position{ std::upper_bound(blocks.begin(), blocks.end(), block,
+        [](const Block* a, const Block* b) { return std::less<const ListNode<T>*>{}(a->nodes, b->nodes); }) };
+    blocks.insert(position, block);
+
+    return block;
+}
+
+template <typename T>
+void NodePool<T>::destroyBlock(Block* block)
+{
+    if (block->freeList)
+    {
+        blocksWithHoles--;
+    }
+
+    blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+    ::operator delete(block->nodes);
+    delete block;
+}
+
+template <typename T>
+typename NodePool<T>::Block* NodePool<T>::findBlock(const ListNode<T>* node) const
+{
+    std::size_t index{ findBlockIndex(node) };
+    return index < blocks.size() ? blocks[index] : nullptr;
+}
+
+template <typename T>
+std::size_t NodePool<T>::findBlockIndex(const ListNode<T>* node) const
+{
+    if (blocks.empty())
+    {
+        // Common case: nothing has ever been allocated from the pool.
+        return 0;
+    }
+
+    // Find the last block that starts at or before the node.
+    std::less<const ListNode<T>*> before{};
+    auto position{ std::upper_bound(blocks.begin(), blocks.end(), node,
+        [&](const ListNode<T>* n, const Block* b) { return before(n, b->nodes); }) };
+
+    if (position == blocks.begin())
+    {
+        return blocks.size();
+    }
+
+    std::size_t index{ static_cast<std::size_t>(position - blocks.begin()) - 1 };
+    return before(node, blocks[index]->nodes + blockCapacity) ? index : blocks.size();
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "ListNode.h"
+#include "NodePool.h"
+
+// Frees the nodes of detached lists away from the code that dropped them.
+// A list that has been given a reclaimer hands its whole chain over in O(1)
+// when it is cleared or destroyed; the nodes are then freed either by a
+// background thread, or a bounded number at a time by calling reclaim().
+// The reclaimer must outlive every list that uses it.
+template <typename T>
+class NodeReclaimer
+{
+public:
+    // Construct a reclaimer; if background is true, a worker thread frees
+    // retired chains as soon as they arrive.
+    explicit NodeReclaimer(bool background = false);
+
+    // Destructor; frees everything still pending.
+    ~NodeReclaimer();
+
+    // A reclaimer is shared by reference, so it can't be copied or moved.
+    NodeReclaimer(const NodeReclaimer<T>& original) = delete;
+    NodeReclaimer<T>& operator= (const NodeReclaimer<T>& original) = delete;
+
+    // Take ownership of a detached chain of size nodes, along with the pool
+    // that any of its compacted nodes live in.
+    void retire(ListNode<T>* first, unsigned int size, NodePool<T>&& pool);
+
+    // Free up to maxNodes pending nodes on the calling thread.
+    // Returns true if nothing is left to free.
+    bool reclaim(unsigned int maxNodes);
+
+    // Wait until every retired node has been freed (freeing them on the
+    // calling thread if there is no background worker).
+    void drain();
+
+    // Get the number of nodes waiting to be freed.
+    unsigned int getPendingCount() const;
+
+private:
+    // A detached chain waiting to be freed.
+    struct Chain
+    {
+        // Next node of the chain to free.
+        ListNode<T>* first;
+
+        // Storage for any of the chain's nodes that were compacted.
+        NodePool<T> pool;
+    };
+
+    // Free up to maxNodes nodes from the front of a chain.
+    // Returns the number of nodes freed.
+    static unsigned int freeNodes(Chain& chain, unsigned int maxNodes);
+
+    // Body of the background worker thread.
+    void work();
+
+    // Chains waiting to be freed, oldest first.
+    std::deque<Chain> pending;
+
+    // Number of nodes across all pending chains (including one being freed by the worker).
+    unsigned int pendingCount{ 0 };
+
+    // Guards pending and pendingCount.
+    mutable std::mutex lock;
+
+    // Signalled when a chain is retired or the reclaimer is shutting down.
+    std::condition_variable retired;
+
+    // Signalled whenever pendingCount drops to zero.
+    std::condition_variable drained;
+
+    // Set to tell the worker thread to exit.
+    bool stopping{ false };
+
+    // The background worker, if there is one.
+    std::thread worker;
+};
+
+template <typename T>
+NodeReclaimer<T>::NodeReclaimer(bool background)
+{
+    if (background)
+    {
+        worker = std::thread{ &NodeReclaimer<T>::work, this };
+    }
+}
+
+template <typename T>
+NodeReclaimer<T>::~NodeReclaimer()
+{
+    drain();
+
+    if (worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            stopping = true;
+        }
+
+        retired.notify_one();
+        worker.join();
+    }
+}
+
+template <typename T>
+void NodeReclaimer<T>::retire(ListNode<T>* first, unsigned int size, NodePool<T>&& pool)
+{
+    if (!first)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        pending.push_back(Chain{ first, std::move(pool) });
+        pendingCount += size;
+    }
+
+    retired.notify_one();
+}
+
+template <typename T>
+bool NodeReclaimer<T>::reclaim(unsigned int maxNodes)
+{
+    std::unique_lock<std::mutex> guard{ lock };
+
+    while (maxNodes > 0 && !pending.empty())
+    {
+        // Detach the oldest chain so it can be freed without holding the lock.
+        Chain chain{ std::move(pending.front()) };
+        pending.pop_front();
+        guard.unlock();
+
+        unsigned int freed{ freeNodes(chain, maxNodes) };
+        maxNodes -= freed;
+
+        guard.lock();
+        pendingCount -= freed;
+
+        if (chain.first)
+        {
+            // Ran out of budget part way through; put the rest back at the front.
+            pending.push_front(std::move(chain));
+        }
+    }
+
+    if (pendingCount == 0)
+    {
+        drained.notify_all();
+    }
+
+    return pendingCount == 0;
+}
+
+template <typename T>
+void NodeReclaimer<T>::drain()
+{
+    if (worker.joinable())
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        drained.wait(guard, [this] { return pendingCount == 0; });
+    }
+    else
+    {
+        while (!reclaim(NodePool<T>::blockCapacity))
+        {
+        }
+    }
+}
+
+template <typename T>
+unsigned int NodeReclaimer<T>::getPendingCount() const
+{
+    std::lock_guard<std::mutex> guard{ lock };
+    return pendingCount;
+}
+
+template <typename T>
+unsigned int NodeReclaimer<T>::freeNodes(Chain& chain, unsigned int maxNodes)
+{
+    unsigned int freed{ 0 };
+
+    while (chain.first && freed < maxNodes)
+    {
+        ListNode<T>* toDelete{ chain.first };
+        chain.first = toDelete->next;
+
+        if (chain.pool.owns(toDelete))
+        {
+            // The pool's blocks are released all at once when the chain is done.
+            toDelete->~ListNode<T>();
+        }
+        else
+        {
+            delete toDelete;
+        }
+
+        freed++;
+    }
+
+    if (!chain.first)
+    {
+        chain.pool.releaseAll();
+    }
+
+    return freed;
+}
+
+template <typename T>
+void NodeReclaimer<T>::work()
+{
+    std::unique_lock<std::mutex> guard{ lock };
+
+    while (true)
+    {
+        retired.wait(guard, [this] { return stopping || !pending.empty(); });
+
+        if (pending.empty())
+        {
+            // Only get here once stopping has been set and everything is freed.
+            return;
+        }
+
+        Chain chain{ std::move(pending.front()) };
+        pending.pop_front();
+        guard.unlock();
+
+        // Free in batches so that drain() and getPendingCount() see progress.
+        while (chain.first)
+        {
+            unsigned int freed{ freeNodes(chain, NodePool<T>::blockCapacity) };
+
+            guard.lock();
+            pendingCount -= freed;
+            if (pendingCount == 0)
+            {
+                drained.notify_all();
+            }
+            guard.unlock();
+        }
+
+        guard.lock();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "ThreadPool.h"
+
+// Sort items into ascending order and drop duplicates, spreading the work
+// across pool's threads. Each thread sorts and deduplicates its own slice,
+// then neighbouring slices are merged pairwise until one run is left.
+// Like LinkedSet, it only needs T to have > and ==.
+template <typename T>
+void parallelSortUnique(std::vector<T>& items, ThreadPool& pool)
+{
+    auto less{ [](const T& a, const T& b) { return b > a; } };
+    auto equal{ [](const T& a, const T& b) { return a == b; } };
+
+    // Below this, waking the threads costs more than it saves.
+    constexpr std::size_t minParallelSize{ 4096 };
+
+    unsigned int slices{ pool.getThreadCount() };
+    if (slices == 1 || items.size() < minParallelSize)
+    {
+        std::sort(items.begin(), items.end(), less);
+        items.erase(std::unique(items.begin(), items.end(), equal), items.end());
+        return;
+    }
+
+    // Sort and deduplicate each slice on its own.
+    std::vector<std::size_t> starts(slices + 1);
+    std::vector<std::size_t> ends(slices);
+    for (unsigned int slice{ 0 }; slice <= slices; slice++)
+    {
+        starts[slice] = items.size() * slice / slices;
+    }
+
+    pool.run(slices, [&](unsigned int slice) {
+        auto first{ items.begin() + starts[slice] };
+        auto last{ items.begin() + starts[slice + 1] };
+        std::sort(first, last, less);
+        ends[slice] = std::unique(first, last, equal) - items.begin();
+    });
+
+    // Close the gaps the duplicates left behind, so the slices are back to back.
+    std::size_t write{ ends[0] };
+    for (unsigned int slice{ 1 }; slice < slices; slice++)
+    {
+        std::size_t start{ write };
+        write = std::move(items.begin() + starts[slice], items.begin() + ends[slice], items.begin() + write) - items.begin();
+        starts[slice] = start;
+    }
+    starts[slices] = write;
+    items.erase(items.begin() + write, items.end());
+
+    // Merge neighbouring runs until there is only one.
+    for (unsigned int width{ 1 }; width < slices; width *= 2)
+    {
+        pool.run((slices + 2 * width - 1) / (2 * width), [&](unsigned int pair) {
+            unsigned int low{ pair * 2 * width };
+            unsigned int middle{ std::min(low + width, slices) };
+            unsigned int high{ std::min(low + 2 * width, slices) };
+            std::inplace_merge(items.begin() + starts[low], items.begin() + starts[middle], items.begin() + starts[high], less);
+        });
+    }
+
+    // Equal items from different slices are now next to each other.
+    items.erase(std::unique(items.begin(), items.end(), equal), items.end());
+}
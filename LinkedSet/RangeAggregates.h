@@ -0,0 +1,60 @@
+#pragma once
+#include <limits>
+
+// Aggregates a BPlusTree can keep for every subtree, so that the aggregate of
+// any range of items takes O(log n) rather than a walk over the range.
+//
+// An aggregate is a monoid over the items:
+//  - Value is what it produces,
+//  - of(item) is the value of a single item,
+//  - combine(a, b) joins the values of two runs of items, the ones of a all
+//    coming before the ones of b; it must be associative,
+//  - identity() is the value of no items: combine(identity(), a) and
+//    combine(a, identity()) are both a.
+// combine doesn't have to be commutative, since runs are always combined in
+// order. Any type with these members can be used, not just the ones here.
+
+// Sum of the items
+template <typename T>
+struct SumAggregate
+{
+    using Value = T;
+
+    static Value identity() { return T{}; }
+    static Value of(const T& item) { return item; }
+    static Value combine(const Value& a, const Value& b) { return a + b; }
+};
+
+// Number of items (BPlusTree::countInRange already does this; it's here
+// mostly as the simplest example)
+template <typename T>
+struct CountAggregate
+{
+    using Value = unsigned int;
+
+    static Value identity() { return 0; }
+    static Value of(const T&) { return 1; }
+    static Value combine(const Value& a, const Value& b) { return a + b; }
+};
+
+// Smallest item, or the largest value T can hold if there are none
+template <typename T>
+struct MinAggregate
+{
+    using Value = T;
+
+    static Value identity() { return std::numeric_limits<T>::max(); }
+    static Value of(const T& item) { return item; }
+    static Value combine(const Value& a, const Value& b) { return a > b ? b : a; }
+};
+
+// Largest item, or the smallest value T can hold if there are none
+template <typename T>
+struct MaxAggregate
+{
+    using Value = T;
+
+    static Value identity() { return std::numeric_limits<T>::lowest(); }
+    static Value of(const T& item) { return item; }
+    static Value combine(const Value& a, const Value& b) { return b > a ? b : a; }
+};
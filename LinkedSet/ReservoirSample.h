@@ -0,0 +1,74 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Draw a uniform random number in (0, 1).
+template <typename Random>
+double reservoirUniform(Random& random)
+{
+    std::uniform_real_distribution<double> distribution{ 0.0, 1.0 };
+    double u{ 0.0 };
+    while (u == 0.0)
+    {
+        u = distribution(random);
+    }
+    return u;
+}
+
+// Pick k of the items in [first, last) uniformly at random (all of them if
+// there are only k or fewer), in a single pass that doesn't need to know how
+// many items there are. The picks come back in no particular order.
+// Only the k slots of the result are allocated, up front. Rather than
+// drawing a random number for every item, each replacement draws how many
+// items to skip before the next one (Li's Algorithm L), so there are only
+// O(k log(n / k)) draws for n items.
+template <typename Iterator, typename Sentinel, typename Random>
+std::vector<typename std::iterator_traits<Iterator>::value_type> reservoirSample(Iterator first, Sentinel last, unsigned int k, Random& random)
+{
+    std::vector<typename std::iterator_traits<Iterator>::value_type> reservoir{};
+    if (k == 0)
+    {
+        return reservoir;
+    }
+
+    reservoir.reserve(k);
+    for (; first != last && reservoir.size() < k; ++first)
+    {
+        reservoir.push_back(*first);
+    }
+
+    if (first == last)
+    {
+        return reservoir;
+    }
+
+    // Think of every item as having a uniform random key, and the reservoir as
+    // the k items with the smallest keys: w is the largest key kept, and the
+    // number of items until one beats it is geometric in w.
+    double w{ std::exp(std::log(reservoirUniform(random)) / k) };
+    std::uniform_int_distribution<unsigned int> slot{ 0, k - 1 };
+    while (first != last)
+    {
+        double gap{ std::floor(std::log(reservoirUniform(random)) / std::log(1.0 - w)) };
+        std::uint64_t skip{ gap < 1e18 ? static_cast<std::uint64_t>(gap) : std::numeric_limits<std::uint64_t>::max() };
+        for (; skip > 0 && first != last; skip--)
+        {
+            ++first;
+        }
+
+        if (first == last)
+        {
+            break;
+        }
+
+        reservoir[slot(random)] = *first;
+        ++first;
+        w *= std::exp(std::log(reservoirUniform(random)) / k);
+    }
+
+    return reservoir;
+}
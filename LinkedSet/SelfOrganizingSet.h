@@ -0,0 +1,183 @@
+#pragma once
+#include <ostream>
+#include <utility>
+#include "LinkedList.h"
+
+// How a SelfOrganizingSet rearranges itself after a successful lookup.
+enum class Reorganization
+{
+    // Move the item to the front of the list.
+    MoveToFront,
+
+    // Swap the item with the one in front of it.
+    Transpose
+};
+
+// An unordered set stored in a linked list that keeps frequently used items
+// near the front: every successful lookup moves the item forward, so under
+// a skewed access pattern most lookups end after a few nodes.
+// Iteration visits the items in their current (access) order, not sorted.
+// List selects the list implementation, as for LinkedSet.
+template <typename T, typename List = LinkedList<T>>
+class SelfOrganizingSet
+{
+public:
+    // Construct an empty set that reorganizes itself as given.
+    explicit SelfOrganizingSet(Reorganization reorganization = Reorganization::MoveToFront);
+
+    // Check if the set contains a particular item, moving it forward if so.
+    // Returns true if the item is found; false otherwise.
+    bool contains(const T& item);
+
+    // Add an item to the front of the set if it doesn't already exist
+    // (if it does, it is moved forward as by contains()).
+    // Return true if an item was added; false otherwise.
+    bool add(const T& item);
+
+    // Remove an item from the set.
+    // Return true if an item was removed; false otherwise.
+    bool remove(const T& item);
+
+    // Remove all items from the set.
+    void clear();
+
+    // Get the number of elements in the set.
+    unsigned int getSize() const;
+
+    // Get how the set reorganizes itself.
+    Reorganization getReorganization() const;
+
+    // Create an iterator that starts at the most recently promoted item.
+    typename List::const_iterator begin() const;
+
+    // Create an iterator that has reached the end of the set.
+    typename List::const_iterator end() const;
+
+    template <typename T2, typename List2>
+    friend std::ostream& operator << (std::ostream& out, const SelfOrganizingSet<T2, List2>& set);
+
+private:
+    // The underlying linked list, in access order.
+    List list;
+
+    // What a successful lookup does.
+    Reorganization reorganization;
+};
+
+template <typename T, typename List>
+SelfOrganizingSet<T, List>::SelfOrganizingSet(Reorganization reorganization)
+    : reorganization{ reorganization }
+{
+}
+
+template <typename T, typename List>
+bool SelfOrganizingSet<T, List>::contains(const T& item)
+{
+    if (list.getSize() == 0)
+    {
+        return false;
+    }
+
+    // Already at the front; nothing to move.
+    if (list.getFirst() == item)
+    {
+        return true;
+    }
+
+    // Look one node ahead, since a singly-linked node can only be unlinked through its predecessor.
+    for (typename List::iterator i{ list.begin() }; i.hasNext(); i++)
+    {
+        if (i.peekNext() == item)
+        {
+            if (reorganization == Reorganization::MoveToFront)
+            {
+                T value{ std::move(i.peekNext()) };
+                i.removeNext();
+                list.addFirst(std::move(value));
+            }
+            else
+            {
+                // Swapping the values is the same as swapping the nodes, without relinking anything.
+                std::swap(*i, i.peekNext());
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename T, typename List>
+bool SelfOrganizingSet<T, List>::add(const T& item)
+{
+    if (contains(item))
+    {
+        return false;
+    }
+
+    list.addFirst(item);
+    return true;
+}
+
+template <typename T, typename List>
+bool SelfOrganizingSet<T, List>::remove(const T& item)
+{
+    if (list.getSize() == 0)
+    {
+        return false;
+    }
+
+    if (list.getFirst() == item)
+    {
+        list.removeFirst();
+        return true;
+    }
+
+    for (typename List::iterator i{ list.begin() }; i.hasNext(); i++)
+    {
+        if (i.peekNext() == item)
+        {
+            i.removeNext();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename T, typename List>
+void SelfOrganizingSet<T, List>::clear()
+{
+    list.clear();
+}
+
+template <typename T, typename List>
+unsigned int SelfOrganizingSet<T, List>::getSize() const
+{
+    return list.getSize();
+}
+
+template <typename T, typename List>
+Reorganization SelfOrganizingSet<T, List>::getReorganization() const
+{
+    return reorganization;
+}
+
+template <typename T, typename List>
+typename List::const_iterator SelfOrganizingSet<T, List>::begin() const
+{
+    return list.begin();
+}
+
+template <typename T, typename List>
+typename List::const_iterator SelfOrganizingSet<T, List>::end() const
+{
+    return list.end();
+}
+
+template <typename T, typename List>
+std::ostream& operator << (std::ostream& out, const SelfOrganizingSet<T, List>& set)
+{
+    out << set.list;
+    return out;
+}
@@ -0,0 +1,606 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "BPlusTree.h"
+#include "SimdSearch.h"
+
+// The ways an AdaptiveList can store its items.
+enum class SetRepresentation
+{
+    // A sorted array; the smallest and simplest, for small sets.
+    Array,
+
+    // A B+-tree, for large sets.
+    Tree,
+
+    // One bit per possible value, for dense integer keys.
+    Bitmap
+};
+
+// A sorted collection of distinct items behind a common interface, so that
+// an AdaptiveList can move its items from one representation to another.
+// Positions are opaque to the caller: an index for the array and the bitmap,
+// a tree iterator for the tree. Any change invalidates every position.
+template <typename T>
+class SetEngine
+{
+public:
+    // A place in the engine.
+    using Position = std::variant<std::size_t, ConstBPlusTreeIterator<T>>;
+
+    // Destructor
+    virtual ~SetEngine() = default;
+
+    // Get which representation this is.
+    virtual SetRepresentation getRepresentation() const = 0;
+
+    // Get number of items
+    virtual unsigned int getSize() const = 0;
+
+    // Get the smallest item; the engine must not be empty.
+    virtual T getFirst() const = 0;
+
+    // Get the biggest item; the engine must not be empty.
+    virtual T getLast() const = 0;
+
+    // Add an item that isn't there yet.
+    virtual void insert(const T& item) = 0;
+
+    // Remove an item that is there.
+    virtual void erase(const T& item) = 0;
+
+    // Remove the smallest item.
+    virtual void removeFirst() = 0;
+
+    // Remove the biggest item.
+    virtual void removeLast() = 0;
+
+    // Set position to the smallest item.
+    // Returns false if the engine is empty.
+    virtual bool begin(Position& position) const = 0;
+
+    // Move position to the next item.
+    // Returns false if there is none.
+    virtual bool next(Position& position) const = 0;
+
+    // Set position to the first item that isn't smaller than item.
+    // Returns false if there is none.
+    virtual bool lowerBound(const T& item, Position& position) const = 0;
+
+    // Set position to the last item smaller than item.
+    // Returns false if there is none.
+    virtual bool previous(const T& item, Position& position) const = 0;
+
+    // Get the item at a position.
+    virtual T value(const Position& position) const = 0;
+};
+
+// A SetEngine that keeps the items in a sorted std::vector.
+// Inserts shift the items after them, so it is only used for small sets.
+template <typename T>
+class ArrayEngine : public SetEngine<T>
+{
+public:
+    using typename SetEngine<T>::Position;
+
+    SetRepresentation getRepresentation() const override;
+    unsigned int getSize() const override;
+    T getFirst() const override;
+    T getLast() const override;
+    void insert(const T& item) override;
+    void erase(const T& item) override;
+    void removeFirst() override;
+    void removeLast() override;
+    bool begin(Position& position) const override;
+    bool next(Position& position) const override;
+    bool lowerBound(const T& item, Position& position) const override;
+    bool previous(const T& item, Position& position) const override;
+    T value(const Position& position) const override;
+
+private:
+    // Index of the first item that isn't smaller than item.
+    std::size_t search(const T& item) const;
+
+    // The items, in order
+    std::vector<T> items;
+};
+
+// A SetEngine that keeps the items in a BPlusTree.
+template <typename T>
+class TreeEngine : public SetEngine<T>
+{
+public:
+    using typename SetEngine<T>::Position;
+
+    SetRepresentation getRepresentation() const override;
+    unsigned int getSize() const override;
+    T getFirst() const override;
+    T getLast() const override;
+    void insert(const T& item) override;
+    void erase(const T& item) override;
+    void removeFirst() override;
+    void removeLast() override;
+    bool begin(Position& position) const override;
+    bool next(Position& position) const override;
+    bool lowerBound(const T& item, Position& position) const override;
+    bool previous(const T& item, Position& position) const override;
+    T value(const Position& position) const override;
+
+private:
+    // The items
+    BPlusTree<T> tree;
+};
+
+// A SetEngine for integer items that stores one bit per value between the
+// smallest and the biggest item. Words that empty at either end are dropped,
+// so the smallest and biggest items are always in the first and last word.
+template <typename T>
+class BitmapEngine : public SetEngine<T>
+{
+    static_assert(std::is_integral<T>::value, "BitmapEngine needs integer items");
+
+public:
+    using typename SetEngine<T>::Position;
+
+    SetRepresentation getRepresentation() const override;
+    unsigned int getSize() const override;
+    T getFirst() const override;
+    T getLast() const override;
+    void insert(const T& item) override;
+    void erase(const T& item) override;
+    void removeFirst() override;
+    void removeLast() override;
+    bool begin(Position& position) const override;
+    bool next(Position& position) const override;
+    bool lowerBound(const T& item, Position& position) const override;
+    bool previous(const T& item, Position& position) const override;
+    T value(const Position& position) const override;
+
+private:
+    // Unsigned counterpart of T, so offsets can't overflow.
+    using Unsigned = std::make_unsigned_t<T>;
+
+    // Bit number of an item; only meaningful for items inside the words.
+    std::uint64_t bitOf(const T& item) const;
+
+    // Find the first set bit at or after bit, or the last one before it.
+    // Returns false if there is none.
+    bool findSetFrom(std::uint64_t bit, std::size_t& found) const;
+    bool findSetBefore(std::uint64_t bit, std::size_t& found) const;
+
+    // The value of bit 0
+    T base{};
+
+    // The bits, 64 values per word
+    std::deque<std::uint64_t> words;
+
+    // Number of bits set
+    unsigned int count{ 0 };
+};
+
+//
+// ArrayEngine
+//
+
+template <typename T>
+SetRepresentation ArrayEngine<T>::getRepresentation() const
+{
+    return SetRepresentation::Array;
+}
+
+template <typename T>
+unsigned int ArrayEngine<T>::getSize() const
+{
+    return static_cast<unsigned int>(items.size());
+}
+
+template <typename T>
+T ArrayEngine<T>::getFirst() const
+{
+    return items.front();
+}
+
+template <typename T>
+T ArrayEngine<T>::getLast() const
+{
+    return items.back();
+}
+
+template <typename T>
+void ArrayEngine<T>::insert(const T& item)
+{
+    // Appending in order is the common case, and doesn't need a search.
+    if (items.empty() || item > items.back())
+    {
+        items.push_back(item);
+        return;
+    }
+
+    items.insert(items.begin() + static_cast<std::ptrdiff_t>(search(item)), item);
+}
+
+template <typename T>
+void ArrayEngine<T>::erase(const T& item)
+{
+    items.erase(items.begin() + static_cast<std::ptrdiff_t>(search(item)));
+}
+
+template <typename T>
+void ArrayEngine<T>::removeFirst()
+{
+    items.erase(items.begin());
+}
+
+template <typename T>
+void ArrayEngine<T>::removeLast()
+{
+    items.pop_back();
+}
+
+template <typename T>
+bool ArrayEngine<T>::begin(Position& position) const
+{
+    position = std::size_t{ 0 };
+    return !items.empty();
+}
+
+template <typename T>
+bool ArrayEngine<T>::next(Position& position) const
+{
+    return ++std::get<0>(position) < items.size();
+}
+
+template <typename T>
+bool ArrayEngine<T>::lowerBound(const T& item, Position& position) const
+{
+    position = search(item);
+    return std::get<0>(position) < items.size();
+}
+
+template <typename T>
+bool ArrayEngine<T>::previous(const T& item, Position& position) const
+{
+    std::size_t index{ search(item) };
+    position = index - 1;
+    return index > 0;
+}
+
+template <typename T>
+T ArrayEngine<T>::value(const Position& position) const
+{
+    return items[std::get<0>(position)];
+}
+
+template <typename T>
+std::size_t ArrayEngine<T>::search(const T& item) const
+{
+    // The array is small, so a vectorized count beats a binary search.
+    return simdCountLess(items.data(), static_cast<unsigned int>(items.size()), item);
+}
+
+//
+// TreeEngine
+//
+
+template <typename T>
+SetRepresentation TreeEngine<T>::getRepresentation() const
+{
+    return SetRepresentation::Tree;
+}
+
+template <typename T>
+unsigned int TreeEngine<T>::getSize() const
+{
+    return tree.getSize();
+}
+
+template <typename T>
+T TreeEngine<T>::getFirst() const
+{
+    return tree.getFirst();
+}
+
+template <typename T>
+T TreeEngine<T>::getLast() const
+{
+    return tree.getLast();
+}
+
+template <typename T>
+void TreeEngine<T>::insert(const T& item)
+{
+    // Appending in order fills each leaf before starting the next.
+    if (tree.getSize() == 0 || item > tree.getLast())
+    {
+        tree.addLast(item);
+        return;
+    }
+
+    MutableBPlusTreeIterator<T> i{ tree.findPrevious(item) };
+    if (i == tree.end())
+    {
+        tree.addFirst(item);
+    }
+    else
+    {
+        i.addNext(item);
+    }
+}
+
+template <typename T>
+void TreeEngine<T>::erase(const T& item)
+{
+    MutableBPlusTreeIterator<T> i{ tree.findPrevious(item) };
+    if (i == tree.end())
+    {
+        tree.removeFirst();
+    }
+    else
+    {
+        i.removeNext();
+    }
+}
+
+template <typename T>
+void TreeEngine<T>::removeFirst()
+{
+    tree.removeFirst();
+}
+
+template <typename T>
+void TreeEngine<T>::removeLast()
+{
+    erase(tree.getLast());
+}
+
+template <typename T>
+bool TreeEngine<T>::begin(Position& position) const
+{
+    position = tree.begin();
+    return tree.getSize() > 0;
+}
+
+template <typename T>
+bool TreeEngine<T>::next(Position& position) const
+{
+    return ++std::get<1>(position) != tree.end();
+}
+
+template <typename T>
+bool TreeEngine<T>::lowerBound(const T& item, Position& position) const
+{
+    position = tree.lowerBound(item);
+    return std::get<1>(position) != tree.end();
+}
+
+template <typename T>
+bool TreeEngine<T>::previous(const T& item, Position& position) const
+{
+    position = tree.findPrevious(item);
+    return std::get<1>(position) != tree.end();
+}
+
+template <typename T>
+T TreeEngine<T>::value(const Position& position) const
+{
+    return *std::get<1>(position);
+}
+
+//
+// BitmapEngine
+//
+
+template <typename T>
+SetRepresentation BitmapEngine<T>::getRepresentation() const
+{
+    return SetRepresentation::Bitmap;
+}
+
+template <typename T>
+unsigned int BitmapEngine<T>::getSize() const
+{
+    return count;
+}
+
+template <typename T>
+T BitmapEngine<T>::getFirst() const
+{
+    return static_cast<T>(static_cast<Unsigned>(base) + std::countr_zero(words.front()));
+}
+
+template <typename T>
+T BitmapEngine<T>::getLast() const
+{
+    std::uint64_t bit{ 64 * (words.size() - 1) + 63 - std::countl_zero(words.back()) };
+    return static_cast<T>(static_cast<Unsigned>(base) + static_cast<Unsigned>(bit));
+}
+
+template <typename T>
+void BitmapEngine<T>::insert(const T& item)
+{
+    if (words.empty())
+    {
+        base = item;
+        words.push_back(0);
+    }
+
+    if (base > item)
+    {
+        // Grow by whole words towards the item, but not past the smallest T.
+        // Distances are taken unsigned, so they can't overflow or wrap.
+        std::uint64_t distance{ static_cast<Unsigned>(static_cast<Unsigned>(base) - static_cast<Unsigned>(item)) };
+        std::uint64_t room{ static_cast<Unsigned>(static_cast<Unsigned>(base) - static_cast<Unsigned>(std::numeric_limits<T>::min())) };
+        std::uint64_t shift{ std::min((distance + 63) / 64 * 64, room) };
+
+        // Near the minimum the shift may not be whole words, so move the bits up within them.
+        unsigned int bits{ static_cast<unsigned int>(shift % 64) };
+        if (bits > 0)
+        {
+            words.push_back(0);
+            for (std::size_t i{ words.size() - 1 }; i > 0; i--)
+            {
+                words[i] = (words[i] << bits) | (words[i - 1] >> (64 - bits));
+            }
+            words.front() <<= bits;
+            if (words.back() == 0)
+            {
+                words.pop_back();
+            }
+        }
+
+        words.insert(words.begin(), shift / 64, 0);
+        base = static_cast<T>(static_cast<Unsigned>(base) - static_cast<Unsigned>(shift));
+    }
+
+    std::uint64_t bit{ bitOf(item) };
+    while (bit >= 64 * words.size())
+    {
+        words.push_back(0);
+    }
+
+    words[bit / 64] |= std::uint64_t{ 1 } << (bit % 64);
+    count++;
+}
+
+template <typename T>
+void BitmapEngine<T>::erase(const T& item)
+{
+    std::uint64_t bit{ bitOf(item) };
+    words[bit / 64] &= ~(std::uint64_t{ 1 } << (bit % 64));
+    count--;
+
+    // Drop empty words at both ends, so the ends are always found in O(1).
+    while (!words.empty() && words.front() == 0)
+    {
+        words.pop_front();
+        base = static_cast<T>(static_cast<Unsigned>(base) + 64);
+    }
+    while (!words.empty() && words.back() == 0)
+    {
+        words.pop_back();
+    }
+}
+
+template <typename T>
+void BitmapEngine<T>::removeFirst()
+{
+    erase(getFirst());
+}
+
+template <typename T>
+void BitmapEngine<T>::removeLast()
+{
+    erase(getLast());
+}
+
+template <typename T>
+bool BitmapEngine<T>::begin(Position& position) const
+{
+    std::size_t found{ 0 };
+    bool any{ findSetFrom(0, found) };
+    position = found;
+    return any;
+}
+
+template <typename T>
+bool BitmapEngine<T>::next(Position& position) const
+{
+    std::size_t& bit{ std::get<0>(position) };
+    return findSetFrom(bit + 1, bit);
+}
+
+template <typename T>
+bool BitmapEngine<T>::lowerBound(const T& item, Position& position) const
+{
+    if (count == 0 || item > getLast())
+    {
+        return false;
+    }
+
+    std::size_t found{ 0 };
+    findSetFrom(base > item ? 0 : bitOf(item), found);
+    position = found;
+    return true;
+}
+
+template <typename T>
+bool BitmapEngine<T>::previous(const T& item, Position& position) const
+{
+    if (count == 0 || !(item > getFirst()))
+    {
+        return false;
+    }
+
+    std::size_t found{ 0 };
+    findSetBefore(item > getLast() ? 64 * words.size() : bitOf(item), found);
+    position = found;
+    return true;
+}
+
+template <typename T>
+T BitmapEngine<T>::value(const Position& position) const
+{
+    return static_cast<T>(static_cast<Unsigned>(base) + static_cast<Unsigned>(std::get<0>(position)));
+}
+
+template <typename T>
+std::uint64_t BitmapEngine<T>::bitOf(const T& item) const
+{
+    return static_cast<Unsigned>(static_cast<Unsigned>(item) - static_cast<Unsigned>(base));
+}
+
+template <typename T>
+bool BitmapEngine<T>::findSetFrom(std::uint64_t bit, std::size_t& found) const
+{
+    std::size_t word{ static_cast<std::size_t>(bit / 64) };
+    if (word >= words.size())
+    {
+        return false;
+    }
+
+    // Mask off the bits before the start, then skip whole empty words.
+    std::uint64_t bits{ words[word] & (~std::uint64_t{ 0 } << (bit % 64)) };
+    while (bits == 0)
+    {
+        if (++word == words.size())
+        {
+            return false;
+        }
+        bits = words[word];
+    }
+
+    found = 64 * word + std::countr_zero(bits);
+    return true;
+}
+
+template <typename T>
+bool BitmapEngine<T>::findSetBefore(std::uint64_t bit, std::size_t& found) const
+{
+    if (bit == 0)
+    {
+        return false;
+    }
+
+    // Look from the bit just before, masking off the bits from it on.
+    std::uint64_t last{ bit - 1 };
+    std::size_t word{ static_cast<std::size_t>(last / 64) };
+    std::uint64_t bits{ words[word] & (~std::uint64_t{ 0 } >> (63 - last % 64)) };
+    while (bits == 0)
+    {
+        if (word == 0)
+        {
+            return false;
+        }
+        bits = words[--word];
+    }
+
+    found = 64 * word + 63 - std::countl_zero(bits);
+    return true;
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define SIMDSEARCH_X86
+#endif
+
+// Functions compiled for an instruction set the build doesn't assume, only
+// called once the CPU is known to support it. MSVC needs no annotation.
+#if defined(SIMDSEARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMDSEARCH_SSE2 __attribute__((target("sse2")))
+#define SIMDSEARCH_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMDSEARCH_SSE2
+#define SIMDSEARCH_AVX2
+#endif
+
+// Vectorized counting over contiguous arrays of items, e.g. the nodes of a
+// BPlusTree or a FrozenSet. For std::int32_t, std::int64_t, float and signed
+// char the items are compared 4 to 32 at a time with SSE2 or AVX2, picked at
+// run time from what the CPU supports; other types (and other CPUs) use a
+// plain loop. Items are compared with > like everywhere else.
+
+// The instruction sets the kernels can use, from slowest to fastest.
+enum class SimdLevel
+{
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+// Get the fastest level this CPU supports (checked once).
+inline SimdLevel getSimdLevel();
+
+// Count the items smaller than key; for sorted items that's where key
+// would go, like std::lower_bound.
+template <typename T>
+unsigned int simdCountLess(const T* items, unsigned int count, const T& key, SimdLevel level = getSimdLevel());
+
+// Count the items in [low, high), in any order.
+template <typename T>
+unsigned int simdCountInRange(const T* items, unsigned int count, const T& low, const T& high, SimdLevel level = getSimdLevel());
+
+// What a kernel counts
+enum class SimdComparison
+{
+    // Items smaller than the first key
+    Less,
+
+    // Items in [first key, second key)
+    InRange
+};
+
+// Plain loop, for the tail of the array and for the other types.
+template <SimdComparison comparison, typename T>
+unsigned int simdCountScalar(const T* items, unsigned int count, const T& first, const T& second)
+{
+    unsigned int n{ 0 };
+    for (unsigned int i{ 0 }; i < count; i++)
+    {
+        if constexpr (comparison == SimdComparison::Less)
+        {
+            n += first > items[i] ? 1 : 0;
+        }
+        else
+        {
+            n += !(first > items[i]) && second > items[i] ? 1 : 0;
+        }
+    }
+    return n;
+}
+
+#ifdef SIMDSEARCH_X86
+// Lane operations for each type and instruction set: load a vector,
+// broadcast an item, and get a bit mask of the lanes where a > b.
+// Types without a specialization have no kernel at that level
+// (SSE2 has no 64-bit comparison).
+template <typename T>
+struct SimdSse2Lanes
+{
+    static constexpr bool supported{ false };
+};
+
+template <typename T>
+struct SimdAvx2Lanes
+{
+    static constexpr bool supported{ false };
+};
+
+template <>
+struct SimdSse2Lanes<std::int32_t>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 4 };
+    using Vector = __m128i;
+    SIMDSEARCH_SSE2 static Vector load(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    SIMDSEARCH_SSE2 static Vector broadcast(std::int32_t item) { return _mm_set1_epi32(item); }
+    SIMDSEARCH_SSE2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b)))); }
+};
+
+template <>
+struct SimdSse2Lanes<signed char>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 16 };
+    using Vector = __m128i;
+    SIMDSEARCH_SSE2 static Vector load(const signed char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    SIMDSEARCH_SSE2 static Vector broadcast(signed char item) { return _mm_set1_epi8(item); }
+    SIMDSEARCH_SSE2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(a, b))); }
+};
+
+template <>
+struct SimdSse2Lanes<float>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 4 };
+    using Vector = __m128;
+    SIMDSEARCH_SSE2 static Vector load(const float* p) { return _mm_loadu_ps(p); }
+    SIMDSEARCH_SSE2 static Vector broadcast(float item) { return _mm_set1_ps(item); }
+    SIMDSEARCH_SSE2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(a, b))); }
+};
+
+template <>
+struct SimdAvx2Lanes<std::int32_t>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 8 };
+    using Vector = __m256i;
+    SIMDSEARCH_AVX2 static Vector load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    SIMDSEARCH_AVX2 static Vector broadcast(std::int32_t item) { return _mm256_set1_epi32(item); }
+    SIMDSEARCH_AVX2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)))); }
+};
+
+template <>
+struct SimdAvx2Lanes<std::int64_t>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 4 };
+    using Vector = __m256i;
+    SIMDSEARCH_AVX2 static Vector load(const std::int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    SIMDSEARCH_AVX2 static Vector broadcast(std::int64_t item) { return _mm256_set1_epi64x(item); }
+    SIMDSEARCH_AVX2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)))); }
+};
+
+template <>
+struct SimdAvx2Lanes<signed char>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 32 };
+    using Vector = __m256i;
+    SIMDSEARCH_AVX2 static Vector load(const signed char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    SIMDSEARCH_AVX2 static Vector broadcast(signed char item) { return _mm256_set1_epi8(item); }
+    SIMDSEARCH_AVX2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(a, b))); }
+};
+
+template <>
+struct SimdAvx2Lanes<float>
+{
+    static constexpr bool supported{ true };
+    static constexpr unsigned int width{ 8 };
+    using Vector = __m256;
+    SIMDSEARCH_AVX2 static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+    SIMDSEARCH_AVX2 static Vector broadcast(float item) { return _mm256_set1_ps(item); }
+    SIMDSEARCH_AVX2 static std::uint32_t greater(Vector a, Vector b) { return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ))); }
+};
+
+// The kernels are the same at both levels, but each has to be compiled for its own instruction set.
+template <typename Lanes, SimdComparison comparison, typename T>
+SIMDSEARCH_SSE2 unsigned int simdCountSse2(const T* items, unsigned int count, T first, T second)
+{
+    typename Lanes::Vector firsts{ Lanes::broadcast(first) };
+    typename Lanes::Vector seconds{ Lanes::broadcast(second) };
+    unsigned int n{ 0 };
+    unsigned int i{ 0 };
+    for (; i + Lanes::width <= count; i += Lanes::width)
+    {
+        typename Lanes::Vector block{ Lanes::load(items + i) };
+        std::uint32_t lanes{ Lanes::greater(firsts, block) };
+        if constexpr (comparison == SimdComparison::InRange)
+        {
+            lanes = ~lanes & Lanes::greater(seconds, block);
+        }
+        n += static_cast<unsigned int>(std::popcount(lanes));
+    }
+
+    return n + simdCountScalar<comparison>(items + i, count - i, first, second);
+}
+
+template <typename Lanes, SimdComparison comparison, typename T>
+SIMDSEARCH_AVX2 unsigned int simdCountAvx2(const T* items, unsigned int count, T first, T second)
+{
+    typename Lanes::Vector firsts{ Lanes::broadcast(first) };
+    typename Lanes::Vector seconds{ Lanes::broadcast(second) };
+    unsigned int n{ 0 };
+    unsigned int i{ 0 };
+    for (; i + Lanes::width <= count; i += Lanes::width)
+    {
+        typename Lanes::Vector block{ Lanes::load(items + i) };
+        std::uint32_t lanes{ Lanes::greater(firsts, block) };
+        if constexpr (comparison == SimdComparison::InRange)
+        {
+            lanes = ~lanes & Lanes::greater(seconds, block);
+        }
+        n += static_cast<unsigned int>(std::popcount(lanes));
+    }
+
+    return n + simdCountScalar<comparison>(items + i, count - i, first, second);
+}
+#endif
+
+// Run the best kernel for T at or below level.
+template <SimdComparison comparison, typename T>
+unsigned int simdCount(const T* items, unsigned int count, const T& first, const T& second, SimdLevel level)
+{
+#ifdef SIMDSEARCH_X86
+    if constexpr (SimdAvx2Lanes<T>::supported)
+    {
+        if (level == SimdLevel::Avx2)
+        {
+            return simdCountAvx2<SimdAvx2Lanes<T>, comparison>(items, count, first, second);
+        }
+    }
+    if constexpr (SimdSse2Lanes<T>::supported)
+    {
+        if (level != SimdLevel::Scalar)
+        {
+            return simdCountSse2<SimdSse2Lanes<T>, comparison>(items, count, first, second);
+        }
+    }
+#else
+    (void)level;
+#endif
+    return simdCountScalar<comparison>(items, count, first, second);
+}
+
+// Ask the CPU (and, for AVX, the OS) what it supports.
+inline SimdLevel detectSimdLevel()
+{
+#if defined(SIMDSEARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return SimdLevel::Sse2;
+    }
+#elif defined(SIMDSEARCH_X86) && defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 0);
+    int leaves{ info[0] };
+    __cpuid(info, 1);
+    bool sse2{ (info[3] & (1 << 26)) != 0 };
+
+    // AVX registers are only usable if the OS saves them (OSXSAVE, then XCR0).
+    bool avx{ (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6 };
+    if (avx && leaves >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        if ((info[1] & (1 << 5)) != 0)
+        {
+            return SimdLevel::Avx2;
+        }
+    }
+    if (sse2)
+    {
+        return SimdLevel::Sse2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+inline SimdLevel getSimdLevel()
+{
+    static const SimdLevel level{ detectSimdLevel() };
+    return level;
+}
+
+template <typename T>
+unsigned int simdCountLess(const T* items, unsigned int count, const T& key, SimdLevel level)
+{
+    return simdCount<SimdComparison::Less>(items, count, key, key, level);
+}
+
+template <typename T>
+unsigned int simdCountInRange(const T* items, unsigned int count, const T& low, const T& high, SimdLevel level)
+{
+    return simdCount<SimdComparison::InRange>(items, count, low, high, level);
+}
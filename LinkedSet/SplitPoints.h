@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Evenly spaced positions along a list, so that the list can be cut into
+// segments of (nearly) equal length and each segment handed to a different
+// thread. Finding the positions takes one walk over the list; they are kept
+// until invalidate() is called, or until the list reports (through its
+// invalidation count) that nodes were freed or moved, e.g. by an iterator
+// handed out earlier, so repeated traversals skip that walk.
+// Copies start out empty, since positions only make sense for their own list.
+template <typename Iterator>
+class SplitPoints
+{
+public:
+    // Default constructor
+    SplitPoints() = default;
+
+    // Copy constructor; the copy has no positions yet.
+    SplitPoints(const SplitPoints<Iterator>& original);
+
+    // Copy assignment op; forgets the current positions.
+    SplitPoints<Iterator>& operator= (const SplitPoints<Iterator>& original);
+
+    // Forget the positions (the list has changed).
+    void invalidate();
+
+    // Get segments + 1 positions splitting a list of size elements into
+    // segments pieces; the last position is the end of the list. The
+    // positions are found again if the list's size or invalidation count
+    // has changed since they were cached.
+    // Safe to call from several threads at once.
+    template <typename List>
+    std::vector<Iterator> get(const List& list, unsigned int size, unsigned int segments) const;
+
+private:
+    // The cached positions, or empty if they need to be found again.
+    mutable std::vector<Iterator> points;
+
+    // The list's size and invalidation count when points were found.
+    mutable unsigned int listSize{ 0 };
+    mutable std::uint64_t listInvalidations{ 0 };
+
+    // Guards points against concurrent rebuilds.
+    mutable std::mutex lock;
+};
+
+template <typename Iterator>
+SplitPoints<Iterator>::SplitPoints(const SplitPoints<Iterator>& original)
+{
+}
+
+template <typename Iterator>
+SplitPoints<Iterator>& SplitPoints<Iterator>::operator= (const SplitPoints<Iterator>& original)
+{
+    invalidate();
+    return *this;
+}
+
+template <typename Iterator>
+void SplitPoints<Iterator>::invalidate()
+{
+    std::lock_guard<std::mutex> guard{ lock };
+    points.clear();
+}
+
+template <typename Iterator>
+template <typename List>
+std::vector<Iterator> SplitPoints<Iterator>::get(const List& list, unsigned int size, unsigned int segments) const
+{
+    std::lock_guard<std::mutex> guard{ lock };
+
+    if (points.size() != segments + 1 || listSize != size || listInvalidations != list.getInvalidations())
+    {
+        listSize = size;
+        listInvalidations = list.getInvalidations();
+        points.clear();
+        points.reserve(segments + 1);
+
+        // The first size % segments segments get one extra element.
+        Iterator i{ list.begin() };
+        for (unsigned int segment{ 0 }; segment < segments; segment++)
+        {
+            points.push_back(i);
+
+            unsigned int length{ size / segments + (segment < size % segments ? 1 : 0) };
+            for (unsigned int step{ 0 }; step < length; step++)
+            {
+                ++i;
+            }
+        }
+
+        points.push_back(list.end());
+    }
+
+    return points;
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads for running data-parallel loops.
+// run() hands out the indices of a loop to the workers and the calling
+// thread, and returns once every index has been processed.
+// Only one loop runs at a time; tasks must not call run() on the same pool.
+class ThreadPool
+{
+public:
+    // Construct a pool that runs loops on threadCount threads in total
+    // (the thread calling run() counts as one of them).
+    explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+
+    // Destructor; stops and joins the workers.
+    ~ThreadPool();
+
+    // A pool owns threads, so it can't be copied.
+    ThreadPool(const ThreadPool& original) = delete;
+    ThreadPool& operator= (const ThreadPool& original) = delete;
+
+    // Get the number of threads loops are spread across.
+    unsigned int getThreadCount() const;
+
+    // Call task(i) for every i in [0, count), spread across the pool.
+    // If any call throws, the first exception is rethrown once all calls are done.
+    void run(unsigned int count, const std::function<void(unsigned int)>& task);
+
+    // Get a pool shared by the whole program, sized to the hardware.
+    static ThreadPool& shared();
+
+private:
+    // Claim and run indices of the current loop until there are none left.
+    void work();
+
+    // Body of each worker thread.
+    void wait();
+
+    // The worker threads.
+    std::vector<std::thread> workers;
+
+    // The loop being run, if any.
+    const std::function<void(unsigned int)>* task{ nullptr };
+
+    // Number of indices in the loop being run.
+    unsigned int count{ 0 };
+
+    // Next index of the loop to hand out.
+    std::atomic<unsigned int> next{ 0 };
+
+    // Number of indices of the loop that haven't finished yet.
+    std::atomic<unsigned int> unfinished{ 0 };
+
+    // Number of workers currently taking part in a loop.
+    unsigned int busy{ 0 };
+
+    // Bumped every time a new loop starts.
+    unsigned long long generation{ 0 };
+
+    // First exception thrown by the loop being run.
+    std::exception_ptr error;
+
+    // Set to tell the workers to exit.
+    bool stopping{ false };
+
+    // Guards everything above apart from next and unfinished.
+    std::mutex lock;
+
+    // Makes sure only one loop runs at a time.
+    std::mutex running;
+
+    // Signalled when a loop starts or the pool is shutting down.
+    std::condition_variable started;
+
+    // Signalled when a loop's last index finishes or a worker leaves it.
+    std::condition_variable finished;
+};
+
+inline ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    for (unsigned int i{ 1 }; i < threadCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::wait, this);
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        stopping = true;
+    }
+
+    started.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+inline unsigned int ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+inline void ThreadPool::run(unsigned int count, const std::function<void(unsigned int)>& task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> serial{ running };
+
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        this->task = &task;
+        this->count = count;
+        next = 0;
+        unfinished = count;
+        error = nullptr;
+        generation++;
+    }
+
+    started.notify_all();
+
+    // The calling thread helps out rather than sitting idle.
+    work();
+
+    std::unique_lock<std::mutex> guard{ lock };
+    finished.wait(guard, [this] { return unfinished == 0 && busy == 0; });
+    this->task = nullptr;
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+inline ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool{};
+    return pool;
+}
+
+inline void ThreadPool::work()
+{
+    while (true)
+    {
+        unsigned int i{ next++ };
+        if (i >= count)
+        {
+            return;
+        }
+
+        try
+        {
+            (*task)(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        if (--unfinished == 0)
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            finished.notify_all();
+        }
+    }
+}
+
+inline void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard{ lock };
+    unsigned long long seen{ generation };
+
+    while (true)
+    {
+        started.wait(guard, [&] { return stopping || generation != seen; });
+
+        if (stopping)
+        {
+            return;
+        }
+
+        seen = generation;
+        if (!task)
+        {
+            // Woke up too late; the loop has already finished.
+            continue;
+        }
+
+        // Join the loop; run() won't return until this worker has left it.
+        busy++;
+        guard.unlock();
+
+        work();
+
+        guard.lock();
+        busy--;
+        finished.notify_all();
+    }
+}
@@ -2,9 +2,29 @@
 #include "CppUnitTest.h"
 #include <ctime>
 #include <chrono>
+#include <cmath>
 #include <array>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
 #include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <ranges>
+#include <vector>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <thread>
 #include "../LinkedSet/LinkedSet.h"
+#include "../LinkedSet/IndexedLinkedList.h"
+#include "../LinkedSet/DoublyLinkedList.h"
+#include "../LinkedSet/SelfOrganizingSet.h"
+#include "../LinkedSet/ExpiringSet.h"
+#include "../LinkedSet/BoundedSet.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -1907,5 +1927,3300 @@ namespace LinkedSetTests
 
             checkSetEmpty(set);
         }
+
+        TEST_METHOD(Compact_PreservesOrder)
+        {
+            LinkedList<int> list {};
+            LinkedList<int> other {};
+
+            // Interleave allocations with another list so that neighbouring nodes are scattered.
+            for (int i = 0; i < 5000; i++)
+            {
+                list.addLast(i);
+                other.addLast(-i);
+            }
+
+            // Compact a little at a time.
+            unsigned int calls { 0 };
+            while (!list.compact(100))
+            {
+                calls++;
+                Assert::IsTrue(calls <= 50, L"compact() should finish after visiting every node");
+            }
+
+            Assert::AreEqual(49u, calls, L"Number of incremental compact() calls");
+            Assert::AreEqual(5000u, list.getSize(), L"getSize()");
+            Assert::AreEqual(0, list.getFirst(), L"getFirst()");
+            Assert::AreEqual(4999, list.getLast(), L"getLast()");
+
+            // Values are preserved, and consecutive nodes are now adjacent in memory.
+            unsigned int adjacent { 0 };
+            int expected { 0 };
+            const int* previous { nullptr };
+            for (const int& value : list)
+            {
+                Assert::AreEqual(expected, value, L"Element visited by iterator");
+
+                if (previous && reinterpret_cast<const char*>(&value) - reinterpret_cast<const char*>(previous) == sizeof(ListNode<int>))
+                {
+                    adjacent++;
+                }
+
+                previous = &value;
+                expected++;
+            }
+
+            Assert::IsTrue(adjacent >= 4999u - 5000u / NodePool<int>::blockCapacity, L"Compacted nodes should be contiguous");
+
+            // Compacting again leaves the nodes where they are.
+            std::vector<const int*> addresses {};
+            for (const int& value : list)
+            {
+                addresses.push_back(&value);
+            }
+            Assert::IsTrue(list.compact(), L"compact() of a compacted list");
+            unsigned int index { 0 };
+            for (const int& value : list)
+            {
+                Assert::IsTrue(addresses[index] == &value, L"Compacted nodes shouldn't move again");
+                index++;
+            }
+
+            // The list should still behave normally afterwards.
+            list.addFirst(-1);
+            list.removeFirst();
+            list.removeFirst();
+            Assert::AreEqual(1, list.getFirst(), L"getFirst()");
+            Assert::AreEqual(4999u, list.getSize(), L"getSize()");
+        }
+
+        TEST_METHOD(Compact_SettlesAfterInsert)
+        {
+            LinkedList<int> list {};
+            for (int i { 0 }; i < 500; i++)
+            {
+                list.addLast(i * 2);
+            }
+            list.compact();
+
+            // One heap node near the front pushes the rest of the pass after it.
+            auto i { list.begin() };
+            ++i;
+            i.addNext(3);
+            list.compact();
+
+            std::vector<const int*> addresses {};
+            for (const int& value : list)
+            {
+                addresses.push_back(&value);
+            }
+
+            // Further passes with no changes in between leave every node where it is.
+            for (int pass { 0 }; pass < 2; pass++)
+            {
+                Assert::IsTrue(list.compact(), L"compact() after an insert");
+                unsigned int index { 0 };
+                for (const int& value : list)
+                {
+                    Assert::IsTrue(addresses[index] == &value, L"Compacted nodes shouldn't move again");
+                    index++;
+                }
+                Assert::AreEqual(501u, index, L"Number of nodes");
+            }
+        }
+
+        TEST_METHOD(Compact_MutateBetweenCalls)
+        {
+            LinkedSet<signed char> set {};
+
+            std::array<signed char, 100> numbersAdded {};
+            for (int i { 0 }; i < 100; i++)
+            {
+                numbersAdded[i] = static_cast<signed char>(i - 50);
+            }
+
+            // Add in a scrambled order.
+            std::array<signed char, 100> scrambled { numbersAdded };
+            std::shuffle(scrambled.begin(), scrambled.end(), std::default_random_engine { static_cast<unsigned int>(rand()) });
+            for (signed char n : scrambled)
+            {
+                set.add(n);
+            }
+
+            // Remove and re-add elements (including the ones just compacted) between compact() calls.
+            for (int i { 0 }; i < 100; i++)
+            {
+                set.compact(3);
+
+                Assert::IsTrue(set.remove(scrambled[i]), L"remove() was expected to return true.");
+                Assert::IsTrue(set.add(scrambled[i]), L"add() was expected to return true.");
+            }
+
+            while (!set.compact(7))
+            {
+            }
+
+            checkSetOrdered(numbersAdded, set);
+        }
+
+        TEST_METHOD(Compact_MemoryLeakCheck)
+        {
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            for (unsigned int i { 0 }; i < 100; i++)
+            {
+                {
+                    LinkedList<int> list {};
+                    for (int j = 0; j < 1000; j++)
+                    {
+                        list.addLast(j);
+                    }
+
+                    // Compact twice so the second pass moves nodes out of the first pass's blocks
+                    // (a new node at the front puts every node after it out of place).
+                    list.compact();
+                    list.addFirst(-1);
+                    list.compact(500);
+                    list.removeFirst();
+
+                    LinkedList<int> moved { std::move(list) };
+                    moved.compact();
+                }
+                // Destructor for the list should have been called.
+
+                _CrtMemCheckpoint(&state2);
+
+                // If this assertion fails, you have a memory leak.
+                Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+
+                state1 = state2;
+            }
+        }
+
+        TEST_METHOD(Reclaimer_IncrementalBatches)
+        {
+            NodeReclaimer<int> reclaimer {};
+
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            {
+                LinkedList<int> list {};
+                list.setReclaimer(&reclaimer);
+                for (int i = 0; i < 10000; i++)
+                {
+                    list.addLast(i);
+                }
+
+                // Compact part of the list so the reclaimer has to handle pooled nodes too.
+                list.compact(5000);
+
+                // Clearing just detaches the nodes.
+                list.clear();
+                checkList(std::array<int, 0>{}, list);
+                Assert::AreEqual(10000u, reclaimer.getPendingCount(), L"getPendingCount()");
+
+                // The list is still usable, and destroying it hands over the new nodes too.
+                for (int i = 0; i < 100; i++)
+                {
+                    list.addFirst(i);
+                }
+            }
+
+            Assert::AreEqual(10100u, reclaimer.getPendingCount(), L"getPendingCount()");
+
+            // Free the nodes a bounded batch at a time.
+            unsigned int batches { 0 };
+            while (!reclaimer.reclaim(1000))
+            {
+                batches++;
+                Assert::AreEqual(10100u - 1000u * batches, reclaimer.getPendingCount(), L"getPendingCount()");
+            }
+
+            Assert::AreEqual(10u, batches, L"Number of reclaim() batches");
+            Assert::AreEqual(0u, reclaimer.getPendingCount(), L"getPendingCount()");
+
+            _CrtMemCheckpoint(&state2);
+
+            // If this assertion fails, you have a memory leak.
+            Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+        }
+
+        TEST_METHOD(Reclaimer_BackgroundDrain)
+        {
+            std::shared_ptr<int> tracked { std::make_shared<int>(42) };
+
+            NodeReclaimer<std::shared_ptr<int>> reclaimer { true };
+
+            for (int round = 0; round < 10; round++)
+            {
+                LinkedList<std::shared_ptr<int>> list {};
+                list.setReclaimer(&reclaimer);
+                for (int i = 0; i < 10000; i++)
+                {
+                    list.addLast(tracked);
+                }
+
+                LinkedList<std::shared_ptr<int>> replacement {};
+                replacement.addLast(tracked);
+
+                // Replacing the contents hands the old chain to the reclaimer as well.
+                list = std::move(replacement);
+                Assert::AreEqual(1u, list.getSize(), L"getSize()");
+            }
+
+            // Wait for the worker to free everything.
+            reclaimer.drain();
+
+            Assert::AreEqual(0u, reclaimer.getPendingCount(), L"getPendingCount()");
+            Assert::AreEqual(1L, static_cast<long>(tracked.use_count()), L"Every node should have been destroyed");
+        }
+
+        TEST_METHOD(Reclaimer_LinkedSetClear)
+        {
+            NodeReclaimer<signed char> reclaimer {};
+
+            LinkedSet<signed char> set {};
+            set.setReclaimer(&reclaimer);
+            for (int n { -100 }; n < 100; n++)
+            {
+                set.add(static_cast<signed char>(n));
+            }
+
+            set.clear();
+            checkSetEmpty(set);
+            Assert::AreEqual(200u, reclaimer.getPendingCount(), L"getPendingCount()");
+
+            // Going back to inline freeing.
+            set.setReclaimer(nullptr);
+            set.add(1);
+            set.clear();
+            Assert::AreEqual(200u, reclaimer.getPendingCount(), L"getPendingCount()");
+
+            reclaimer.drain();
+            Assert::AreEqual(0u, reclaimer.getPendingCount(), L"getPendingCount()");
+        }
+
+        TEST_METHOD(Pooled_CopyDuplicatesBlocks)
+        {
+            LinkedList<int> original {};
+            original.setPooledStorage(true);
+            for (int i = 0; i < 10000; i++)
+            {
+                original.addLast(i);
+            }
+
+            // Punch some holes so the copied free lists get exercised too.
+            for (int i = 0; i < 100; i++)
+            {
+                original.removeFirst();
+            }
+
+            LinkedList<int> copy { original };
+            Assert::AreEqual(9900u, copy.getSize(), L"getSize()");
+            Assert::AreEqual(100, copy.getFirst(), L"getFirst()");
+            Assert::AreEqual(9999, copy.getLast(), L"getLast()");
+
+            // The copy reuses the holes it inherited, independently of the original.
+            for (int i = 99; i >= 0; i--)
+            {
+                copy.addFirst(i);
+            }
+            copy.addLast(10000);
+
+            int expected { 0 };
+            for (auto i { copy.begin() }; i != copy.end(); i++)
+            {
+                Assert::AreEqual(expected, *i, L"Element visited by iterator");
+                *i = -1;
+                expected++;
+            }
+            Assert::AreEqual(10001, expected, L"Number of elements visited by iterator");
+
+            // Overwriting the copy must not have touched the original.
+            expected = 100;
+            for (int value : original)
+            {
+                Assert::AreEqual(expected, value, L"Element visited by iterator");
+                expected++;
+            }
+            Assert::AreEqual(10000, expected, L"Number of elements visited by iterator");
+
+            // Copy assignment takes the same route.
+            copy = original;
+            Assert::AreEqual(9900u, copy.getSize(), L"getSize()");
+            Assert::AreEqual(100, copy.getFirst(), L"getFirst()");
+            Assert::AreEqual(9999, copy.getLast(), L"getLast()");
+        }
+
+        TEST_METHOD(Pooled_MemoryLeakCheck)
+        {
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            for (unsigned int i { 0 }; i < 100; i++)
+            {
+                {
+                    LinkedList<int> list {};
+                    list.setPooledStorage(true);
+                    for (int j = 0; j < 1000; j++)
+                    {
+                        list.addFirst(j);
+                    }
+
+                    LinkedList<int> copy { list };
+                    list.clear();
+                    list.addLast(1);
+                    copy = list;
+                }
+                // Destructors should have released every block.
+
+                _CrtMemCheckpoint(&state2);
+
+                // If this assertion fails, you have a memory leak.
+                Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+
+                state1 = state2;
+            }
+        }
+
+        TEST_METHOD(Pooled_NonTrivialType)
+        {
+            std::shared_ptr<int> tracked { std::make_shared<int>(7) };
+
+            {
+                LinkedList<std::shared_ptr<int>> list {};
+                list.setPooledStorage(true);
+                for (int i = 0; i < 1000; i++)
+                {
+                    list.addLast(tracked);
+                }
+
+                // Not trivially copyable, so this copies node by node.
+                LinkedList<std::shared_ptr<int>> copy { list };
+                Assert::AreEqual(2001L, static_cast<long>(tracked.use_count()), L"use_count()");
+
+                // Not trivially destructible, so clear() has to destroy every node.
+                list.clear();
+                Assert::AreEqual(1001L, static_cast<long>(tracked.use_count()), L"use_count()");
+            }
+
+            Assert::AreEqual(1L, static_cast<long>(tracked.use_count()), L"use_count()");
+        }
+
+        TEST_METHOD(Pooled_SetAddRemove)
+        {
+            LinkedSet<signed char> set {};
+            set.setPooledStorage(true);
+
+            std::array<signed char, 100> numbersAdded {};
+            for (int i { 0 }; i < 100; i++)
+            {
+                numbersAdded[i] = static_cast<signed char>(2 * i - 100);
+                Assert::IsTrue(set.add(numbersAdded[i]), L"add() was expected to return true.");
+            }
+
+            // Remove and re-add every element.
+            for (signed char n : numbersAdded)
+            {
+                Assert::IsTrue(set.remove(n), L"remove() was expected to return true.");
+                Assert::IsTrue(set.add(n), L"add() was expected to return true.");
+            }
+
+            LinkedSet<signed char> copy { set };
+            set.clear();
+            checkSetEmpty(set);
+            checkSetOrdered(numbersAdded, copy);
+        }
+
+        TEST_METHOD(Inline_SmallSetAllocationFree)
+        {
+            // Magic to tell us if there's a memory allocation.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            LinkedSet<signed char> set {};
+            std::array<signed char, 8> numbersAdded { -128, 127, -1, 0, 1, 42, -42, 100 };
+            for (signed char n : numbersAdded)
+            {
+                Assert::IsTrue(set.add(n), L"add() was expected to return true.");
+            }
+
+            // Remove and re-add a few elements so the free slots are not just the last ones.
+            Assert::IsTrue(set.remove(-1), L"remove() was expected to return true.");
+            Assert::IsTrue(set.remove(127), L"remove() was expected to return true.");
+            Assert::IsTrue(set.add(127), L"add() was expected to return true.");
+            Assert::IsTrue(set.add(-1), L"add() was expected to return true.");
+
+            checkSetOrdered(numbersAdded, set);
+
+            _CrtMemCheckpoint(&state2);
+
+            // If this assertion fails, the small set allocated memory.
+            Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Unexpected allocation");
+
+            // Growing past the inline capacity moves the elements to the heap.
+            std::array<signed char, 9> moreNumbers { -128, 127, -1, 0, 1, 42, -42, 100, 50 };
+            Assert::IsTrue(set.add(50), L"add() was expected to return true.");
+            checkSetOrdered(moreNumbers, set);
+
+            // Once empty again, the set goes back to inline storage.
+            for (signed char n : moreNumbers)
+            {
+                Assert::IsTrue(set.remove(n), L"remove() was expected to return true.");
+            }
+            checkSetEmpty(set);
+            set.add(1);
+            Assert::IsTrue(set.contains(1), L"Set does not contain an expected item.");
+        }
+
+        TEST_METHOD(Inline_SpillDuringAddNext)
+        {
+            const int capacity { static_cast<int>(LinkedList<int>::inlineCapacity) };
+
+            LinkedList<int> list {};
+            for (int i = 0; i < capacity; i++)
+            {
+                list.addLast(2 * i);
+            }
+
+            // The first addNext() has to move every node to the heap while the iterator is in use.
+            for (auto i { list.begin() }; i != list.end(); i++)
+            {
+                i.addNext(*i + 1);
+                i++; // Advance to the new node.
+            }
+
+            std::array<int, 2 * LinkedList<int>::inlineCapacity> expected {};
+            for (int i = 0; i < 2 * capacity; i++)
+            {
+                expected[i] = i;
+            }
+
+            checkList(expected, list);
+        }
+
+        TEST_METHOD(Inline_BigNodesTakeNoSpace)
+        {
+            // Nodes too big to keep inline don't leave an unused slot in every list.
+            using Big = std::array<char, 200>;
+            Assert::AreEqual(0u, LinkedList<Big>::inlineCapacity, L"inlineCapacity");
+            Assert::IsTrue(sizeof(LinkedList<Big>) < sizeof(ListNode<Big>), L"sizeof(LinkedList<Big>)");
+
+            LinkedList<Big> list {};
+            Big item {};
+            for (char c { 'a' }; c <= 'c'; c++)
+            {
+                item[0] = c;
+                list.addLast(item);
+            }
+            Assert::IsFalse(list.isInline(), L"isInline()");
+            list.removeFirst();
+            Assert::AreEqual('b', list.getFirst()[0], L"getFirst()");
+            Assert::AreEqual('c', list.getLast()[0], L"getLast()");
+        }
+
+        TEST_METHOD(Inline_MoveRelocatesNodes)
+        {
+            LinkedList<std::string> small {};
+            small.addLast("a");
+            small.addLast("b");
+
+            LinkedList<std::string> large {};
+            for (int i = 0; i < 20; i++)
+            {
+                large.addLast(std::to_string(i));
+            }
+
+            for (int i = 0; i < 3; i++)
+            {
+                std::swap(small, large);
+            }
+
+            Assert::AreEqual(20u, small.getSize(), L"getSize()");
+            Assert::IsTrue(small.getFirst() == "0", L"getFirst()");
+            Assert::IsTrue(small.getLast() == "19", L"getLast()");
+
+            Assert::AreEqual(2u, large.getSize(), L"getSize()");
+            Assert::IsTrue(large.isInline(), L"isInline()");
+
+            // The moved nodes must still be usable.
+            large.addFirst("z");
+            large.removeFirst();
+            large.addLast("c");
+
+            std::string joined {};
+            for (const std::string& item : large)
+            {
+                joined += item;
+            }
+            Assert::IsTrue(joined == "abc", L"Elements visited by iterator");
+            Assert::IsTrue(large.getLast() == "c", L"getLast()");
+        }
+
+        TEST_METHOD(Indexed_AddFirstAddLastRemoveFirst)
+        {
+            // Links are 32 bits, so an int node takes 8 bytes instead of 16.
+            Assert::AreEqual(8u, static_cast<unsigned int>(sizeof(IndexedListNode<int>)), L"sizeof(IndexedListNode<int>)");
+
+            IndexedLinkedList<int> list {};
+
+            // Try to remove from an empty list.
+            Assert::ExpectException<std::logic_error>([&] { list.removeFirst(); }, L"removeFirst() - expected exception");
+            Assert::ExpectException<std::logic_error>([&] { list.getFirst(); }, L"getFirst()");
+            Assert::ExpectException<std::logic_error>([&] { list.getLast(); }, L"getLast()");
+
+            for (int i = 0; i < 10; i++)
+            {
+                list.addFirst(9 - i);
+                list.addLast(10 + i);
+                Assert::AreEqual(9 - i, list.getFirst(), L"getFirst()");
+                Assert::AreEqual(10 + i, list.getLast(), L"getLast()");
+                Assert::AreEqual(2u * i + 2u, list.getSize(), L"getSize()");
+            }
+
+            for (int i = 0; i < 5; i++)
+            {
+                list.removeFirst();
+            }
+
+            // Freed slots are reused before the array grows.
+            for (int i = 4; i >= 0; i--)
+            {
+                list.addFirst(i);
+            }
+            Assert::AreEqual(20u, static_cast<unsigned int>(list.getNodes().size()), L"Number of slots");
+
+            int expected { 0 };
+            for (int value : list)
+            {
+                Assert::AreEqual(expected, value, L"Element visited by iterator");
+                expected++;
+            }
+            Assert::AreEqual(20, expected, L"Number of elements visited by iterator");
+
+            // Copies are independent.
+            IndexedLinkedList<int> copy { list };
+            list.clear();
+            Assert::AreEqual(0u, list.getSize(), L"getSize()");
+            Assert::AreEqual(20u, copy.getSize(), L"getSize()");
+            Assert::AreEqual(0, copy.getFirst(), L"getFirst()");
+            Assert::AreEqual(19, copy.getLast(), L"getLast()");
+        }
+
+        TEST_METHOD(Indexed_AddNextRemoveNext)
+        {
+            IndexedLinkedList<int> list {};
+            for (int i = 0; i < 10; i++)
+            {
+                list.addLast(2 * i);
+            }
+
+            // Add the odd numbers in between; the node array grows while iterating.
+            for (auto i { list.begin() }; i != list.end(); i++)
+            {
+                i.addNext(*i + 1);
+                i++; // Advance to the new node.
+            }
+
+            Assert::AreEqual(19, list.getLast(), L"getLast()");
+
+            // Remove them again.
+            for (auto i { list.begin() }; i != list.end(); i++)
+            {
+                Assert::AreEqual(*i + 1, i.peekNext(), L"peekNext()");
+                i.removeNext();
+            }
+
+            Assert::AreEqual(10u, list.getSize(), L"getSize()");
+            Assert::AreEqual(18, list.getLast(), L"getLast()");
+
+            auto i { list.begin() };
+            for (int n = 0; n < 10; n++)
+            {
+                Assert::AreEqual(2 * n, *i, L"Element visited by iterator");
+                i++;
+            }
+            Assert::IsTrue(i == list.end(), L"end()");
+        }
+
+        TEST_METHOD(Indexed_LinkedSet)
+        {
+            LinkedSet<signed char, IndexedLinkedList<signed char>> set {};
+
+            std::array<signed char, 12> numbersAdded { 5, -3, 100, -100, 0, 42, -42, 7, 8, -9, 11, 1 };
+            for (signed char n : numbersAdded)
+            {
+                Assert::IsTrue(set.add(n), L"add() was expected to return true.");
+                Assert::IsFalse(set.add(n), L"add() was expected to return false.");
+            }
+
+            Assert::IsTrue(set.remove(5), L"remove() was expected to return true.");
+            Assert::IsTrue(set.remove(-100), L"remove() was expected to return true.");
+            Assert::IsFalse(set.remove(-100), L"remove() was expected to return false.");
+            Assert::AreEqual(10u, set.getSize(), L"size");
+
+            std::array<signed char, 10> expected { -42, -9, -3, 0, 1, 7, 8, 11, 42, 100 };
+            unsigned int i { 0 };
+            for (signed char n : set)
+            {
+                Assert::AreEqual(expected[i], n, L"Element visited by iterator");
+                i++;
+            }
+            Assert::AreEqual(10u, i, L"Number of elements visited by iterator");
+
+            for (int n { -128 }; n < 128; n++)
+            {
+                bool added { std::find(expected.begin(), expected.end(), n) != expected.end() };
+                Assert::AreEqual(added, set.contains(static_cast<signed char>(n)), L"contains()");
+            }
+        }
+
+        TEST_METHOD(Indexed_MoveLeavesOriginalEmpty)
+        {
+            IndexedLinkedList<int> original {};
+            for (int n { 0 }; n < 10; n++)
+            {
+                original.addLast(n);
+            }
+
+            IndexedLinkedList<int> moved { std::move(original) };
+            Assert::AreEqual(10u, moved.getSize(), L"size after moving");
+            Assert::AreEqual(0u, original.getSize(), L"size of the moved-from list");
+            Assert::IsTrue(original.begin() == original.end(), L"Iterating the moved-from list");
+            original.addLast(42);
+            Assert::AreEqual(42, original.getFirst(), L"Reusing the moved-from list");
+
+            original = std::move(moved);
+            Assert::AreEqual(10u, original.getSize(), L"size after assigning");
+            Assert::AreEqual(9, original.getLast(), L"getLast() after assigning");
+            Assert::AreEqual(0u, moved.getSize(), L"size of the moved-from list");
+            moved.addFirst(7);
+            Assert::AreEqual(7, moved.getLast(), L"Reusing the moved-from list");
+
+            IndexedLinkedList<int> copy { original };
+            copy.removeFirst();
+            Assert::AreEqual(0, original.getFirst(), L"Copies are independent");
+            Assert::AreEqual(1, copy.getFirst(), L"getFirst() of the copy");
+        }
+
+        TEST_METHOD(Doubly_AddRemoveErase)
+        {
+            DoublyLinkedList<int> list {};
+            for (int n { 0 }; n < 10; n++)
+            {
+                list.addLast(n);
+            }
+
+            // Erase every even element through the iterator.
+            for (auto i { list.begin() }; i != list.end();)
+            {
+                if (*i % 2 == 0)
+                {
+                    i = list.erase(i);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+
+            Assert::AreEqual(5u, list.getSize(), L"size");
+            Assert::AreEqual(1, list.getFirst(), L"getFirst()");
+            Assert::AreEqual(9, list.getLast(), L"getLast()");
+
+            list.removeLast();
+            list.removeFirst();
+            Assert::AreEqual(3, list.getFirst(), L"getFirst()");
+            Assert::AreEqual(7, list.getLast(), L"getLast()");
+
+            auto i { list.begin() };
+            i.addNext(4);
+            i.removeNext();
+            i.removeNext();
+            Assert::AreEqual(2u, list.getSize(), L"size");
+            Assert::AreEqual(7, list.getLast(), L"getLast()");
+
+            list.erase(list.begin());
+            list.erase(list.begin());
+            Assert::AreEqual(0u, list.getSize(), L"size");
+            Assert::ExpectException<std::out_of_range>([&] { list.getLast(); });
+            Assert::ExpectException<std::out_of_range>([&] { list.removeLast(); });
+        }
+
+        TEST_METHOD(Doubly_ReverseIteration)
+        {
+            DoublyLinkedList<int> list {};
+            for (int n { 0 }; n < 100; n++)
+            {
+                list.addFirst(n);
+            }
+
+            // The list holds 99..0, so walking it backwards counts up.
+            int expected { 0 };
+            for (auto i { list.rbegin() }; i != list.rend(); i++)
+            {
+                Assert::AreEqual(expected, *i, L"Element visited by reverse iterator");
+                expected++;
+            }
+            Assert::AreEqual(100, expected, L"Number of elements visited by reverse iterator");
+
+            auto i { list.end() };
+            --i;
+            Assert::AreEqual(0, *i, L"Decrementing end()");
+            i--;
+            Assert::AreEqual(1, *i, L"Decrementing iterator");
+
+            DoublyLinkedList<int> copy { list };
+            list.clear();
+            Assert::AreEqual(100u, copy.getSize(), L"size of copy");
+            Assert::AreEqual(0, *copy.rbegin(), L"Last element of copy");
+        }
+
+        TEST_METHOD(Doubly_LinkedSetLargestN)
+        {
+            LinkedSet<signed char, DoublyLinkedList<signed char>> set {};
+
+            std::array<signed char, 12> numbersAdded { 5, -3, 100, -100, 0, 42, -42, 7, 8, -9, 11, 1 };
+            for (signed char n : numbersAdded)
+            {
+                Assert::IsTrue(set.add(n), L"add() was expected to return true.");
+                Assert::IsFalse(set.add(n), L"add() was expected to return false.");
+            }
+
+            std::array<signed char, 3> largest { 100, 42, 11 };
+            auto i { set.rbegin() };
+            for (signed char n : largest)
+            {
+                Assert::AreEqual(n, *i, L"Element visited by reverse iterator");
+                i++;
+            }
+
+            // Drop everything below zero in place.
+            for (auto j { set.begin() }; j != set.end() && *j < 0;)
+            {
+                j = set.erase(j);
+            }
+
+            Assert::AreEqual(8u, set.getSize(), L"size");
+            Assert::IsFalse(set.contains(-3), L"contains()");
+            Assert::IsTrue(set.remove(0), L"remove() was expected to return true.");
+            Assert::IsTrue(set.remove(100), L"remove() was expected to return true.");
+            Assert::AreEqual(static_cast<signed char>(42), *set.rbegin(), L"Largest element");
+        }
+
+        TEST_METHOD(Iterators_ModelStandardConcepts)
+        {
+            static_assert(std::forward_iterator<ConstLinkedListIterator<int>>);
+            static_assert(std::forward_iterator<MutableLinkedListIterator<int>>);
+            static_assert(std::forward_iterator<ConstIndexedListIterator<int>>);
+            static_assert(std::forward_iterator<MutableIndexedListIterator<int>>);
+            static_assert(std::bidirectional_iterator<ConstDoublyLinkedListIterator<int>>);
+            static_assert(std::bidirectional_iterator<MutableDoublyLinkedListIterator<int>>);
+            static_assert(std::sentinel_for<std::default_sentinel_t, ConstLinkedListIterator<int>>);
+            static_assert(std::ranges::forward_range<LinkedSet<int>>);
+            static_assert(std::ranges::forward_range<const LinkedSet<int>>);
+            static_assert(std::ranges::bidirectional_range<LinkedSet<int, DoublyLinkedList<int>>>);
+
+            LinkedList<int> list {};
+            for (int n { 0 }; n < 20; n++)
+            {
+                list.addLast(n);
+            }
+
+            Assert::AreEqual(std::ptrdiff_t { 20 }, std::distance(list.begin(), list.end()), L"std::distance()");
+            Assert::AreEqual(std::ptrdiff_t { 20 }, std::ranges::distance(list.begin(), std::default_sentinel), L"Distance to sentinel");
+
+            auto i { list.begin() };
+            auto old { i++ };
+            Assert::AreEqual(0, *old, L"Post-increment returns the old position");
+            Assert::AreEqual(1, *i, L"Post-increment advances");
+
+            // Writing through a mutable iterator with a std algorithm.
+            std::fill(list.begin(), list.end(), 7);
+            Assert::AreEqual(std::ptrdiff_t { 20 }, std::count(list.begin(), list.end(), 7), L"std::fill()");
+        }
+
+        TEST_METHOD(Iterators_LazyViewsOverLinkedSet)
+        {
+            LinkedSet<int> set {};
+            for (int n { 0 }; n < 100; n++)
+            {
+                set.add((n * 37) % 100);
+            }
+
+            auto squaresOfOdds { set
+                | std::views::filter([](int n) { return n % 2 == 1; })
+                | std::views::transform([](int n) { return n * n; }) };
+
+            int expected { 1 };
+            int count { 0 };
+            for (int square : squaresOfOdds)
+            {
+                Assert::AreEqual(expected * expected, square, L"Element visited by view");
+                expected += 2;
+                count++;
+            }
+            Assert::AreEqual(50, count, L"Number of elements visited by view");
+
+            Assert::IsTrue(std::ranges::is_sorted(set), L"std::ranges::is_sorted()");
+            Assert::AreEqual(42, *std::ranges::find(set, 42), L"std::ranges::find()");
+            Assert::IsTrue(std::ranges::find(set, 100) == set.end(), L"std::ranges::find() miss");
+
+            std::vector<int> taken {};
+            std::ranges::copy(set | std::views::take(5), std::back_inserter(taken));
+            Assert::AreEqual(std::size_t { 5 }, taken.size(), L"views::take()");
+            Assert::AreEqual(4, taken.back(), L"views::take()");
+        }
+
+        TEST_METHOD(Parallel_ForEachReduceCountIf)
+        {
+            ThreadPool pool { 4 };
+            LinkedSet<int> set {};
+            for (int n { 9999 }; n >= 0; n--)
+            {
+                set.add(n);
+            }
+
+            std::atomic<long long> total { 0 };
+            set.parallelForEach([&](int n) { total += n; }, pool);
+            Assert::AreEqual(49995000LL, total.load(), L"parallelForEach()");
+
+            long long sum { set.parallelReduce(0LL, [](long long a, long long b) { return a + b; }, pool) };
+            Assert::AreEqual(49995000LL, sum, L"parallelReduce()");
+
+            // The result type may be one that items only convert to with narrowing.
+            double average { set.parallelReduce(0.5, [](double a, double b) { return a + b; }, pool) / 10000 };
+            Assert::AreEqual(4999.50005, average, 1e-9, L"parallelReduce() into a double");
+
+            // Reduction order must follow the list, so a non-commutative op still works.
+            LinkedSet<std::string> words {};
+            for (int n { 4999 }; n >= 0; n--)
+            {
+                words.add(std::string(n % 26 + 1, static_cast<char>('a' + n % 26)) + std::to_string(n + 10000));
+            }
+            std::string joined { words.parallelReduce(std::string { ">" }, [](const std::string& a, const std::string& b) { return a + b; }, pool) };
+            std::string expected { ">" };
+            for (const std::string& word : words)
+            {
+                expected += word;
+            }
+            Assert::IsTrue(expected == joined, L"parallelReduce() keeps list order");
+
+            Assert::AreEqual(5000u, set.parallelCountIf([](int n) { return n % 2 == 0; }, pool), L"parallelCountIf()");
+
+            // Changing the set must drop the split points found for it.
+            for (int n { 0 }; n < 5000; n++)
+            {
+                set.remove(n * 2);
+            }
+            set.add(-1);
+            Assert::AreEqual(0u, set.parallelCountIf([](int n) { return n % 2 == 0; }, pool), L"parallelCountIf() after remove");
+            Assert::AreEqual(5001u, set.parallelCountIf([](int n) { return n % 2 != 0; }, pool), L"parallelCountIf() after add");
+
+            LinkedSet<int> copy { set };
+            set.clear();
+            Assert::AreEqual(0u, set.parallelCountIf([](int) { return true; }, pool), L"parallelCountIf() after clear");
+            Assert::AreEqual(5001u, copy.parallelCountIf([](int) { return true; }, pool), L"parallelCountIf() on copy");
+        }
+
+        TEST_METHOD(Parallel_ExceptionPropagates)
+        {
+            ThreadPool pool { 4 };
+            LinkedSet<int> set {};
+            for (int n { 9999 }; n >= 0; n--)
+            {
+                set.add(n);
+            }
+
+            Assert::ExpectException<std::runtime_error>([&] {
+                set.parallelForEach([](int n) {
+                    if (n == 1234)
+                    {
+                        throw std::runtime_error("bad item");
+                    }
+                }, pool);
+            });
+
+            // The pool is still usable afterwards.
+            Assert::AreEqual(10000u, set.parallelCountIf([](int) { return true; }, pool), L"parallelCountIf()");
+        }
+
+        TEST_METHOD(Parallel_NodesRemovedThroughIterator)
+        {
+            ThreadPool pool { 4 };
+            LinkedSet<int> set {};
+            for (int n { 19999 }; n >= 0; n--)
+            {
+                set.add(n);
+            }
+
+            // Find split points, then free the nodes they point at behind the set's back.
+            auto i { set.begin() };
+            for (int n { 0 }; n < 99; n++)
+            {
+                ++i;
+            }
+            Assert::AreEqual(20000u, set.parallelCountIf([](int) { return true; }, pool), L"parallelCountIf()");
+            for (int n { 100 }; n < 15000; n++)
+            {
+                i.removeNext();
+            }
+
+            std::atomic<long long> total { 0 };
+            set.parallelForEach([&](int n) { total += n; }, pool);
+            Assert::AreEqual(87502450LL, total.load(), L"parallelForEach() after removing through an iterator");
+            Assert::AreEqual(5100u, set.parallelCountIf([](int) { return true; }, pool), L"parallelCountIf() after removing through an iterator");
+        }
+
+        TEST_METHOD(Parallel_ScalingBenchmark)
+        {
+            LinkedSet<int> set {};
+            for (int n { 19999 }; n >= 0; n--)
+            {
+                set.add(n);
+            }
+
+            // Something a little more expensive than a comparison per item.
+            auto isPrime { [](int n) {
+                if (n < 2)
+                {
+                    return false;
+                }
+                for (int d { 2 }; d * d <= n; d++)
+                {
+                    if (n % d == 0)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            } };
+
+            unsigned int maxThreads { std::max(std::thread::hardware_concurrency(), 1u) };
+            for (unsigned int threads { 1 }; threads <= maxThreads; threads *= 2)
+            {
+                ThreadPool pool { threads };
+                auto start { std::chrono::steady_clock::now() };
+                unsigned int primes { 0 };
+                for (int repeat { 0 }; repeat < 20; repeat++)
+                {
+                    primes = set.parallelCountIf(isPrime, pool);
+                }
+                std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+
+                Assert::AreEqual(2262u, primes, L"parallelCountIf()");
+                std::wstring message { L"parallelCountIf, " + std::to_wstring(threads) + L" threads: " + std::to_wstring(time.count()) + L" ms\n" };
+                Logger::WriteMessage(message.c_str());
+            }
+        }
+
+        TEST_METHOD(Bulk_MatchesRepeatedAdd)
+        {
+            ThreadPool pool { 4 };
+            std::default_random_engine random { static_cast<unsigned int>(rand()) };
+            std::uniform_int_distribution<int> values { -3000, 3000 };
+
+            std::vector<int> items {};
+            for (int i { 0 }; i < 8000; i++)
+            {
+                items.push_back(values(random));
+            }
+
+            LinkedSet<int> added {};
+            for (int item : items)
+            {
+                added.add(item);
+            }
+
+            LinkedSet<int> built { items, pool };
+            Assert::AreEqual(added.getSize(), built.getSize(), L"size");
+            Assert::IsTrue(std::ranges::equal(added, built), L"Same elements in the same order");
+
+            // The bulk-built set behaves like any other afterwards.
+            Assert::IsTrue(built.add(5000), L"add() was expected to return true.");
+            Assert::IsFalse(built.add(items[0]), L"add() was expected to return false.");
+            Assert::IsTrue(built.remove(items[0]), L"remove() was expected to return true.");
+            Assert::AreEqual(5000, built.parallelReduce(-10000, [](int a, int b) { return std::max(a, b); }, pool), L"Largest element");
+        }
+
+        TEST_METHOD(Bulk_SmallAndOtherLists)
+        {
+            ThreadPool pool { 4 };
+
+            LinkedSet<int> empty { std::vector<int> {}, pool };
+            Assert::AreEqual(0u, empty.getSize(), L"size");
+
+            LinkedSet<int> small { std::vector<int> { 3, 1, 2, 3, 1 }, pool };
+            Assert::AreEqual(3u, small.getSize(), L"size");
+            Assert::IsTrue(std::ranges::equal(small, std::array<int, 3> { 1, 2, 3 }), L"Elements");
+
+            std::vector<signed char> items {};
+            for (int i { 0 }; i < 10000; i++)
+            {
+                items.push_back(static_cast<signed char>((i * 7919) % 256 - 128));
+            }
+            LinkedSet<signed char, IndexedLinkedList<signed char>> indexed { items, pool };
+            Assert::AreEqual(256u, indexed.getSize(), L"size");
+            Assert::AreEqual(static_cast<signed char>(-128), *indexed.begin(), L"Smallest element");
+
+            // Lists that keep their nodes in a pool are built one node at a time.
+            LinkedList<int> pooled {};
+            pooled.setPooledStorage(true);
+            std::vector<int> sequence(5000);
+            std::iota(sequence.begin(), sequence.end(), 0);
+            pooled.addLastRange(sequence.data(), 5000, pool);
+            Assert::AreEqual(5000u, pooled.getSize(), L"size");
+            Assert::AreEqual(4999, pooled.getLast(), L"getLast()");
+            Assert::IsTrue(std::ranges::equal(pooled, sequence), L"Elements");
+        }
+
+        TEST_METHOD(Bulk_ItemsWithOnlyGreaterAndEqual)
+        {
+            // Bulk construction needs no more of the items than add() does.
+            struct Version
+            {
+                int major;
+                int minor;
+
+                bool operator > (const Version& other) const
+                {
+                    return major > other.major || (major == other.major && minor > other.minor);
+                }
+
+                bool operator == (const Version& other) const
+                {
+                    return major == other.major && minor == other.minor;
+                }
+            };
+
+            std::vector<Version> items {};
+            for (int i { 0 }; i < 10000; i++)
+            {
+                items.push_back({ (i * 7919) % 100, i % 3 });
+            }
+
+            // One thread sorts everything in one go; more sort slices and merge them.
+            ThreadPool single { 1 };
+            ThreadPool pool { 4 };
+            for (ThreadPool* threads : { &single, &pool })
+            {
+                LinkedSet<Version> set { items, *threads };
+                Assert::AreEqual(300u, set.getSize(), L"size");
+                Assert::IsTrue(set.getFirst() == Version { 0, 0 } && set.getLast() == Version { 99, 2 }, L"Ends");
+                Assert::IsTrue(std::ranges::is_sorted(set, [](const Version& a, const Version& b) { return b > a; }), L"Sorted");
+            }
+        }
+
+        TEST_METHOD(Bulk_MemoryLeakCheck)
+        {
+            ThreadPool pool { 4 };
+            std::vector<int> items(20000);
+            for (int i { 0 }; i < 20000; i++)
+            {
+                items[i] = (i * 7919) % 20000;
+            }
+
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            for (unsigned int i { 0 }; i < 10; i++)
+            {
+                {
+                    LinkedList<int> list {};
+                    list.addLast(-1);
+                    list.addLastRange(items.data(), 20000, pool);
+                    Assert::AreEqual(20001u, list.getSize(), L"size");
+
+                    LinkedSet<int> set { items, pool };
+                    Assert::AreEqual(20000u, set.getSize(), L"size");
+                }
+
+                _CrtMemCheckpoint(&state2);
+
+                // If this assertion fails, you have a memory leak.
+                Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+
+                state1 = state2;
+            }
+        }
+
+        TEST_METHOD(Bulk_ScalingBenchmark)
+        {
+            std::vector<int> items(1000000);
+            std::default_random_engine random { static_cast<unsigned int>(rand()) };
+            std::uniform_int_distribution<int> values { 0, 500000 };
+            for (int& item : items)
+            {
+                item = values(random);
+            }
+
+            unsigned int maxThreads { std::max(std::thread::hardware_concurrency(), 1u) };
+            for (unsigned int threads { 1 }; threads <= maxThreads; threads *= 2)
+            {
+                ThreadPool pool { threads };
+                auto start { std::chrono::steady_clock::now() };
+                LinkedSet<int> set { items, pool };
+                std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+
+                Assert::IsTrue(std::ranges::is_sorted(set), L"Sorted");
+                std::wstring message { L"Bulk construction, " + std::to_wstring(threads) + L" threads: " + std::to_wstring(time.count()) + L" ms\n" };
+                Logger::WriteMessage(message.c_str());
+            }
+        }
+
+        TEST_METHOD(Buffered_MatchesDirectWrites)
+        {
+            std::default_random_engine random { static_cast<unsigned int>(rand()) };
+            std::uniform_int_distribution<int> values { -500, 500 };
+            std::bernoulli_distribution adding { 0.7 };
+
+            LinkedSet<int> direct {};
+            LinkedSet<int> buffered {};
+            buffered.setWriteBuffer(64);
+
+            for (int i { 0 }; i < 5000; i++)
+            {
+                int item { values(random) };
+                if (adding(random))
+                {
+                    direct.add(item);
+                    Assert::IsTrue(buffered.add(item), L"Buffered add() was expected to return true.");
+                }
+                else
+                {
+                    direct.remove(item);
+                    Assert::IsTrue(buffered.remove(item), L"Buffered remove() was expected to return true.");
+                }
+
+                // contains() has to see the changes still sitting in the log.
+                int probe { values(random) };
+                Assert::AreEqual(direct.contains(probe), buffered.contains(probe), L"contains()");
+                Assert::AreEqual(direct.contains(item), buffered.contains(item), L"contains()");
+            }
+
+            Assert::AreEqual(direct.getSize(), buffered.getSize(), L"size");
+            Assert::IsTrue(std::ranges::equal(direct, buffered), L"Same elements in the same order");
+        }
+
+        TEST_METHOD(Buffered_MergeOnRead)
+        {
+            LinkedSet<int> set {};
+            set.add(10);
+            set.add(20);
+            set.setWriteBuffer(1000);
+
+            // Tombstones, re-adds and items before the head of the list.
+            set.add(5);
+            set.remove(10);
+            set.add(10);
+            set.remove(20);
+            set.add(30);
+            set.add(1);
+            set.remove(1);
+            set.remove(99);
+            set.add(15);
+            set.add(15);
+            Assert::IsTrue(set.contains(10), L"contains()");
+            Assert::IsFalse(set.contains(20), L"contains()");
+            Assert::IsFalse(set.contains(1), L"contains()");
+
+            // Reading the list merges the log.
+            std::array<int, 4> expected { 5, 10, 15, 30 };
+            Assert::AreEqual(4u, set.getSize(), L"size");
+            Assert::IsTrue(std::ranges::equal(set, expected), L"Elements after merge");
+
+            // Everything buffered can be removed again, emptying the list from the front.
+            for (int n : expected)
+            {
+                set.remove(n);
+            }
+            set.add(40);
+            set.flush();
+            Assert::AreEqual(1u, set.getSize(), L"size");
+            Assert::AreEqual(40, *set.begin(), L"Only element");
+
+            // Turning buffering off applies changes directly again.
+            set.add(50);
+            set.setWriteBuffer(0);
+            Assert::IsFalse(set.add(50), L"add() was expected to return false.");
+            Assert::IsTrue(set.remove(40), L"remove() was expected to return true.");
+            Assert::AreEqual(1u, set.getSize(), L"size");
+        }
+
+        TEST_METHOD(Buffered_MemoryLeakCheck)
+        {
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            for (unsigned int i { 0 }; i < 100; i++)
+            {
+                {
+                    LinkedSet<int, DoublyLinkedList<int>> set {};
+                    set.setWriteBuffer(16);
+                    for (int j { 0 }; j < 100; j++)
+                    {
+                        set.add((j * 37) % 100);
+                        set.remove((j * 53) % 100);
+                    }
+                    Assert::IsTrue(set.getSize() > 0, L"size");
+                    set.add(1000);
+                }
+
+                _CrtMemCheckpoint(&state2);
+
+                // If this assertion fails, you have a memory leak.
+                Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+
+                state1 = state2;
+            }
+        }
+
+        TEST_METHOD(Batch_ApplyMixedChanges)
+        {
+            LinkedSet<int> set {};
+            for (int n : { 10, 20, 30, 40 })
+            {
+                set.add(n);
+            }
+
+            std::vector<std::pair<int, SetOperation>> batch {
+                { 25, SetOperation::Add },
+                { 10, SetOperation::Remove },
+                { 5, SetOperation::Add },
+                { 40, SetOperation::Add },
+                { 99, SetOperation::Remove },
+                { 30, SetOperation::Remove },
+                { 30, SetOperation::Add },
+                { 50, SetOperation::Add },
+                { 5, SetOperation::Add },
+            };
+            auto result { set.apply(batch) };
+
+            std::array<bool, 9> expectedApplied { true, true, true, false, false, true, true, true, false };
+            for (std::size_t j { 0 }; j < batch.size(); j++)
+            {
+                Assert::AreEqual(static_cast<bool>(expectedApplied[j]), static_cast<bool>(result.applied[j]), L"Outcome of change");
+            }
+            Assert::AreEqual(6u, result.count, L"Number of changes applied");
+
+            std::array<int, 6> expected { 5, 20, 25, 30, 40, 50 };
+            Assert::IsTrue(std::ranges::equal(set, expected), L"Elements after apply()");
+
+            // Removing everything, starting at the front of the list.
+            std::vector<std::pair<int, SetOperation>> removeAll {};
+            for (int n : expected)
+            {
+                removeAll.emplace_back(n, SetOperation::Remove);
+            }
+            Assert::AreEqual(6u, set.apply(removeAll).count, L"Number of changes applied");
+            Assert::AreEqual(0u, set.getSize(), L"size");
+            Assert::AreEqual(0u, set.apply({}).count, L"Empty batch");
+        }
+
+        TEST_METHOD(Batch_MatchesSeparateCalls)
+        {
+            std::default_random_engine random { static_cast<unsigned int>(rand()) };
+            std::uniform_int_distribution<int> values { 0, 300 };
+            std::bernoulli_distribution adding { 0.6 };
+
+            LinkedSet<int> separate {};
+            LinkedSet<int, IndexedLinkedList<int>> batched {};
+            batched.setWriteBuffer(50);
+
+            for (int round { 0 }; round < 20; round++)
+            {
+                std::vector<std::pair<int, SetOperation>> batch {};
+                std::vector<bool> expectedApplied {};
+                unsigned int expectedCount { 0 };
+                for (int j { 0 }; j < 100; j++)
+                {
+                    int item { values(random) };
+                    bool add { adding(random) };
+                    batch.emplace_back(item, add ? SetOperation::Add : SetOperation::Remove);
+
+                    bool changed { add ? separate.add(item) : separate.remove(item) };
+                    expectedApplied.push_back(changed);
+                    expectedCount += changed ? 1 : 0;
+                }
+
+                // Buffered writes are merged before the batch is applied.
+                batched.add(values(random) + 1000);
+                separate.add(1000 + 1000);
+                batched.remove(values(random) + 1000);
+                batched.add(2000);
+
+                auto result { batched.apply(batch) };
+                Assert::AreEqual(expectedCount, result.count, L"Number of changes applied");
+                Assert::IsTrue(expectedApplied == result.applied, L"Outcome of each change");
+            }
+
+            batched.setWriteBuffer(0);
+            for (int n { 1000 }; n <= 1300; n++)
+            {
+                batched.remove(n);
+            }
+            Assert::IsTrue(std::ranges::equal(separate, batched), L"Same elements in the same order");
+        }
+
+        TEST_METHOD(Filter_RejectsMostMisses)
+        {
+            CountingBloomFilter<int> filter { 2000, 0.01 };
+            Assert::IsTrue(filter.getHashCount() >= 6 && filter.getHashCount() <= 7, L"Hash functions for 1%");
+
+            LinkedSet<int> set {};
+            for (int n { 999 }; n >= 0; n--)
+            {
+                set.add(n * 2);
+            }
+            set.setFilter(&filter);
+            Assert::AreEqual(1000u, filter.getItemCount(), L"Filter filled from the set");
+
+            // Every odd number is missing; only false positives get past the filter.
+            unsigned int falsePositives { 0 };
+            for (int n { 0 }; n < 2000; n++)
+            {
+                Assert::AreEqual(n % 2 == 0, set.contains(n), L"contains()");
+                if (n % 2 == 1 && filter.mightContain(n))
+                {
+                    falsePositives++;
+                }
+            }
+            Assert::IsTrue(falsePositives < 30, L"False-positive rate");
+            Assert::IsTrue(filter.getFalsePositiveRate() < 0.01, L"Estimated false-positive rate");
+
+            // A smaller filter trades accuracy for memory.
+            CountingBloomFilter<int> small { CountingBloomFilter<int>::withMemory(1024, 1000) };
+            Assert::AreEqual(std::size_t { 1024 }, small.getMemoryUsage(), L"Memory usage");
+            set.setFilter(&small);
+            for (int n { 0 }; n < 2000; n += 2)
+            {
+                Assert::IsTrue(set.contains(n), L"contains()");
+            }
+            Assert::IsTrue(small.getFalsePositiveRate() > filter.getFalsePositiveRate(), L"Smaller filter is less accurate");
+            set.setFilter(nullptr);
+
+            // A budget that isn't a power of two is never overshot.
+            for (std::size_t bytes : { std::size_t { 100 }, std::size_t { 5000 }, std::size_t { 65535 } })
+            {
+                CountingBloomFilter<int> budgeted { CountingBloomFilter<int>::withMemory(bytes, 500) };
+                Assert::IsTrue(budgeted.getMemoryUsage() <= bytes && budgeted.getMemoryUsage() * 2 > bytes, L"Memory usage within budget");
+            }
+            Assert::AreEqual(6u, CountingBloomFilter<int>::withMemory(5000, 500).getHashCount(), L"Hash functions for the counters actually used");
+        }
+
+        TEST_METHOD(Filter_FollowsEveryMutation)
+        {
+            CountingBloomFilter<int> filter { 1000, 0.01 };
+            CountingBloomFilter<int> otherFilter { 1000, 0.01 };
+            {
+                LinkedSet<int> set {};
+                set.setFilter(&filter);
+
+                // Grow past the inline nodes, so they move to the heap.
+                for (int n { 0 }; n < 20; n++)
+                {
+                    set.add(n * 10);
+                }
+
+                // Changes made through an iterator.
+                auto i { set.begin() };
+                i.addNext(5);
+                i.removeNext();
+                i.addNext(7);
+                Assert::IsTrue(set.contains(7), L"contains() after addNext()");
+                Assert::IsFalse(set.contains(5), L"contains() after removeNext()");
+
+                set.remove(0);
+                set.apply({ { 15, SetOperation::Add }, { 190, SetOperation::Remove }, { -5, SetOperation::Add } });
+                set.compact();
+                Assert::IsTrue(set.contains(15) && set.contains(-5) && !set.contains(190), L"contains() after apply()");
+                Assert::AreEqual(set.getSize(), filter.getItemCount(), L"Filter item count");
+
+                // Assigning replaces the contents but keeps the filter.
+                LinkedSet<int> other {};
+                other.setFilter(&otherFilter);
+                other.add(1000);
+                other = set;
+                Assert::AreEqual(set.getSize(), otherFilter.getItemCount(), L"Filter item count after assignment");
+                Assert::IsFalse(other.contains(1000), L"contains() after assignment");
+
+                // Copies don't share the filter.
+                LinkedSet<int> copy { set };
+                copy.add(12345);
+                Assert::IsTrue(copy.contains(12345), L"contains() on copy");
+                Assert::IsFalse(set.contains(12345), L"contains() on original");
+
+                for (int n { -10 }; n < 250; n++)
+                {
+                    Assert::AreEqual(std::ranges::find(set, n) != set.end(), set.contains(n), L"contains()");
+                }
+
+                set.clear();
+                Assert::AreEqual(0u, filter.getItemCount(), L"Filter item count after clear()");
+                set.add(3);
+                Assert::IsTrue(set.contains(3), L"contains() after clear()");
+            }
+            Assert::AreEqual(0u, filter.getItemCount(), L"Filter item count after the set is destroyed");
+        }
+
+        TEST_METHOD(Index_MatchesListSearch)
+        {
+            HashIndex<int> index {};
+            {
+                LinkedSet<int> set {};
+                set.add(30);
+                set.add(10);
+                set.setIndex(&index);
+                Assert::AreEqual(2u, index.getItemCount(), L"Index filled from the set");
+
+                // Random adds and removes, checked against a set without an index.
+                LinkedSet<int> expected {};
+                std::mt19937 random { 38 };
+                std::uniform_int_distribution<int> items { 0, 299 };
+                expected.add(30);
+                expected.add(10);
+                for (int step { 0 }; step < 3000; step++)
+                {
+                    int item { items(random) };
+                    if (random() % 3 == 0)
+                    {
+                        Assert::AreEqual(expected.remove(item), set.remove(item), L"remove()");
+                    }
+                    else
+                    {
+                        Assert::AreEqual(expected.add(item), set.add(item), L"add()");
+                    }
+                }
+
+                // Changes that bypass add() and remove().
+                auto i { set.begin() };
+                while (i.hasNext() && i.peekNext() < 150)
+                {
+                    i++;
+                }
+                if (i.hasNext() && i.peekNext() == 150)
+                {
+                    i.removeNext();
+                }
+                i.addNext(150);
+                i.removeNext();
+                set.compact();
+                set.apply({ { -1, SetOperation::Add }, { 300, SetOperation::Add }, { 150, SetOperation::Add } });
+                expected.apply({ { -1, SetOperation::Add }, { 300, SetOperation::Add }, { 150, SetOperation::Add } });
+
+                Assert::AreEqual(expected.getSize(), index.getItemCount(), L"Index item count");
+                for (int n { -5 }; n < 305; n++)
+                {
+                    Assert::AreEqual(expected.contains(n), set.contains(n), L"contains()");
+                }
+                Assert::IsTrue(std::ranges::equal(expected, set), L"Order after removes through the index");
+
+                // The first node has no predecessor.
+                Assert::IsTrue(index.findPrevious(-1) == std::optional<const ListNode<int>*> { nullptr }, L"findPrevious() of the first item");
+                Assert::IsTrue(set.remove(-1), L"remove() first");
+                Assert::AreEqual(0, *set.begin(), L"New first item");
+                Assert::IsFalse(index.findPrevious(-1).has_value(), L"findPrevious() of a missing item");
+            }
+            Assert::AreEqual(0u, index.getItemCount(), L"Index item count after the set is destroyed");
+        }
+
+        TEST_METHOD(Index_FollowsRelocatedNodes)
+        {
+            // Strings, so that reading a node after it has moved would be caught.
+            HashIndex<std::string> index { 4 };
+            LinkedSet<std::string> set {};
+            set.setIndex(&index);
+
+            // Spill the inline nodes onto the heap, then compact them into the pool.
+            for (int n { 0 }; n < 40; n++)
+            {
+                set.add("item " + std::to_string(100 + n));
+            }
+            set.compact();
+            for (int n { 0 }; n < 40; n += 2)
+            {
+                Assert::IsTrue(set.remove("item " + std::to_string(100 + n)), L"remove()");
+            }
+            for (int n { 0 }; n < 40; n++)
+            {
+                Assert::AreEqual(n % 2 == 1, set.contains("item " + std::to_string(100 + n)), L"contains()");
+                if (n % 2 == 1)
+                {
+                    Assert::AreEqual(std::string { "item " + std::to_string(100 + n) }, index.find("item " + std::to_string(100 + n))->value, L"find()");
+                }
+            }
+
+            // Assigning new contents is reflected in the index.
+            LinkedSet<std::string> other {};
+            other.add("other");
+            set = other;
+            Assert::AreEqual(1u, index.getItemCount(), L"Index item count after assignment");
+            Assert::IsTrue(set.contains("other") && !set.contains("item 101"), L"contains() after assignment");
+            Assert::IsTrue(set.remove("other"), L"remove() after assignment");
+            Assert::AreEqual(0u, set.getSize(), L"getSize()");
+            set.setIndex(nullptr);
+        }
+
+        TEST_METHOD(Index_LookupBenchmark)
+        {
+            HashIndex<int> index { 5000 };
+            std::vector<int> items(5000);
+            std::iota(items.begin(), items.end(), 0);
+            LinkedSet<int> plain { items };
+            LinkedSet<int> indexed { items };
+            indexed.setIndex(&index);
+
+            for (LinkedSet<int>* set : { &plain, &indexed })
+            {
+                auto start { std::chrono::steady_clock::now() };
+                unsigned int found { 0 };
+                // Scattered, so the list search can't resume from where the previous one stopped.
+                for (int k { 0 }; k < 10000; k += 7)
+                {
+                    found += set->contains(k * 7919 % 10000) ? 1 : 0;
+                }
+                std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+
+                Assert::AreEqual(714u, found, L"contains()");
+                std::wstring message { std::wstring { set == &plain ? L"List search" : L"Hash index" } + L": " + std::to_wstring(time.count()) + L" ms\n" };
+                Logger::WriteMessage(message.c_str());
+            }
+            indexed.setIndex(nullptr);
+        }
+
+        TEST_METHOD(LinkedSet_ItemsWithoutHash)
+        {
+            // Items only need > and ==; hashing is only compiled in for filters and indexes.
+            struct Version
+            {
+                int major;
+                int minor;
+
+                bool operator > (const Version& other) const
+                {
+                    return major > other.major || (major == other.major && minor > other.minor);
+                }
+
+                bool operator == (const Version& other) const
+                {
+                    return major == other.major && minor == other.minor;
+                }
+            };
+
+            LinkedSet<Version> set {};
+            Assert::IsTrue(set.add({ 1, 2 }), L"add()");
+            Assert::IsTrue(set.add({ 1, 0 }), L"add()");
+            Assert::IsFalse(set.add({ 1, 2 }), L"add() of an existing item");
+            Assert::IsTrue(set.contains({ 1, 2 }) && !set.contains({ 2, 0 }), L"contains()");
+            Assert::IsTrue(set.remove({ 1, 0 }), L"remove()");
+            Assert::AreEqual(1u, set.getSize(), L"getSize()");
+        }
+
+        TEST_METHOD(Finger_MatchesFullSearch)
+        {
+            // Mostly ascending items with some going backwards, checked against a sorted vector.
+            LinkedSet<int> set {};
+            std::vector<int> expected {};
+            std::mt19937 random { 39 };
+            for (int step { 0 }; step < 4000; step++)
+            {
+                int item { step / 2 + static_cast<int>(random() % 50) - 40 };
+                auto position { std::lower_bound(expected.begin(), expected.end(), item) };
+                bool present { position != expected.end() && *position == item };
+
+                switch (random() % 4)
+                {
+                case 0:
+                    Assert::AreEqual(present, set.remove(item), L"remove()");
+                    if (present)
+                    {
+                        expected.erase(position);
+                    }
+                    break;
+                case 1:
+                    Assert::AreEqual(present, set.contains(item), L"contains()");
+                    break;
+                default:
+                    Assert::AreEqual(!present, set.add(item), L"add()");
+                    if (!present)
+                    {
+                        expected.insert(position, item);
+                    }
+                    break;
+                }
+            }
+
+            Assert::IsTrue(std::ranges::equal(expected, set), L"Contents");
+
+            // Changes made around the finger must not leave it dangling.
+            set.clear();
+            set.add(1);
+            set.add(2);
+            set.add(3);
+            set.remove(3);
+            set.remove(1);
+            Assert::IsTrue(set.contains(2) && !set.contains(3), L"contains() after removing near the finger");
+            set.apply({ { 2, SetOperation::Remove }, { 5, SetOperation::Add } });
+            Assert::IsTrue(set.add(6), L"add() after apply()");
+            set.compact();
+            Assert::IsTrue(set.add(7) && set.contains(5), L"add() after compact()");
+            Assert::AreEqual(3u, set.getSize(), L"getSize()");
+        }
+
+        TEST_METHOD(Finger_MovedFromSetIsReusable)
+        {
+            // Moving a set hands its nodes over, so its finger mustn't keep pointing at them.
+            LinkedSet<int> original {};
+            for (int n { 1 }; n <= 20; n++)
+            {
+                original.add(n);
+            }
+            Assert::IsTrue(original.contains(15), L"contains()");
+
+            LinkedSet<int> moved { std::move(original) };
+            moved.clear();
+            Assert::IsTrue(original.add(3) && original.add(17), L"add() to a moved-from set");
+            Assert::IsTrue(original.contains(17) && !original.contains(15), L"contains() on a moved-from set");
+
+            // Likewise when assigning.
+            Assert::IsTrue(original.contains(17), L"contains()");
+            moved = std::move(original);
+            moved.clear();
+            Assert::IsTrue(original.add(12), L"add() to a moved-from set");
+            Assert::IsTrue(original.remove(12), L"remove() from a moved-from set");
+        }
+
+        TEST_METHOD(Finger_NodeRemovedThroughIterator)
+        {
+            checkFingerNodeRemoved<LinkedList<int>>();
+            checkFingerNodeRemoved<IndexedLinkedList<int>>();
+            checkFingerNodeRemoved<DoublyLinkedList<int>>();
+            checkFingerNodeRemoved<BPlusTree<int>>();
+            checkFingerNodeRemoved<AdaptiveList<int>>();
+        }
+
+        template <typename List>
+        void checkFingerNodeRemoved()
+        {
+            LinkedSet<int, List> set {};
+            for (int n { 1 }; n <= 20; n++)
+            {
+                set.add(n);
+            }
+
+            // Adding 3 again leaves the finger on 2, which is then removed behind the set's back.
+            auto i { set.begin() };
+            Assert::IsFalse(set.add(3), L"add() of an existing item");
+            i.removeNext();
+            Assert::IsFalse(set.add(5), L"add() after removing the finger's item");
+            Assert::IsTrue(set.add(2) && set.remove(4), L"add() and remove() after removing the finger's item");
+
+            std::vector<int> expected { 1, 2, 3 };
+            for (int n { 5 }; n <= 20; n++)
+            {
+                expected.push_back(n);
+            }
+            Assert::IsTrue(std::ranges::equal(expected, set), L"Contents");
+        }
+
+        TEST_METHOD(Finger_HintedAdd)
+        {
+            LinkedSet<int> set {};
+            auto hint { set.end() };
+            for (int n { 0 }; n < 1000; n += 2)
+            {
+                hint = set.add(hint, n);
+                Assert::AreEqual(n, *hint, L"add() returns the item");
+            }
+
+            // Hints after the item, or at an existing item, still work.
+            Assert::AreEqual(500, *set.add(hint, 500), L"add() with a hint after the item");
+            Assert::AreEqual(500, *set.add(set.begin(), 500), L"add() of an existing item");
+            Assert::AreEqual(-1, *set.add(set.begin(), -1), L"add() at the front");
+
+            // Buffered changes are merged before a hinted add.
+            set.setWriteBuffer(100);
+            set.remove(998);
+            set.add(1001);
+            Assert::AreEqual(998, *set.add(set.end(), 998), L"add() of a buffered removal");
+            Assert::AreEqual(502u, set.getSize(), L"getSize()");
+
+            std::vector<int> expected { -1 };
+            for (int n { 0 }; n < 1000; n += 2)
+            {
+                expected.push_back(n);
+            }
+            expected.push_back(500);
+            std::ranges::sort(expected);
+            expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+            expected.push_back(1001);
+            Assert::IsTrue(std::ranges::equal(expected, set), L"Contents");
+        }
+
+        TEST_METHOD(Finger_HintedContains)
+        {
+            checkHintedContains<LinkedList<int>>();
+            checkHintedContains<IndexedLinkedList<int>>();
+            checkHintedContains<DoublyLinkedList<int>>();
+            checkHintedContains<BPlusTree<int>>();
+            checkHintedContains<AdaptiveList<int>>();
+        }
+
+        template <typename List>
+        void checkHintedContains()
+        {
+            LinkedSet<int, List> set {};
+            for (int n { 0 }; n < 300; n += 3)
+            {
+                set.add(n);
+            }
+
+            // Mostly ascending lookups, with a few going backwards, share one hint.
+            auto hint { std::as_const(set).end() };
+            std::mt19937 random { 39 };
+            for (int step { 0 }; step < 1000; step++)
+            {
+                int item { step / 3 + static_cast<int>(random() % 20) - 15 };
+                Assert::AreEqual(item >= 0 && item < 300 && item % 3 == 0, set.contains(hint, item), L"contains() with a hint");
+            }
+
+            // Buffered changes are seen too.
+            set.setWriteBuffer(10);
+            set.add(1000);
+            set.remove(297);
+            Assert::IsTrue(set.contains(hint, 1000) && !set.contains(hint, 297), L"contains() of buffered changes");
+        }
+
+        TEST_METHOD(Finger_ConcurrentLookups)
+        {
+            // Lookups don't move the finger, so a const set can be searched from several threads.
+            LinkedSet<int> items {};
+            for (int n { 0 }; n < 2000; n += 2)
+            {
+                items.add(n);
+            }
+            const LinkedSet<int>& set { items };
+
+            std::atomic<unsigned int> found { 0 };
+            std::vector<std::thread> threads {};
+            for (int thread { 0 }; thread < 4; thread++)
+            {
+                threads.emplace_back([&, thread] {
+                    for (int n { thread }; n < 2000; n += 4)
+                    {
+                        found += set.contains(n) ? 1 : 0;
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            Assert::AreEqual(1000u, found.load(), L"contains() from several threads");
+        }
+
+        TEST_METHOD(Finger_AscendingBenchmark)
+        {
+            std::vector<int> items(20000);
+            std::iota(items.begin(), items.end(), 0);
+
+            // Items added in ascending order would each walk the whole list without the
+            // finger, and lookups likewise without a hint.
+            auto start { std::chrono::steady_clock::now() };
+            LinkedSet<int> set {};
+            for (int item : items)
+            {
+                set.add(item);
+            }
+            unsigned int found { 0 };
+            auto hint { std::as_const(set).end() };
+            for (int item : items)
+            {
+                found += set.contains(hint, item) ? 1 : 0;
+            }
+            std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+
+            Assert::AreEqual(20000u, found, L"contains()");
+            std::wstring message { L"20000 ascending adds and lookups: " + std::to_wstring(time.count()) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(SelfOrganizing_MoveToFrontAndTranspose)
+        {
+            SelfOrganizingSet<int> moveToFront {};
+            SelfOrganizingSet<int> transpose { Reorganization::Transpose };
+            for (int n { 5 }; n >= 1; n--)
+            {
+                Assert::IsTrue(moveToFront.add(n), L"add()");
+                Assert::IsTrue(transpose.add(n), L"add()");
+            }
+            Assert::IsFalse(moveToFront.add(3), L"add() of an existing item");
+            Assert::IsTrue(std::ranges::equal(std::vector<int> { 3, 1, 2, 4, 5 }, moveToFront), L"add() moves an existing item to the front");
+
+            Assert::IsTrue(moveToFront.contains(5), L"contains()");
+            Assert::IsTrue(std::ranges::equal(std::vector<int> { 5, 3, 1, 2, 4 }, moveToFront), L"Order after contains()");
+            Assert::IsFalse(moveToFront.contains(6), L"contains() of a missing item");
+            Assert::IsTrue(std::ranges::equal(std::vector<int> { 5, 3, 1, 2, 4 }, moveToFront), L"Order after a miss");
+
+            Assert::IsTrue(transpose.contains(5), L"contains()");
+            Assert::IsTrue(transpose.contains(5), L"contains()");
+            Assert::IsTrue(transpose.contains(1), L"contains() of the first item");
+            Assert::IsTrue(std::ranges::equal(std::vector<int> { 1, 2, 5, 3, 4 }, transpose), L"Order after contains()");
+
+            Assert::IsTrue(moveToFront.remove(5) && moveToFront.remove(4), L"remove()");
+            Assert::IsFalse(moveToFront.remove(5), L"remove() of a missing item");
+            Assert::AreEqual(3u, moveToFront.getSize(), L"getSize()");
+            moveToFront.clear();
+            Assert::AreEqual(0u, moveToFront.getSize(), L"getSize() after clear()");
+            Assert::IsFalse(moveToFront.contains(3), L"contains() after clear()");
+        }
+
+        TEST_METHOD(SelfOrganizing_MatchesSortedSet)
+        {
+            SelfOrganizingSet<std::string> moveToFront {};
+            SelfOrganizingSet<std::string, DoublyLinkedList<std::string>> transpose { Reorganization::Transpose };
+            LinkedSet<std::string> expected {};
+            std::mt19937 random { 40 };
+            for (int step { 0 }; step < 3000; step++)
+            {
+                std::string item { std::to_string(random() % 100) };
+                switch (random() % 3)
+                {
+                case 0:
+                {
+                    bool removed { expected.remove(item) };
+                    Assert::AreEqual(removed, moveToFront.remove(item), L"remove()");
+                    Assert::AreEqual(removed, transpose.remove(item), L"remove()");
+                    break;
+                }
+                case 1:
+                    Assert::AreEqual(expected.contains(item), moveToFront.contains(item), L"contains()");
+                    Assert::AreEqual(expected.contains(item), transpose.contains(item), L"contains()");
+                    break;
+                default:
+                    bool added { expected.add(item) };
+                    Assert::AreEqual(added, moveToFront.add(item), L"add()");
+                    Assert::AreEqual(added, transpose.add(item), L"add()");
+                    break;
+                }
+            }
+
+            std::vector<std::string> items(moveToFront.begin(), moveToFront.end());
+            std::ranges::sort(items);
+            Assert::IsTrue(std::ranges::equal(expected, items), L"Contents");
+            items.assign(transpose.begin(), transpose.end());
+            std::ranges::sort(items);
+            Assert::IsTrue(std::ranges::equal(expected, items), L"Contents");
+        }
+
+        TEST_METHOD(SelfOrganizing_ZipfianBenchmark)
+        {
+            // 2000 keys, the k-th most popular looked up with probability proportional to 1 / k^s.
+            // The popular keys are spread across the key range, so the sorted set gets no help from them being small.
+            constexpr int keyCount { 2000 };
+            std::vector<int> keys(keyCount);
+            std::iota(keys.begin(), keys.end(), 0);
+            std::mt19937 random { 40 };
+            std::ranges::shuffle(keys, random);
+
+            for (double s : { 0.8, 1.0, 1.2 })
+            {
+                std::vector<double> weights(keyCount);
+                for (int k { 0 }; k < keyCount; k++)
+                {
+                    weights[k] = 1.0 / std::pow(k + 1, s);
+                }
+                std::discrete_distribution<int> rank(weights.begin(), weights.end());
+                std::vector<int> lookups(20000);
+                for (int& lookup : lookups)
+                {
+                    lookup = keys[rank(random)];
+                }
+
+                LinkedSet<int> sorted { keys };
+                SelfOrganizingSet<int> moveToFront {};
+                SelfOrganizingSet<int> transpose { Reorganization::Transpose };
+                for (int key : keys)
+                {
+                    moveToFront.add(key);
+                    transpose.add(key);
+                }
+
+                auto time { [&](auto& set) {
+                    auto start { std::chrono::steady_clock::now() };
+                    unsigned int found { 0 };
+                    for (int lookup : lookups)
+                    {
+                        found += set.contains(lookup) ? 1 : 0;
+                    }
+                    std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+
+                    Assert::AreEqual(static_cast<unsigned int>(lookups.size()), found, L"contains()");
+                    return std::to_wstring(time.count());
+                } };
+
+                std::wstring message { L"Zipf s=" + std::to_wstring(s) + L": sorted " + time(sorted) + L" ms, move-to-front " + time(moveToFront)
+                    + L" ms, transpose " + time(transpose) + L" ms\n" };
+                Logger::WriteMessage(message.c_str());
+            }
+        }
+
+        TEST_METHOD(Frozen_MatchesLinkedSet)
+        {
+            // Every size up to a few full levels, so that every shape of the last level is covered.
+            for (int size { 0 }; size < 70; size++)
+            {
+                LinkedSet<int> set {};
+                for (int n { size - 1 }; n >= 0; n--)
+                {
+                    set.add(n * 3);
+                }
+
+                FrozenSet<int> frozen { set.freeze() };
+                Assert::AreEqual(set.getSize(), frozen.getSize(), L"getSize()");
+                Assert::IsTrue(std::ranges::equal(set, frozen), L"Iteration order");
+                for (int n { -2 }; n < size * 3 + 2; n++)
+                {
+                    Assert::AreEqual(set.contains(n), frozen.contains(n), L"contains()");
+                }
+            }
+
+            FrozenSet<std::string> empty {};
+            Assert::AreEqual(0u, empty.getSize(), L"getSize() of an empty set");
+            Assert::IsFalse(empty.contains(""), L"contains() on an empty set");
+            Assert::IsTrue(empty.begin() == empty.end(), L"Iterating an empty set");
+        }
+
+        TEST_METHOD(Frozen_ThawAndPrint)
+        {
+            LinkedSet<std::string> set {};
+            set.add("pear");
+            set.add("apple");
+            set.add("fig");
+            FrozenSet<std::string> frozen { set.freeze() };
+            Assert::IsTrue(frozen.contains("fig") && !frozen.contains("kiwi"), L"contains()");
+
+            std::stringstream out {};
+            out << frozen;
+            Assert::AreEqual(std::string { "[apple, fig, pear]" }, out.str(), L"operator <<");
+
+            // Thawed sets can be changed again, and don't affect the frozen one.
+            LinkedSet<std::string> thawed { frozen.thaw() };
+            Assert::IsTrue(thawed.add("kiwi") && thawed.remove("apple"), L"add() and remove() after thaw()");
+            Assert::IsTrue(std::ranges::equal(std::vector<std::string> { "fig", "kiwi", "pear" }, thawed), L"Contents after thaw()");
+            Assert::AreEqual(3u, frozen.getSize(), L"Frozen set unchanged");
+
+            auto doubly { frozen.thaw<DoublyLinkedList<std::string>>() };
+            Assert::AreEqual(std::string { "pear" }, *doubly.rbegin(), L"thaw() into another list");
+        }
+
+        TEST_METHOD(Frozen_LookupBenchmark)
+        {
+            // Large enough that the array is well out of cache, where the layout matters.
+            std::vector<int> items(1 << 20);
+            for (int n { 0 }; n < static_cast<int>(items.size()); n++)
+            {
+                items[n] = n * 2;
+            }
+            FrozenSet<int> frozen { items };
+
+            std::mt19937 random { 41 };
+            std::uniform_int_distribution<int> lookup { 0, static_cast<int>(items.size()) * 2 };
+            std::vector<int> lookups(1000000);
+            for (int& item : lookups)
+            {
+                item = lookup(random);
+            }
+
+            auto start { std::chrono::steady_clock::now() };
+            unsigned int sortedFound { 0 };
+            for (int item : lookups)
+            {
+                sortedFound += std::binary_search(items.begin(), items.end(), item) ? 1 : 0;
+            }
+            std::chrono::duration<double, std::milli> sortedTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            unsigned int frozenFound { 0 };
+            for (int item : lookups)
+            {
+                frozenFound += frozen.contains(item) ? 1 : 0;
+            }
+            std::chrono::duration<double, std::milli> frozenTime { std::chrono::steady_clock::now() - start };
+
+            Assert::AreEqual(sortedFound, frozenFound, L"contains()");
+            std::wstring message { L"Sorted array: " + std::to_wstring(sortedTime.count()) + L" ms, frozen set: " + std::to_wstring(frozenTime.count()) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(BPlusTree_MatchesLinkedList)
+        {
+            // Strings make for small nodes (a few items each), so the tree gets several levels deep.
+            LinkedSet<std::string, BPlusTree<std::string>> tree {};
+            LinkedSet<std::string> expected {};
+            std::mt19937 random { 42 };
+            auto key { [&] { return std::to_string(1000 + random() % 600); } };
+            for (int step { 0 }; step < 6000; step++)
+            {
+                std::string item { key() };
+                switch (random() % 5)
+                {
+                case 0:
+                case 1:
+                    Assert::AreEqual(expected.remove(item), tree.remove(item), L"remove()");
+                    break;
+                case 2:
+                    Assert::AreEqual(expected.contains(item), tree.contains(item), L"contains()");
+                    break;
+                default:
+                    Assert::AreEqual(expected.add(item), tree.add(item), L"add()");
+                    break;
+                }
+
+                if (step == 3000)
+                {
+                    std::vector<std::pair<std::string, SetOperation>> batch {};
+                    for (int n { 0 }; n < 200; n++)
+                    {
+                        batch.emplace_back(key(), n % 3 == 0 ? SetOperation::Remove : SetOperation::Add);
+                    }
+                    Assert::AreEqual(expected.apply(batch).count, tree.apply(batch).count, L"apply()");
+                }
+            }
+
+            Assert::AreEqual(expected.getSize(), tree.getSize(), L"getSize()");
+            Assert::IsTrue(std::ranges::equal(expected, tree), L"Contents");
+
+            std::vector<std::string> inRange {};
+            std::vector<std::string> expectedInRange {};
+            tree.forEachInRange("1200", "1350", [&](const std::string& item) { inRange.push_back(item); });
+            expected.forEachInRange("1200", "1350", [&](const std::string& item) { expectedInRange.push_back(item); });
+            Assert::IsTrue(!inRange.empty() && inRange == expectedInRange, L"forEachInRange()");
+
+            // Emptying the tree frees every leaf and collapses the levels.
+            for (int n { 1000 }; n < 1600; n++)
+            {
+                tree.remove(std::to_string(n));
+            }
+            Assert::AreEqual(0u, tree.getSize(), L"getSize() when empty");
+            Assert::IsTrue(tree.begin() == tree.end(), L"Iterating an empty tree");
+            Assert::IsTrue(tree.add("x") && tree.contains("x"), L"add() after emptying");
+        }
+
+        TEST_METHOD(BPlusTree_OrderedInsertsAndCopies)
+        {
+            BPlusTree<int> ascending {};
+            BPlusTree<int> descending {};
+            for (int n { 0 }; n < 5000; n++)
+            {
+                ascending.addLast(n);
+                descending.addFirst(4999 - n);
+            }
+            Assert::AreEqual(5000u, ascending.getSize(), L"getSize()");
+            Assert::IsTrue(std::ranges::equal(ascending, descending), L"Contents");
+            Assert::AreEqual(0, ascending.getFirst(), L"getFirst()");
+            Assert::AreEqual(4999, ascending.getLast(), L"getLast()");
+
+            // Appending in order packs the leaves, so the tree is no taller than it has to be.
+            Assert::IsTrue(ascending.getHeight() <= descending.getHeight(), L"getHeight()");
+            Assert::AreEqual(3u, ascending.getHeight(), L"getHeight()");
+
+            Assert::AreEqual(41, *++ascending.findPrevious(41), L"findPrevious()");
+            Assert::IsTrue(ascending.findPrevious(0) == ascending.end(), L"findPrevious() of the first item");
+            int sum { 0 };
+            ascending.scan(100, 200, [&](int n) { sum += n; });
+            Assert::AreEqual(14950, sum, L"scan()");
+
+            BPlusTree<int> copy { ascending };
+            ascending.removeFirst();
+            BPlusTree<int> moved { std::move(descending) };
+            Assert::AreEqual(0u, descending.getSize(), L"getSize() after move");
+            Assert::IsTrue(std::ranges::equal(copy, moved), L"Copy and move");
+            copy = ascending;
+            Assert::AreEqual(1, copy.getFirst(), L"getFirst() after copy assignment");
+
+            BPlusTree<int> empty {};
+            Assert::ExpectException<std::out_of_range>([&] { empty.removeFirst(); }, L"removeFirst() on an empty tree");
+            Assert::ExpectException<std::out_of_range>([&] { empty.getFirst(); }, L"getFirst() on an empty tree");
+        }
+
+        TEST_METHOD(BPlusTree_MemoryLeakCheck)
+        {
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            for (unsigned int i { 0 }; i < 20; i++)
+            {
+                {
+                    LinkedSet<std::string, BPlusTree<std::string>> set {};
+                    for (int j { 0 }; j < 300; j++)
+                    {
+                        set.add(std::to_string((j * 37) % 300));
+                        set.remove(std::to_string((j * 53) % 300));
+                    }
+                    LinkedSet<std::string, BPlusTree<std::string>> copy { set };
+                    set.clear();
+                    set = copy;
+                }
+
+                _CrtMemCheckpoint(&state2);
+
+                // If this assertion fails, you have a memory leak.
+                Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+
+                state1 = state2;
+            }
+        }
+
+        TEST_METHOD(BPlusTree_Benchmark)
+        {
+            std::mt19937 random { 42 };
+            std::uniform_int_distribution<int> keys { 0, 19999 };
+            std::vector<int> operations(30000);
+            for (int& operation : operations)
+            {
+                operation = keys(random);
+            }
+
+            // Mixed adds, lookups and removes.
+            auto mixed { [&](auto& set) {
+                auto start { std::chrono::steady_clock::now() };
+                unsigned int changes { 0 };
+                for (std::size_t n { 0 }; n < operations.size(); n++)
+                {
+                    switch (n % 4)
+                    {
+                    case 0:
+                    case 1:
+                        changes += set.insert(operations[n]).second ? 1 : 0;
+                        break;
+                    case 2:
+                        changes += set.count(operations[n]) > 0 ? 1 : 0;
+                        break;
+                    default:
+                        changes += static_cast<unsigned int>(set.erase(operations[n]));
+                        break;
+                    }
+                }
+                std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+                return std::make_pair(changes, time.count());
+            } };
+
+            // Give the LinkedSets the same interface as std::set for the loop above.
+            struct Adapter
+            {
+                std::pair<int, bool> insert(int n) { return { n, set.add(n) }; }
+                unsigned int count(int n) const { return set.contains(n) ? 1 : 0; }
+                unsigned int erase(int n) { return set.remove(n) ? 1 : 0; }
+                LinkedSet<int> set {};
+            };
+            struct TreeAdapter
+            {
+                std::pair<int, bool> insert(int n) { return { n, set.add(n) }; }
+                unsigned int count(int n) const { return set.contains(n) ? 1 : 0; }
+                unsigned int erase(int n) { return set.remove(n) ? 1 : 0; }
+                LinkedSet<int, BPlusTree<int>> set {};
+            };
+
+            std::set<int> standard {};
+            Adapter list {};
+            TreeAdapter tree {};
+            auto [standardChanges, standardTime] { mixed(standard) };
+            auto [listChanges, listTime] { mixed(list) };
+            auto [treeChanges, treeTime] { mixed(tree) };
+            Assert::AreEqual(standardChanges, listChanges, L"List results");
+            Assert::AreEqual(standardChanges, treeChanges, L"Tree results");
+
+            // Range scans over the result.
+            auto scan { [&](auto forEachInRange) {
+                auto start { std::chrono::steady_clock::now() };
+                long long sum { 0 };
+                for (int low { 0 }; low < 20000; low += 50)
+                {
+                    forEachInRange(low, low + 2000, [&](int n) { sum += n; });
+                }
+                std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+                return std::make_pair(sum, time.count());
+            } };
+            auto [standardSum, standardScan] { scan([&](int low, int high, auto f) { std::for_each(standard.lower_bound(low), standard.lower_bound(high), f); }) };
+            auto [listSum, listScan] { scan([&](int low, int high, auto f) { list.set.forEachInRange(low, high, f); }) };
+            auto [treeSum, treeScan] { scan([&](int low, int high, auto f) { tree.set.forEachInRange(low, high, f); }) };
+            Assert::AreEqual(standardSum, listSum, L"List range sums");
+            Assert::AreEqual(standardSum, treeSum, L"Tree range sums");
+
+            std::wstring message { L"Mixed operations: std::set " + std::to_wstring(standardTime) + L" ms, list " + std::to_wstring(listTime)
+                + L" ms, B+-tree " + std::to_wstring(treeTime) + L" ms\n"
+                + L"Range scans: std::set " + std::to_wstring(standardScan) + L" ms, list " + std::to_wstring(listScan)
+                + L" ms, B+-tree " + std::to_wstring(treeScan) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(Adaptive_MatchesLinkedSet)
+        {
+            // Sweep through small, sparse, dense and shrinking phases, so every switch happens along the way.
+            LinkedSet<int, AdaptiveList<int>> adaptive {};
+            LinkedSet<int> expected {};
+            std::mt19937 random { 42 };
+            auto check { [&](int item, unsigned int operation) {
+                switch (operation % 4)
+                {
+                case 0:
+                    Assert::AreEqual(expected.remove(item), adaptive.remove(item), L"remove()");
+                    break;
+                case 1:
+                    Assert::AreEqual(expected.contains(item), adaptive.contains(item), L"contains()");
+                    break;
+                default:
+                    Assert::AreEqual(expected.add(item), adaptive.add(item), L"add()");
+                    break;
+                }
+            } };
+
+            for (int step { 0 }; step < 3000; step++)
+            {
+                check(static_cast<int>(random() % 100000), random());
+            }
+            for (int step { 0 }; step < 6000; step++)
+            {
+                check(static_cast<int>(random() % 2000), random());
+            }
+            check(-5000000, 2);
+            for (int step { 0 }; step < 3000; step++)
+            {
+                check(static_cast<int>(random() % 2000), 0);
+            }
+
+            Assert::AreEqual(expected.getSize(), adaptive.getSize(), L"getSize()");
+            Assert::IsTrue(std::ranges::equal(expected, adaptive), L"Contents");
+
+            std::vector<std::pair<int, SetOperation>> batch {};
+            for (int n { 0 }; n < 500; n++)
+            {
+                batch.emplace_back(static_cast<int>(random() % 3000), n % 3 == 0 ? SetOperation::Remove : SetOperation::Add);
+            }
+            Assert::AreEqual(expected.apply(batch).count, adaptive.apply(batch).count, L"apply()");
+            Assert::IsTrue(std::ranges::equal(expected, adaptive), L"Contents after apply()");
+
+            std::vector<int> inRange {};
+            std::vector<int> expectedInRange {};
+            adaptive.forEachInRange(100, 900, [&](int item) { inRange.push_back(item); });
+            expected.forEachInRange(100, 900, [&](int item) { expectedInRange.push_back(item); });
+            Assert::IsTrue(!inRange.empty() && inRange == expectedInRange, L"forEachInRange()");
+
+            LinkedSet<int, AdaptiveList<int>> copy { adaptive };
+            adaptive.clear();
+            Assert::IsTrue(std::ranges::equal(expected, copy), L"Copy");
+        }
+
+        TEST_METHOD(Adaptive_SwitchesRepresentationGradually)
+        {
+            AdaptiveList<int> list {};
+            for (int n { 0 }; n < 60; n++)
+            {
+                list.addLast(n * 1000);
+            }
+            Assert::IsTrue(list.getRepresentation() == SetRepresentation::Array, L"Small list");
+
+            // Sparse items outgrow the array, and move into a tree a few at a time.
+            unsigned int migratingChanges { 0 };
+            for (int n { 60 }; n < 400; n++)
+            {
+                list.addLast(n * 1000);
+                migratingChanges += list.isMigrating() ? 1 : 0;
+            }
+            Assert::IsTrue(list.getRepresentation() == SetRepresentation::Tree && !list.isMigrating(), L"Big sparse list");
+            Assert::IsTrue(migratingChanges > 1, L"Switch spread over several changes");
+
+            // Filling the gaps makes the items dense enough for a bitmap.
+            for (int n { 0 }; n < 399000; n += 7)
+            {
+                if (n % 1000 != 0)
+                {
+                    list.addLast(n);
+                }
+            }
+            for (int n { 0 }; n < 100 && list.isMigrating(); n++)
+            {
+                list.addLast(n * 1000 + 1);
+            }
+            Assert::IsTrue(list.getRepresentation() == SetRepresentation::Bitmap && !list.isMigrating(), L"Dense list");
+            Assert::AreEqual(0, list.getFirst(), L"getFirst()");
+            Assert::AreEqual(399000, list.getLast(), L"getLast()");
+            Assert::AreEqual(1000, *++list.findPrevious(1000), L"findPrevious()");
+
+            // A far-off key goes straight into a tree rather than stretching the bitmap.
+            list.addLast(2000000000);
+            Assert::IsTrue(list.getRepresentation() == SetRepresentation::Tree && list.isMigrating(), L"Outlier");
+            Assert::AreEqual(2000000000, list.getLast(), L"getLast() while switching");
+
+            std::vector<int> items(list.begin(), list.end());
+            Assert::IsTrue(std::ranges::is_sorted(items) && items.size() == list.getSize(), L"Iterating while switching");
+
+            // Shrinking it brings it back down to an array.
+            while (list.getSize() > 10)
+            {
+                list.removeFirst();
+            }
+            for (int n { 0 }; n < 10 && list.isMigrating(); n++)
+            {
+                list.addFirst(-1 - n);
+            }
+            Assert::IsTrue(list.getRepresentation() == SetRepresentation::Array && !list.isMigrating(), L"Shrunk list");
+            Assert::AreEqual(2000000000, list.getLast(), L"getLast() after shrinking");
+
+            // Items that aren't integers never go into a bitmap.
+            AdaptiveList<double> doubles {};
+            for (int n { 0 }; n < 1000; n++)
+            {
+                doubles.addLast(n);
+            }
+            Assert::IsTrue(doubles.getRepresentation() == SetRepresentation::Tree, L"Doubles");
+
+            AdaptiveList<int> empty {};
+            Assert::ExpectException<std::out_of_range>([&] { empty.removeFirst(); }, L"removeFirst() on an empty list");
+            Assert::ExpectException<std::logic_error>([&] { empty.begin().peekNext(); }, L"peekNext() on an empty list");
+        }
+
+        TEST_METHOD(Adaptive_BitmapGrowsTowardsTheMinimum)
+        {
+            // Growing the bitmap down to a small unsigned item mustn't wrap past zero.
+            LinkedSet<unsigned, AdaptiveList<unsigned>> set {};
+            for (unsigned n { 100 }; n < 400; n++)
+            {
+                set.add(n);
+            }
+            Assert::IsTrue(set.add(5u), L"add() below the bitmap");
+            Assert::IsTrue(set.contains(5u) && !set.contains(4u) && set.contains(399u), L"contains()");
+            Assert::AreEqual(5u, set.getFirst(), L"getFirst()");
+            Assert::AreEqual(301u, set.getSize(), L"size");
+
+            // Nor past the smallest signed item, which isn't a whole number of words away.
+            AdaptiveList<signed char> list {};
+            for (int n { -100 }; n <= 100; n++)
+            {
+                list.addLast(static_cast<signed char>(n));
+            }
+            Assert::IsTrue(list.getRepresentation() == SetRepresentation::Bitmap, L"Dense list");
+            list.addFirst(-128);
+            Assert::AreEqual(static_cast<signed char>(-128), list.getFirst(), L"getFirst()");
+            Assert::AreEqual(static_cast<signed char>(100), list.getLast(), L"getLast()");
+            Assert::AreEqual(202u, list.getSize(), L"size");
+            std::vector<int> items(list.begin(), list.end());
+            std::vector<int> expected { -128 };
+            for (int n { -100 }; n <= 100; n++)
+            {
+                expected.push_back(n);
+            }
+            Assert::IsTrue(items == expected, L"Items after growing down");
+        }
+
+        TEST_METHOD(Adaptive_MemoryLeakCheck)
+        {
+            // Magic to tell us if there's a memory leak.
+            _CrtMemState state1, state2, state3;
+
+            _CrtMemCheckpoint(&state1);
+
+            for (unsigned int i { 0 }; i < 20; i++)
+            {
+                {
+                    LinkedSet<int, AdaptiveList<int>> set {};
+                    for (int j { 0 }; j < 2000; j++)
+                    {
+                        set.add((j * 37) % 2000);
+                        set.remove((j * 53) % 2000);
+                    }
+                    LinkedSet<int, AdaptiveList<int>> copy { set };
+                    set.clear();
+                    set = copy;
+                }
+
+                _CrtMemCheckpoint(&state2);
+
+                // If this assertion fails, you have a memory leak.
+                Assert::AreEqual(0, _CrtMemDifference(&state3, &state1, &state2), L"Memory leak");
+
+                state1 = state2;
+            }
+        }
+
+        template <typename T>
+        static void checkSimdKernels(T (*draw)(std::mt19937&))
+        {
+            std::mt19937 random { 44 };
+            for (unsigned int count { 0 }; count < 80; count++)
+            {
+                std::vector<T> items(count);
+                for (T& item : items)
+                {
+                    item = draw(random);
+                }
+                T low { draw(random) };
+                T high { draw(random) };
+
+                unsigned int less { 0 };
+                unsigned int inRange { 0 };
+                for (const T& item : items)
+                {
+                    less += low > item ? 1 : 0;
+                    inRange += !(low > item) && high > item ? 1 : 0;
+                }
+
+                // Every level the CPU supports has to agree with the plain loop.
+                for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+                {
+                    if (level > getSimdLevel())
+                    {
+                        break;
+                    }
+                    Assert::AreEqual(less, simdCountLess(items.data(), count, low, level), L"simdCountLess()");
+                    Assert::AreEqual(inRange, simdCountInRange(items.data(), count, low, high, level), L"simdCountInRange()");
+                }
+            }
+        }
+
+        TEST_METHOD(Simd_MatchesScalarLoop)
+        {
+            checkSimdKernels<std::int32_t>([](std::mt19937& random) { return static_cast<std::int32_t>(random()); });
+            checkSimdKernels<std::int64_t>([](std::mt19937& random) { return static_cast<std::int64_t>((std::uint64_t { random() } << 32) | random()); });
+            checkSimdKernels<float>([](std::mt19937& random) { return static_cast<float>(static_cast<int>(random() % 2000) - 1000) / 8; });
+            checkSimdKernels<signed char>([](std::mt19937& random) { return static_cast<signed char>(random()); });
+            checkSimdKernels<std::string>([](std::mt19937& random) { return std::to_string(random() % 1000); });
+        }
+
+        TEST_METHOD(Simd_CountInRange)
+        {
+            LinkedSet<int, BPlusTree<int>> tree {};
+            LinkedSet<int> list {};
+            LinkedSet<int, AdaptiveList<int>> adaptive {};
+            std::mt19937 random { 45 };
+            for (int n { 0 }; n < 5000; n++)
+            {
+                int item { static_cast<int>(random() % 20000) };
+                tree.add(item);
+                list.add(item);
+                adaptive.add(item);
+            }
+            FrozenSet<int> frozen { tree.freeze() };
+
+            for (int n { 0 }; n < 200; n++)
+            {
+                int low { static_cast<int>(random() % 22000) - 1000 };
+                int high { low + static_cast<int>(random() % 5000) };
+                unsigned int expected { static_cast<unsigned int>(std::ranges::count_if(list, [&](int item) { return item >= low && item < high; })) };
+                Assert::AreEqual(expected, list.countInRange(low, high), L"LinkedList");
+                Assert::AreEqual(expected, tree.countInRange(low, high), L"BPlusTree");
+                Assert::AreEqual(expected, adaptive.countInRange(low, high), L"AdaptiveList");
+                Assert::AreEqual(expected, frozen.countInRange(low, high), L"FrozenSet");
+            }
+            Assert::AreEqual(0u, tree.countInRange(100, 100), L"Empty range");
+            Assert::AreEqual(list.getSize(), tree.countInRange(-1, 20000), L"Whole set");
+        }
+
+        TEST_METHOD(Simd_Benchmark)
+        {
+            std::vector<int> items(1 << 18);
+            for (int n { 0 }; n < static_cast<int>(items.size()); n++)
+            {
+                items[n] = n * 3;
+            }
+            const LinkedSet<int> list { items };
+            LinkedSet<int, BPlusTree<int>> tree { items };
+            std::mt19937 random { 46 };
+            std::vector<std::pair<int, int>> ranges(200);
+            for (auto& [low, high] : ranges)
+            {
+                low = static_cast<int>(random() % (items.size() * 3));
+                high = low + 30000;
+            }
+
+            // The scalar walk that the kernels replace.
+            auto start { std::chrono::steady_clock::now() };
+            unsigned int walked { 0 };
+            for (auto [low, high] : ranges)
+            {
+                for (ConstLinkedListIterator<int> i { list.begin() }; i != list.end() && high > *i; ++i)
+                {
+                    walked += *i >= low ? 1 : 0;
+                }
+            }
+            std::chrono::duration<double, std::milli> walkTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            unsigned int counted { 0 };
+            for (auto [low, high] : ranges)
+            {
+                counted += tree.countInRange(low, high);
+            }
+            std::chrono::duration<double, std::milli> treeTime { std::chrono::steady_clock::now() - start };
+            Assert::AreEqual(walked, counted, L"countInRange()");
+
+            // The kernels on their own, over one flat array, at each level.
+            std::vector<float> values(1 << 16);
+            for (float& value : values)
+            {
+                value = static_cast<float>(random() % 1000);
+            }
+            std::wstring message { L"List walk: " + std::to_wstring(walkTime.count()) + L" ms, tree countInRange(): " + std::to_wstring(treeTime.count()) + L" ms\n" };
+            unsigned int expected { 0 };
+            for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+            {
+                if (level > getSimdLevel())
+                {
+                    break;
+                }
+                start = std::chrono::steady_clock::now();
+                unsigned int count { 0 };
+                for (int n { 0 }; n < 200; n++)
+                {
+                    count += simdCountInRange(values.data(), static_cast<unsigned int>(values.size()), 250.0f + n, 750.0f, level);
+                }
+                std::chrono::duration<double, std::milli> time { std::chrono::steady_clock::now() - start };
+                expected = level == SimdLevel::Scalar ? count : expected;
+                Assert::AreEqual(expected, count, L"Same count at every level");
+                message += L"Level " + std::to_wstring(static_cast<int>(level)) + L": " + std::to_wstring(time.count()) + L" ms\n";
+            }
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(OrderStatistics_MatchesSortedVector)
+        {
+            // Strings keep the nodes small, so the counts are kept across several levels.
+            LinkedSet<std::string, BPlusTree<std::string>> tree {};
+            LinkedSet<std::string> list {};
+            std::mt19937 random { 45 };
+            for (int round { 0 }; round < 8; round++)
+            {
+                for (int step { 0 }; step < 800; step++)
+                {
+                    std::string item { std::to_string(1000 + random() % 2000) };
+                    if (random() % 3 == 0)
+                    {
+                        tree.remove(item);
+                        list.remove(item);
+                    }
+                    else
+                    {
+                        tree.add(item);
+                        list.add(item);
+                    }
+                }
+
+                std::vector<std::string> sorted(list.begin(), list.end());
+                for (unsigned int k { 0 }; k < sorted.size(); k += 7)
+                {
+                    Assert::AreEqual(sorted[k], tree.select(k), L"select()");
+                    Assert::AreEqual(sorted[k], tree[k], L"operator[]");
+                    Assert::AreEqual(k, tree.rank(sorted[k]), L"rank() of an item");
+                }
+                std::string missing { std::to_string(random() % 5000) + "x" };
+                unsigned int below { static_cast<unsigned int>(std::ranges::lower_bound(sorted, missing) - sorted.begin()) };
+                Assert::AreEqual(below, tree.rank(missing), L"rank() of a missing item");
+                Assert::AreEqual(below, list.rank(missing), L"rank() walking the list");
+                Assert::AreEqual(tree.countInRange("1500", "2500"), list.countInRange("1500", "2500"), L"countInRange()");
+            }
+
+            Assert::AreEqual(list.select(10), tree.select(10), L"select() walking the list");
+            Assert::ExpectException<std::out_of_range>([&] { tree.select(tree.getSize()); }, L"select() past the end");
+            Assert::ExpectException<std::out_of_range>([&] { list.select(list.getSize()); }, L"select() past the end of the list");
+
+            // Counts survive emptying and refilling, and in-order appends.
+            tree.clear();
+            BPlusTree<int> ascending {};
+            for (int n { 0 }; n < 5000; n++)
+            {
+                ascending.addLast(n * 2);
+            }
+            Assert::AreEqual(2500u, ascending.rank(5000), L"rank() after appends");
+            Assert::AreEqual(7000, ascending.select(3500), L"select() after appends");
+            for (int n { 0 }; n < 4000; n++)
+            {
+                ascending.removeFirst();
+            }
+            Assert::AreEqual(8000, ascending.select(0), L"select() after removes");
+            Assert::AreEqual(500u, ascending.countInRange(0, 9000), L"countInRange() after removes");
+        }
+
+        TEST_METHOD(OrderStatistics_Benchmark)
+        {
+            std::vector<int> items(100000);
+            std::iota(items.begin(), items.end(), 0);
+            LinkedSet<int> list { items };
+            LinkedSet<int, BPlusTree<int>> tree { items };
+            std::mt19937 random { 46 };
+            std::vector<unsigned int> positions(2000);
+            for (unsigned int& k : positions)
+            {
+                k = random() % 100000;
+            }
+
+            auto start { std::chrono::steady_clock::now() };
+            long long listSum { 0 };
+            for (unsigned int k : positions)
+            {
+                listSum += list[k] + list.rank(static_cast<int>(k));
+            }
+            std::chrono::duration<double, std::milli> listTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            long long treeSum { 0 };
+            for (unsigned int k : positions)
+            {
+                treeSum += tree[k] + tree.rank(static_cast<int>(k));
+            }
+            std::chrono::duration<double, std::milli> treeTime { std::chrono::steady_clock::now() - start };
+
+            Assert::IsTrue(listSum == treeSum, L"Same answers");
+            std::wstring message { L"List select/rank: " + std::to_wstring(listTime.count()) + L" ms, tree: " + std::to_wstring(treeTime.count()) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(Aggregate_MatchesWalk)
+        {
+            LinkedSet<int, BPlusTree<int, SumAggregate<int>>> sums {};
+            LinkedSet<int, BPlusTree<int, MinAggregate<int>>> minimums {};
+            LinkedSet<int, BPlusTree<int, MaxAggregate<int>>> maximums {};
+            LinkedSet<int> list {};
+            std::mt19937 random { 46 };
+            for (int round { 0 }; round < 10; round++)
+            {
+                for (int step { 0 }; step < 1500; step++)
+                {
+                    int item { static_cast<int>(random() % 6000) };
+                    if (random() % 3 == 0)
+                    {
+                        sums.remove(item);
+                        minimums.remove(item);
+                        maximums.remove(item);
+                        list.remove(item);
+                    }
+                    else
+                    {
+                        sums.add(item);
+                        minimums.add(item);
+                        maximums.add(item);
+                        list.add(item);
+                    }
+                }
+
+                for (int query { 0 }; query < 50; query++)
+                {
+                    int low { static_cast<int>(random() % 6500) - 250 };
+                    int high { low + static_cast<int>(random() % 3000) };
+                    Assert::AreEqual(list.aggregate<SumAggregate<int>>(low, high), sums.aggregate<SumAggregate<int>>(low, high), L"Sum");
+                    Assert::AreEqual(list.aggregate<MinAggregate<int>>(low, high), minimums.aggregate<MinAggregate<int>>(low, high), L"Minimum");
+                    Assert::AreEqual(list.aggregate<MaxAggregate<int>>(low, high), maximums.aggregate<MaxAggregate<int>>(low, high), L"Maximum");
+                    Assert::AreEqual(list.countInRange(low, high), sums.aggregate<CountAggregate<int>>(low, high), L"Count, by walking the tree");
+                }
+            }
+
+            // Empty and backwards ranges hold nothing.
+            Assert::AreEqual(0, sums.aggregate<SumAggregate<int>>(100, 100), L"Empty range");
+            Assert::AreEqual(std::numeric_limits<int>::max(), minimums.aggregate<MinAggregate<int>>(3000, 2000), L"Backwards range");
+            sums.clear();
+            Assert::AreEqual(0, sums.aggregate<SumAggregate<int>>(0, 6000), L"Empty set");
+        }
+
+        TEST_METHOD(Aggregate_CustomMonoid)
+        {
+            // Concatenation isn't commutative, so this checks that runs are combined in order.
+            struct Digits
+            {
+                using Value = std::string;
+                static Value identity() { return ""; }
+                static Value of(const int& item) { return std::to_string(item % 10); }
+                static Value combine(const Value& a, const Value& b) { return a + b; }
+            };
+
+            LinkedSet<int, BPlusTree<int, Digits>> tree {};
+            std::string expected {};
+            for (int item { 0 }; item < 5000; item++)
+            {
+                tree.add(4999 - item);
+            }
+            for (int item { 1234 }; item < 4321; item++)
+            {
+                expected += std::to_string(item % 10);
+            }
+            Assert::AreEqual(expected, tree.aggregate<Digits>(1234, 4321), L"Concatenated in order");
+
+            for (int item { 0 }; item < 5000; item += 2)
+            {
+                tree.remove(item);
+            }
+            Assert::AreEqual(std::string("13579"), tree.aggregate<Digits>(10, 20), L"After removes");
+        }
+
+        TEST_METHOD(Aggregate_Benchmark)
+        {
+            std::vector<int> items(100000);
+            std::iota(items.begin(), items.end(), 0);
+            LinkedSet<int> list { items };
+            LinkedSet<int, BPlusTree<int, MaxAggregate<int>>> tree { items };
+            std::mt19937 random { 47 };
+
+            auto start { std::chrono::steady_clock::now() };
+            long long listSum { 0 };
+            for (int query { 0 }; query < 200; query++)
+            {
+                int low { static_cast<int>(random() % 50000) };
+                listSum += list.aggregate<MaxAggregate<int>>(low, low + 50000);
+            }
+            std::chrono::duration<double, std::milli> listTime { std::chrono::steady_clock::now() - start };
+
+            random.seed(47);
+            start = std::chrono::steady_clock::now();
+            long long treeSum { 0 };
+            for (int query { 0 }; query < 200; query++)
+            {
+                int low { static_cast<int>(random() % 50000) };
+                treeSum += tree.aggregate<MaxAggregate<int>>(low, low + 50000);
+            }
+            std::chrono::duration<double, std::milli> treeTime { std::chrono::steady_clock::now() - start };
+
+            Assert::IsTrue(listSum == treeSum, L"Same answers");
+            std::wstring message { L"List range max: " + std::to_wstring(listTime.count()) + L" ms, tree: " + std::to_wstring(treeTime.count()) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        template <typename List>
+        static void checkSplitJoin()
+        {
+            std::mt19937 random { 47 };
+            for (int round { 0 }; round < 12; round++)
+            {
+                // Sizes from empty to a few thousand, cut anywhere including past either end.
+                std::vector<int> items(round == 0 ? 0 : random() % 4000);
+                for (int& item : items)
+                {
+                    item = static_cast<int>(random() % 20000);
+                }
+                LinkedSet<int, List> lower { items };
+                std::vector<int> expected(lower.begin(), lower.end());
+                int key { static_cast<int>(random() % 20400) - 200 };
+
+                LinkedSet<int, List> upper { lower.splitAt(key) };
+                std::vector<int> below(lower.begin(), lower.end());
+                std::vector<int> above(upper.begin(), upper.end());
+                unsigned int cut { static_cast<unsigned int>(std::ranges::lower_bound(expected, key) - expected.begin()) };
+                Assert::IsTrue(std::vector<int>(expected.begin(), expected.begin() + cut) == below, L"Items below the key stay");
+                Assert::IsTrue(std::vector<int>(expected.begin() + cut, expected.end()) == above, L"Items from the key on move");
+                Assert::AreEqual(cut, lower.getSize(), L"Size of the lower part");
+                Assert::AreEqual(static_cast<unsigned int>(expected.size()) - cut, upper.getSize(), L"Size of the upper part");
+
+                // Both halves still work as sets.
+                if (lower.add(key - 1))
+                {
+                    lower.remove(key - 1);
+                }
+                if (upper.add(key + 1))
+                {
+                    upper.remove(key + 1);
+                }
+                Assert::IsFalse(lower.contains(key), L"Key left the lower part");
+
+                lower.join(std::move(upper));
+                Assert::AreEqual(0u, upper.getSize(), L"Joined set is emptied");
+                Assert::IsTrue(expected == std::vector<int>(lower.begin(), lower.end()), L"Joining puts the set back together");
+
+                // Overlapping sets are merged instead.
+                LinkedSet<int, List> other { std::vector<int> { -5, key, 7, 25000 } };
+                lower.join(std::move(other));
+                expected.insert(expected.end(), { -5, key, 7, 25000 });
+                std::ranges::sort(expected);
+                expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+                Assert::IsTrue(expected == std::vector<int>(lower.begin(), lower.end()), L"Overlapping join merges");
+                Assert::AreEqual(static_cast<unsigned int>(expected.size()), lower.getSize(), L"Size after merging");
+            }
+        }
+
+        TEST_METHOD(SplitJoin_EveryList)
+        {
+            checkSplitJoin<LinkedList<int>>();
+            checkSplitJoin<DoublyLinkedList<int>>();
+            checkSplitJoin<IndexedLinkedList<int>>();
+            checkSplitJoin<AdaptiveList<int>>();
+            checkSplitJoin<BPlusTree<int>>();
+            checkSplitJoin<BPlusTree<int, SumAggregate<int>>>();
+        }
+
+        TEST_METHOD(SplitJoin_TreeKeepsCounts)
+        {
+            // Strings keep the nodes small, so cuts and joins go through several levels.
+            std::vector<std::string> items {};
+            for (int n { 0 }; n < 6000; n++)
+            {
+                items.push_back(std::to_string(100000 + n * 3));
+            }
+            LinkedSet<std::string, BPlusTree<std::string, CountAggregate<std::string>>> set { items };
+            std::mt19937 random { 48 };
+            for (int round { 0 }; round < 40; round++)
+            {
+                std::string key { std::to_string(100000 + random() % 18000) };
+                auto upper { set.splitAt(key) };
+                unsigned int cut { static_cast<unsigned int>(std::ranges::lower_bound(items, key) - items.begin()) };
+                Assert::AreEqual(cut, set.getSize(), L"Lower size");
+                Assert::AreEqual(6000u - cut, upper.rank("999999"), L"rank() over the upper part");
+                Assert::AreEqual(cut, set.aggregate<CountAggregate<std::string>>("0", "999999"), L"Aggregate over the lower part");
+                if (cut > 0)
+                {
+                    Assert::AreEqual(items[cut - 1], set.select(cut - 1), L"Last of the lower part");
+                }
+                if (cut < 6000)
+                {
+                    Assert::AreEqual(items[cut], upper.select(0), L"First of the upper part");
+                    Assert::AreEqual(items[5999], upper.select(6000 - cut - 1), L"Last of the upper part");
+                }
+
+                // Join the other way round half the time: the upper part absorbs the lower.
+                if (round % 2 == 0)
+                {
+                    set.join(std::move(upper));
+                }
+                else
+                {
+                    upper.join(std::move(set));
+                    set = std::move(upper);
+                }
+                Assert::AreEqual(6000u, set.getSize(), L"Size after joining");
+                for (unsigned int k { 0 }; k < 6000; k += 499)
+                {
+                    Assert::AreEqual(items[k], set[k], L"select() after joining");
+                    Assert::AreEqual(k, set.rank(items[k]), L"rank() after joining");
+                }
+                Assert::AreEqual(300u, set.aggregate<CountAggregate<std::string>>(items[1000], items[1300]), L"Aggregate after joining");
+            }
+
+            // Trees of very different heights join in both directions.
+            BPlusTree<int> tall {};
+            BPlusTree<int> small {};
+            for (int n { 0 }; n < 50000; n++)
+            {
+                tall.addLast(n);
+            }
+            small.addLast(50000);
+            tall.join(std::move(small));
+            small.addLast(-1);
+            small.join(std::move(tall));
+            Assert::AreEqual(50002u, small.getSize(), L"Size after joining both ways");
+            Assert::AreEqual(25000, small.select(25001), L"select() after joining both ways");
+            Assert::AreEqual(50000, small.getLast(), L"Last item");
+        }
+
+        TEST_METHOD(SplitJoin_KeepsIndexUpToDate)
+        {
+            HashIndex<int> index {};
+            std::vector<int> items(3000);
+            std::iota(items.begin(), items.end(), 0);
+            LinkedSet<int> set { items };
+            set.setIndex(&index);
+
+            LinkedSet<int> upper { set.splitAt(1000) };
+            Assert::AreEqual(1000u, index.getItemCount(), L"Moved items leave the index");
+            Assert::IsTrue(set.contains(999), L"Item below the cut");
+            Assert::IsFalse(set.contains(1000), L"Item above the cut");
+            Assert::IsTrue(upper.contains(2999), L"Item in the upper part");
+            set.remove(999);
+            set.add(999);
+
+            set.join(std::move(upper));
+            Assert::AreEqual(3000u, index.getItemCount(), L"Joined items join the index");
+            Assert::IsTrue(set.remove(2500), L"Removing a joined item through the index");
+            Assert::IsFalse(set.contains(2500), L"Removed item");
+            Assert::AreEqual(2999u, set.getSize(), L"Size after removing");
+
+            // A few items are kept inline, so splitting moves their values out; the
+            // index must be told while it can still hash them.
+            HashIndex<std::string> wordIndex {};
+            LinkedSet<std::string> words { std::vector<std::string> { "apple", "banana", "cherry" } };
+            words.setIndex(&wordIndex);
+            LinkedSet<std::string> later { words.splitAt("banana") };
+            Assert::AreEqual(1u, wordIndex.getItemCount(), L"Moved words leave the index");
+            Assert::IsFalse(words.contains("banana") || words.remove("cherry"), L"Word above the cut");
+            Assert::IsTrue(words.add("banana") && words.remove("banana") && words.remove("apple"), L"Removing words through the index");
+            Assert::AreEqual(0u, wordIndex.getItemCount(), L"Index after removing");
+            Assert::IsTrue(std::ranges::equal(later, std::vector<std::string> { "banana", "cherry" }), L"Words in the upper part");
+        }
+
+        TEST_METHOD(SplitJoin_Benchmark)
+        {
+            std::vector<int> items(200000);
+            std::iota(items.begin(), items.end(), 0);
+            LinkedSet<int> list { items };
+            LinkedSet<int, BPlusTree<int>> tree { items };
+
+            // What joining took before: copying the upper part on item by item.
+            auto start { std::chrono::steady_clock::now() };
+            LinkedSet<int> copied { list };
+            LinkedSet<int> copy {};
+            for (int item : copied)
+            {
+                if (item >= 100000)
+                {
+                    copy.add(item);
+                }
+            }
+            std::chrono::duration<double, std::milli> copyTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            for (int round { 0 }; round < 100; round++)
+            {
+                LinkedSet<int> upper { list.splitAt(100000) };
+                list.join(std::move(upper));
+            }
+            std::chrono::duration<double, std::milli> listTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            for (int round { 0 }; round < 100; round++)
+            {
+                LinkedSet<int, BPlusTree<int>> upper { tree.splitAt(100000 + round) };
+                tree.join(std::move(upper));
+            }
+            std::chrono::duration<double, std::milli> treeTime { std::chrono::steady_clock::now() - start };
+
+            Assert::AreEqual(200000u, list.getSize(), L"List size");
+            Assert::AreEqual(200000u, tree.getSize(), L"Tree size");
+            std::wstring message { L"Copying half: " + std::to_wstring(copyTime.count()) + L" ms, list split and join: " + std::to_wstring(listTime.count() / 100)
+                + L" ms, tree split and join: " + std::to_wstring(treeTime.count() / 100) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        template <typename List>
+        static void checkSampleIsUniform()
+        {
+            std::vector<int> items(20);
+            std::iota(items.begin(), items.end(), 100);
+            const LinkedSet<int, List> set { items };
+            std::mt19937 random { 48 };
+            std::vector<unsigned int> picks(20);
+            for (int trial { 0 }; trial < 40000; trial++)
+            {
+                std::vector<int> sample { set.sample(5, random) };
+                Assert::AreEqual(std::size_t { 5 }, sample.size(), L"Sample size");
+                Assert::IsTrue(std::ranges::is_sorted(sample), L"Sample is in order");
+                Assert::IsTrue(std::adjacent_find(sample.begin(), sample.end()) == sample.end(), L"Sample has no repeats");
+                for (int item : sample)
+                {
+                    picks[item - 100]++;
+                }
+            }
+
+            // Each item is picked a quarter of the time, give or take a few standard deviations.
+            for (unsigned int count : picks)
+            {
+                Assert::IsTrue(count > 9500 && count < 10500, L"Every item is equally likely");
+            }
+
+            Assert::IsTrue(items == set.sample(20, random), L"Asking for every item");
+            Assert::IsTrue(items == set.sample(50, random), L"Asking for more than every item");
+            Assert::IsTrue(set.sample(0, random).empty(), L"Asking for nothing");
+        }
+
+        TEST_METHOD(Sample_IsUniform)
+        {
+            checkSampleIsUniform<LinkedList<int>>();
+            checkSampleIsUniform<BPlusTree<int>>();
+            checkSampleIsUniform<AdaptiveList<int>>();
+        }
+
+        TEST_METHOD(Sample_ReservoirOverStream)
+        {
+            // The reservoir doesn't need to know how long the input is.
+            std::istringstream stream { "5 3 9 1 7 2 8" };
+            std::mt19937 random { 49 };
+            std::vector<int> sample { reservoirSample(std::istream_iterator<int> { stream }, std::istream_iterator<int> {}, 3, random) };
+            Assert::AreEqual(std::size_t { 3 }, sample.size(), L"Sample size");
+            std::ranges::sort(sample);
+            Assert::IsTrue(std::adjacent_find(sample.begin(), sample.end()) == sample.end(), L"Sample has no repeats");
+
+            // Later items are as likely to be kept as early ones, even when most are skipped.
+            std::vector<int> items(1000);
+            std::iota(items.begin(), items.end(), 0);
+            unsigned int firstHalf { 0 };
+            for (int trial { 0 }; trial < 2000; trial++)
+            {
+                for (int item : reservoirSample(items.begin(), items.end(), 10, random))
+                {
+                    firstHalf += item < 500 ? 1 : 0;
+                }
+            }
+            Assert::IsTrue(firstHalf > 9500 && firstHalf < 10500, L"Both halves are equally likely");
+            Assert::AreEqual(std::size_t { 4 }, reservoirSample(items.begin(), items.begin() + 4, 10, random).size(), L"Fewer items than asked for");
+        }
+
+        TEST_METHOD(Sample_Benchmark)
+        {
+            std::vector<int> items(1000000);
+            std::iota(items.begin(), items.end(), 0);
+            const LinkedSet<int> list { items };
+            const LinkedSet<int, BPlusTree<int>> tree { items };
+            std::mt19937 random { 50 };
+
+            auto start { std::chrono::steady_clock::now() };
+            long long listSum { 0 };
+            for (int round { 0 }; round < 10; round++)
+            {
+                for (int item : list.sample(100, random))
+                {
+                    listSum += item;
+                }
+            }
+            std::chrono::duration<double, std::milli> listTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            long long treeSum { 0 };
+            for (int round { 0 }; round < 10; round++)
+            {
+                for (int item : tree.sample(100, random))
+                {
+                    treeSum += item;
+                }
+            }
+            std::chrono::duration<double, std::milli> treeTime { std::chrono::steady_clock::now() - start };
+
+            Assert::IsTrue(listSum > 0 && treeSum > 0, L"Samples were drawn");
+            std::wstring message { L"Sampling 100 of 1000000, list: " + std::to_wstring(listTime.count() / 10) + L" ms, tree: " + std::to_wstring(treeTime.count() / 10) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(Expiring_ExpiresDueItems)
+        {
+            ExpiringSet<int, int> set {};
+            Assert::IsTrue(set.add(30, 10), L"Add an item");
+            Assert::IsTrue(set.add(10, 20), L"Add a later item");
+            Assert::IsTrue(set.add(20, 5), L"Add an earlier item");
+            Assert::IsFalse(set.add(10, 8), L"Give an item a new expiry");
+            Assert::IsTrue(set.contains(20, 4), L"Not expired yet");
+            Assert::IsFalse(set.contains(20, 5), L"Expired, but still in the set");
+            Assert::AreEqual(3u, set.getSize(), L"Expired items stay until expire()");
+
+            Assert::AreEqual(0u, set.expire(4), L"Nothing due");
+            Assert::AreEqual(2u, set.expire(8), L"Two items due");
+            Assert::AreEqual(1u, set.getSize(), L"Size after expiring");
+            Assert::IsTrue(set.contains(30, 9), L"Item still live");
+            Assert::IsFalse(set.contains(10, 0), L"Expired item is gone");
+
+            Assert::IsTrue(set.remove(30), L"Remove an item");
+            Assert::IsFalse(set.remove(30), L"Remove it again");
+            Assert::AreEqual(0u, set.expire(100), L"Removed item doesn't expire");
+            Assert::AreEqual(0u, set.getSize(), L"Empty");
+        }
+
+        template <typename List>
+        static void checkExpiringMatchesModel()
+        {
+            ExpiringSet<int, int, List> set {};
+            std::map<int, int> model {};
+            std::mt19937 random { 51 };
+            for (int now { 0 }; now < 3000; now++)
+            {
+                for (int step { 0 }; step < 4; step++)
+                {
+                    int item { static_cast<int>(random() % 500) };
+                    if (random() % 6 == 0)
+                    {
+                        Assert::AreEqual(model.erase(item) == 1, set.remove(item), L"remove()");
+                    }
+                    else
+                    {
+                        // Mostly a fixed time to live, sometimes not.
+                        int expiry { now + (random() % 4 == 0 ? static_cast<int>(random() % 100) : 50) };
+                        Assert::AreEqual(model.find(item) == model.end(), set.add(item, expiry), L"add()");
+                        model[item] = expiry;
+                    }
+                }
+
+                int item { static_cast<int>(random() % 500) };
+                auto entry { model.find(item) };
+                Assert::AreEqual(entry != model.end() && entry->second > now, set.contains(item, now), L"contains()");
+
+                if (now % 7 == 0)
+                {
+                    unsigned int due { static_cast<unsigned int>(std::erase_if(model, [&](const auto& pair) { return pair.second <= now; })) };
+                    Assert::AreEqual(due, set.expire(now), L"expire()");
+                    std::vector<int> expected {};
+                    for (const auto& pair : model)
+                    {
+                        expected.push_back(pair.first);
+                    }
+                    Assert::IsTrue(expected == std::vector<int>(set.begin(), set.end()), L"Items in order");
+                }
+            }
+        }
+
+        TEST_METHOD(Expiring_MatchesModel)
+        {
+            checkExpiringMatchesModel<LinkedList<int>>();
+            checkExpiringMatchesModel<BPlusTree<int>>();
+        }
+
+        TEST_METHOD(Expiring_Benchmark)
+        {
+            // A dedup window: every tick brings new IDs that live for 1000 ticks.
+            ExpiringSet<int, int> set {};
+            std::unordered_map<int, int> expiries {};
+            LinkedSet<int> scanned {};
+            std::chrono::duration<double, std::milli> expireTime {};
+            std::chrono::duration<double, std::milli> scanTime {};
+            for (int now { 0 }; now < 2000; now++)
+            {
+                for (int n { 0 }; n < 50; n++)
+                {
+                    int id { now * 50 + n };
+                    set.add(id, now + 1000);
+                    expiries[id] = now + 1000;
+                    scanned.add(id);
+                }
+
+                auto start { std::chrono::steady_clock::now() };
+                set.expire(now);
+                expireTime += std::chrono::steady_clock::now() - start;
+
+                // What purging took before: check every item's expiry.
+                start = std::chrono::steady_clock::now();
+                std::vector<int> due {};
+                for (int id : scanned)
+                {
+                    if (expiries[id] <= now)
+                    {
+                        due.push_back(id);
+                    }
+                }
+                for (int id : due)
+                {
+                    scanned.remove(id);
+                    expiries.erase(id);
+                }
+                scanTime += std::chrono::steady_clock::now() - start;
+            }
+
+            Assert::AreEqual(scanned.getSize(), set.getSize(), L"Same items left");
+            std::wstring message { L"Scanning for expired items: " + std::to_wstring(scanTime.count()) + L" ms, expire(): " + std::to_wstring(expireTime.count()) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
+
+        TEST_METHOD(LinkedSet_RemoveEnds)
+        {
+            LinkedSet<int> list { std::vector<int> { 5, 1, 9, 3 } };
+            LinkedSet<int, DoublyLinkedList<int>> doubly { std::vector<int> { 5, 1, 9, 3 } };
+            LinkedSet<int, BPlusTree<int>> tree { std::vector<int> { 5, 1, 9, 3 } };
+            Assert::AreEqual(1, list.getFirst(), L"First item");
+            Assert::AreEqual(9, tree.getLast(), L"Last item");
+
+            list.removeLast();
+            doubly.removeLast();
+            tree.removeLast();
+            list.removeFirst();
+            doubly.removeFirst();
+            tree.removeFirst();
+            for (const auto& items : { std::vector<int>(list.begin(), list.end()), std::vector<int>(doubly.begin(), doubly.end()), std::vector<int>(tree.begin(), tree.end()) })
+            {
+                Assert::IsTrue(std::vector<int> { 3, 5 } == items, L"Both ends removed");
+            }
+
+            list.removeLast();
+            list.removeLast();
+            Assert::AreEqual(0u, list.getSize(), L"Emptied from the end");
+            Assert::ExpectException<std::out_of_range>([&] { list.removeLast(); }, L"removeLast() on an empty set");
+            Assert::ExpectException<std::out_of_range>([&] { list.getFirst(); }, L"getFirst() on an empty set");
+        }
+
+        template <typename List>
+        static void checkBoundedMatchesSort(BoundedKeep keep)
+        {
+            BoundedSet<int, List> set { 50, keep };
+            std::vector<int> seen {};
+            std::mt19937 random { 52 };
+            for (int step { 0 }; step < 5000; step++)
+            {
+                int item { static_cast<int>(random() % 100000) };
+                bool fresh { std::ranges::find(seen, item) == seen.end() };
+                seen.push_back(item);
+                std::ranges::sort(seen);
+                seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+                std::vector<int> expected { keep == BoundedKeep::Largest ? std::vector<int>(seen.end() - std::min<std::size_t>(50, seen.size()), seen.end())
+                    : std::vector<int>(seen.begin(), seen.begin() + std::min<std::size_t>(50, seen.size())) };
+
+                bool kept { std::ranges::binary_search(expected, item) };
+                Assert::AreEqual(fresh && kept, set.add(item), L"add() tells whether the item got in");
+                Assert::IsTrue(expected == std::vector<int>(set.begin(), set.end()), L"Best items kept");
+            }
+
+            Assert::IsTrue(set.isFull(), L"Full");
+            Assert::AreEqual(keep == BoundedKeep::Largest ? *set.begin() : *std::ranges::max_element(set), set.getBoundary(), L"Boundary");
+        }
+
+        TEST_METHOD(Bounded_KeepsBestItems)
+        {
+            checkBoundedMatchesSort<LinkedList<int>>(BoundedKeep::Largest);
+            checkBoundedMatchesSort<LinkedList<int>>(BoundedKeep::Smallest);
+            checkBoundedMatchesSort<DoublyLinkedList<int>>(BoundedKeep::Smallest);
+            checkBoundedMatchesSort<BPlusTree<int>>(BoundedKeep::Smallest);
+
+            BoundedSet<int> set { 3, BoundedKeep::Largest };
+            Assert::IsTrue(set.add(5), L"Room for an item");
+            Assert::IsFalse(set.add(5), L"Item already there");
+            set.add(7);
+            set.add(9);
+            Assert::IsFalse(set.add(4), L"Rejected below the boundary");
+            Assert::IsTrue(set.add(6), L"Beats the boundary");
+            Assert::IsFalse(set.contains(5), L"Boundary evicted");
+            Assert::AreEqual(6, set.getBoundary(), L"New boundary");
+            Assert::IsTrue(set.remove(9), L"Remove an item");
+            Assert::IsTrue(set.add(1), L"Room again after removing");
+            Assert::IsFalse(BoundedSet<int> { 0 }.add(1), L"No room at all");
+        }
+
+        TEST_METHOD(Bounded_Benchmark)
+        {
+            std::vector<int> stream(200000);
+            std::mt19937 random { 53 };
+            for (int& item : stream)
+            {
+                item = static_cast<int>(random() % 10000000);
+            }
+
+            // What the callers did before: add, then walk to the end to drop the extra item.
+            auto start { std::chrono::steady_clock::now() };
+            LinkedSet<int> plain {};
+            for (int item : stream)
+            {
+                plain.add(item);
+                if (plain.getSize() > 1000)
+                {
+                    int largest { *std::next(plain.begin(), plain.getSize() - 1) };
+                    plain.remove(largest);
+                }
+            }
+            std::chrono::duration<double, std::milli> plainTime { std::chrono::steady_clock::now() - start };
+
+            start = std::chrono::steady_clock::now();
+            BoundedSet<int, DoublyLinkedList<int>> bounded { 1000, BoundedKeep::Smallest };
+            for (int item : stream)
+            {
+                bounded.add(item);
+            }
+            std::chrono::duration<double, std::milli> boundedTime { std::chrono::steady_clock::now() - start };
+
+            Assert::IsTrue(std::vector<int>(plain.begin(), plain.end()) == std::vector<int>(bounded.begin(), bounded.end()), L"Same items kept");
+            std::wstring message { L"Add then trim: " + std::to_wstring(plainTime.count()) + L" ms, BoundedSet: " + std::to_wstring(boundedTime.count()) + L" ms\n" };
+            Logger::WriteMessage(message.c_str());
+        }
     };
 }